@@ -0,0 +1,1036 @@
+#include "Vector.hpp"
+#include "FastNormalize.hpp"
+#include "QuantizedVector.hpp"
+#include "Float16.hpp"
+#include "IvfIndex.hpp"
+#include "KMeans.hpp"
+#include "Matrix.hpp"
+#include "DynVector.hpp"
+#include "VectorView.hpp"
+#include "KnnBruteForce.hpp"
+#include "KdTree.hpp"
+#include "SpaceFillingCurve.hpp"
+#if defined(VECTORND_DISPATCH_BENCHMARKS)
+#include "Dispatch.hpp"
+#endif
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cmath>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace VectorND;
+
+// Every operation of Vector<T, N> next to the same operation written as a plain loop over
+// std::array<T, N> (the baseline), for T in {int, float, double} and N in {2, 3, 4, 16, 128, 1024}.
+//
+// Names: <operation>/<T>/<N>/<vectorND|baseline>. Counters: time per operation (op) and
+// bytes_per_second (the vectors read and written). JSON output to diff between releases:
+//   ./vectorNDBench --benchmark_format=json --benchmark_out=bench.json
+//
+// dotSummation/float/<N>/<mode>: the summation modes of dot<Acc, Mode>, with their relativeError.
+// normalize/float/<N>/<path>: normalize(), fastNormalize() and the batched fastNormalize.
+// quantized/<int8|uint8>/<N>/<dot|squaredDist>: QuantizedVector products, next to dot/float/<N>.
+// quantized/int8/<N>/kernel/<symmetric|widened>: the 2 kernels of the int8 products with zero points
+//   of 0; dot takes symmetric from SSSE3 on, widened in the default (SSE2) build.
+// half/<float16|bfloat16>/<N>/<dot|squaredDist>: 16 bits storage computed in float.
+// ivf/<N>/<nprobe|exact>: IvfIndex latency per query and its recall@10, against KnnBruteForce.
+// kmeans/<N>/<lloyd|hamerly>: KMeans::fit of the IVF dataset in 64 clusters.
+// transform/<T>/<RxC|3x4affine>/<vectorND|baseline>: batched Matrix transform of a point cloud.
+// dyn/float/<N>/<dot|squaredDist|add>/<dynamic|fixed>: DynVector against Vector<float, N>.
+// view/float/<N>/<dot|column>/<view|copy>: rows and columns of a flat buffer, viewed or copied.
+// curve/3/<morton|hilbert>/sort: sortByCurve of a point cloud (with the permutation).
+// curve/3/nearest/<shuffled|morton|hilbert>: KdTree::nearest of every point, queried in random or curve order.
+// dispatch/float/<N>/<dot|squaredDist>/<sse2|avx2|avx512>: the vectorNDDispatch batch kernels at
+//   each level the cpu supports (only when the library is built).
+
+namespace {
+
+//* ------------------ operations ------------------ *//
+
+// each operation has a Vector version (run) and a std::array version (baseline).
+// reduction: the result is a scalar. inputs: number of vectors read.
+// The compound assignments start from a copy of a, so the values do not drift between iterations.
+
+template <typename T, size_t N>
+using Array = std::array<T, N>;
+
+struct Add {
+    static constexpr const char* name = "add";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a + b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] + b[i];
+    }
+};
+
+struct Sub {
+    static constexpr const char* name = "sub";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a - b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] - b[i];
+    }
+};
+
+struct Mul {
+    static constexpr const char* name = "mul";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a * b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] * b[i];
+    }
+};
+
+struct Div {
+    static constexpr const char* name = "div";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a / b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] / b[i];
+    }
+};
+
+struct Scale {
+    static constexpr const char* name = "mulScalar";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 1;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a * b[0]; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] * b[0];
+    }
+};
+
+struct DivScalar {
+    static constexpr const char* name = "divScalar";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 1;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a / b[0]; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[i] / b[0];
+    }
+};
+
+struct Negate {
+    static constexpr const char* name = "negate";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 1;
+    template <typename V>
+    static void run(const V& a, const V&, V& out) { out = -a; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>&, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = -a[i];
+    }
+};
+
+struct AddAssign {
+    static constexpr const char* name = "addAssign";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a; out += b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        out = a;
+        for (size_t i = 0; i < N; i++) out[i] += b[i];
+    }
+};
+
+struct SubAssign {
+    static constexpr const char* name = "subAssign";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a; out -= b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        out = a;
+        for (size_t i = 0; i < N; i++) out[i] -= b[i];
+    }
+};
+
+struct MulAssign {
+    static constexpr const char* name = "mulAssign";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a; out *= b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        out = a;
+        for (size_t i = 0; i < N; i++) out[i] *= b[i];
+    }
+};
+
+struct DivAssign {
+    static constexpr const char* name = "divAssign";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a; out /= b; }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        out = a;
+        for (size_t i = 0; i < N; i++) out[i] /= b[i];
+    }
+};
+
+struct Mod {
+    static constexpr const char* name = "mod";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static void run(const V& a, const V& b, V& out) { out = a.mod(b); }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>& b, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) {
+            if constexpr (std::is_integral_v<T>) {
+                out[i] = (a[i] % b[i] + b[i]) % b[i];
+            } else {
+                out[i] = std::fmod(std::fmod(a[i], b[i]) + b[i], b[i]);
+            }
+        }
+    }
+};
+
+struct Reverse {
+    static constexpr const char* name = "reverse";
+    static constexpr bool reduction = false;
+    static constexpr int inputs = 1;
+    template <typename V>
+    static void run(const V& a, const V&, V& out) { out = a.reverse(); }
+    template <typename T, size_t N>
+    static void baseline(const Array<T, N>& a, const Array<T, N>&, Array<T, N>& out) {
+        for (size_t i = 0; i < N; i++) out[i] = a[N - i - 1];
+    }
+};
+
+struct Dot {
+    static constexpr const char* name = "dot";
+    static constexpr bool reduction = true;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static double run(const V& a, const V& b) { return a.dot(b); }
+    template <typename T, size_t N>
+    static double baseline(const Array<T, N>& a, const Array<T, N>& b) {
+        T sum{0};
+        for (size_t i = 0; i < N; i++) sum += a[i] * b[i];
+        return sum;
+    }
+};
+
+struct Norm {
+    static constexpr const char* name = "norm";
+    static constexpr bool reduction = true;
+    static constexpr int inputs = 1;
+    template <typename V>
+    static double run(const V& a, const V&) { return a.norm(); }
+    template <typename T, size_t N>
+    static double baseline(const Array<T, N>& a, const Array<T, N>&) {
+        T sum{0};
+        for (size_t i = 0; i < N; i++) sum += a[i] * a[i];
+        return std::sqrt(sum);
+    }
+};
+
+struct SquaredDist {
+    static constexpr const char* name = "squaredDist";
+    static constexpr bool reduction = true;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static double run(const V& a, const V& b) { return a.squaredDist(b); }
+    template <typename T, size_t N>
+    static double baseline(const Array<T, N>& a, const Array<T, N>& b) {
+        T sum{0};
+        for (size_t i = 0; i < N; i++) sum += (a[i] - b[i]) * (a[i] - b[i]);
+        return sum;
+    }
+};
+
+struct Dist {
+    static constexpr const char* name = "dist";
+    static constexpr bool reduction = true;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static double run(const V& a, const V& b) { return a.dist(b); }
+    template <typename T, size_t N>
+    static double baseline(const Array<T, N>& a, const Array<T, N>& b) {
+        return std::sqrt(SquaredDist::baseline(a, b));
+    }
+};
+
+struct Equal {
+    static constexpr const char* name = "equal";
+    static constexpr bool reduction = true;
+    static constexpr int inputs = 2;
+    template <typename V>
+    static double run(const V& a, const V& b) { return a == b; }
+    template <typename T, size_t N>
+    static double baseline(const Array<T, N>& a, const Array<T, N>& b) {
+        for (size_t i = 0; i < N; i++) {
+            if (a[i] != b[i]) return false;
+        }
+        return true;
+    }
+};
+
+//* ------------------ benchmark ------------------ *//
+
+// number of elements of each input array: the operands stay in L1 / L2, not in registers
+constexpr size_t elementsPerArray = 4096;
+
+template <typename T>
+const char* typeName() {
+    if constexpr (std::is_same_v<T, int>) {
+        return "int";
+    } else if constexpr (std::is_same_v<T, float>) {
+        return "float";
+    } else {
+        return "double";
+    }
+}
+
+// a: values in [-100, 100), b: in [1, 10) (a valid divisor and modulus), equal to a when
+// the operation is an equality (the worst case, every element is compared)
+template <typename Op, typename T, size_t N>
+void fill(std::vector<Array<T, N>>& a, std::vector<Array<T, N>>& b) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> dist(0, 1);
+    for (size_t v = 0; v < a.size(); v++) {
+        for (size_t i = 0; i < N; i++) {
+            a[v][i] = static_cast<T>(-100 + 200 * dist(rng));
+            b[v][i] = static_cast<T>(1 + 9 * dist(rng));
+        }
+        if constexpr (std::is_same_v<Op, Equal>) {
+            b[v] = a[v];
+        }
+    }
+}
+
+template <typename Op, typename T, size_t N, bool Baseline>
+void benchOperation(benchmark::State& state) {
+    using Item = std::conditional_t<Baseline, Array<T, N>, Vector<T, N>>;
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<T, N>> arrays(count), arraysB(count);
+    fill<Op, T, N>(arrays, arraysB);
+    std::vector<Item> a(arrays.begin(), arrays.end()), b(arraysB.begin(), arraysB.end()), out(count);
+
+    for (auto _ : state) {
+        if constexpr (Op::reduction) {
+            double sink = 0;
+            for (size_t v = 0; v < count; v++) {
+                if constexpr (Baseline) {
+                    sink += Op::baseline(a[v], b[v]);
+                } else {
+                    sink += Op::run(a[v], b[v]);
+                }
+            }
+            benchmark::DoNotOptimize(sink);
+        } else {
+            for (size_t v = 0; v < count; v++) {
+                if constexpr (Baseline) {
+                    Op::baseline(a[v], b[v], out[v]);
+                } else {
+                    Op::run(a[v], b[v], out[v]);
+                }
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    const int64_t vectors = Op::inputs + (Op::reduction ? 0 : 1);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * vectors * static_cast<int64_t>(N * sizeof(T)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+//* ------------------ summation modes ------------------ *//
+
+// dot of float vectors in each summation mode (and with a double accumulator): throughput,
+// and relativeError against a long double sum
+
+template <typename Acc, typename Mode>
+const char* summationName() {
+    if constexpr (!std::is_same_v<Acc, float>) {
+        return "doubleAccumulator";
+    } else if constexpr (std::is_same_v<Mode, summation::Pairwise>) {
+        return "pairwise";
+    } else if constexpr (std::is_same_v<Mode, summation::Kahan>) {
+        return "kahan";
+    } else {
+        return "naive";
+    }
+}
+
+template <size_t N, typename Acc, typename Mode>
+void benchSummation(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    std::vector<Vector<float, N>> a(arrays.begin(), arrays.end()), b(arraysB.begin(), arraysB.end());
+
+    for (auto _ : state) {
+        double sink = 0;
+        for (size_t v = 0; v < count; v++) {
+            sink += static_cast<double>(a[v].template dot<Acc, Mode>(b[v]));
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    double error = 0;
+    for (size_t v = 0; v < count; v++) {
+        long double exact = 0;
+        for (size_t i = 0; i < N; i++) {
+            exact += static_cast<long double>(a[v][i]) * b[v][i];
+        }
+        const long double found = a[v].template dot<Acc, Mode>(b[v]);
+        error = std::max(error, static_cast<double>(std::fabs((found - exact) / exact)));
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(float)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["relativeError"] = error;
+}
+
+template <size_t N, typename Acc, typename Mode>
+void registerSummation() {
+    const std::string name = std::string("dotSummation/float/") + std::to_string(N) + "/" + summationName<Acc, Mode>();
+    benchmark::RegisterBenchmark(name.c_str(), benchSummation<N, Acc, Mode>);
+}
+
+template <size_t N>
+void registerSummationModes() {
+    registerSummation<N, float, summation::Naive>();
+    registerSummation<N, float, summation::Pairwise>();
+    registerSummation<N, float, summation::Kahan>();
+    registerSummation<N, double, summation::Naive>();
+}
+
+//* ------------------ registration ------------------ *//
+
+template <typename Op, typename T, size_t N>
+void registerPair() {
+    const std::string name = std::string(Op::name) + "/" + typeName<T>() + "/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/vectorND").c_str(), benchOperation<Op, T, N, false>);
+    benchmark::RegisterBenchmark((name + "/baseline").c_str(), benchOperation<Op, T, N, true>);
+}
+
+template <typename Op, typename T>
+void registerSizes() {
+    registerPair<Op, T, 2>();
+    registerPair<Op, T, 3>();
+    registerPair<Op, T, 4>();
+    registerPair<Op, T, 16>();
+    registerPair<Op, T, 128>();
+    registerPair<Op, T, 1024>();
+}
+
+template <typename... Ops>
+void registerAll() {
+    (registerSizes<Ops, int>(), ...);
+    (registerSizes<Ops, float>(), ...);
+    (registerSizes<Ops, double>(), ...);
+}
+
+//* ------------------ normalization ------------------ *//
+
+// exact: Vector::normalize, fast: Vector::fastNormalize, batch: fastNormalize over the array.
+// The vectors are normalized again at each iteration, their values stay the same.
+
+enum class NormalizePath { exact, fast, batch };
+
+template <size_t N, NormalizePath Path>
+void benchNormalize(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    std::vector<Vector<float, N>> a(arrays.begin(), arrays.end());
+
+    for (auto _ : state) {
+        if constexpr (Path == NormalizePath::batch) {
+            fastNormalize(a.data(), count);
+        } else {
+            for (size_t v = 0; v < count; v++) {
+                if constexpr (Path == NormalizePath::fast) {
+                    a[v].fastNormalize();
+                } else {
+                    a[v].normalize();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(a.data());
+        benchmark::ClobberMemory();
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(float)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <size_t N>
+void registerNormalize() {
+    const std::string name = std::string("normalize/float/") + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/exact").c_str(), benchNormalize<N, NormalizePath::exact>);
+    benchmark::RegisterBenchmark((name + "/fast").c_str(), benchNormalize<N, NormalizePath::fast>);
+    benchmark::RegisterBenchmark((name + "/batch").c_str(), benchNormalize<N, NormalizePath::batch>);
+}
+
+//* ------------------ quantized vectors ------------------ *//
+
+// dot and squaredDist of QuantizedVector<N, Code>: bytes_per_second counts the codes read
+// (4x fewer bytes than the float vectors for the same operation)
+
+template <typename Code>
+const char* codeName() {
+    return std::is_signed_v<Code> ? "int8" : "uint8";
+}
+
+template <size_t N, typename Code, bool Distance>
+void benchQuantized(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    const std::vector<Vector<float, N>> a(arrays.begin(), arrays.end()), b(arraysB.begin(), arraysB.end());
+    const auto qa = quantize<QuantizedVector<N, Code>>(a);
+    const auto qb = quantize<QuantizedVector<N, Code>>(b);
+
+    for (auto _ : state) {
+        double sink = 0;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (Distance) {
+                sink += qa[v].squaredDist(qb[v]);
+            } else {
+                sink += qa[v].dot(qb[v]);
+            }
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(Code)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+// the products of int8 codes by each kernel, whatever sumCodeProducts picks in this build
+template <size_t N, bool Symmetric>
+void benchCodeKernel(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<int8_t> a(count * N), b(count * N);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> code(-127, 127);
+    for (size_t i = 0; i < a.size(); i++) {
+        a[i] = static_cast<int8_t>(code(rng));
+        b[i] = static_cast<int8_t>(code(rng));
+    }
+
+    for (auto _ : state) {
+        int64_t sink = 0;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (Symmetric) {
+                sink += detail::symmetricCodeKernel<false>(a.data() + v * N, b.data() + v * N, N).ab;
+            } else {
+                sink += detail::widenedCodeKernel<detail::CodeSum::products>(a.data() + v * N, 0, b.data() + v * N, 0, N).ab;
+            }
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <size_t N, typename Code>
+void registerQuantized() {
+    const std::string name = std::string("quantized/") + codeName<Code>() + "/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/dot").c_str(), benchQuantized<N, Code, false>);
+    benchmark::RegisterBenchmark((name + "/squaredDist").c_str(), benchQuantized<N, Code, true>);
+    if constexpr (std::is_signed_v<Code>) {
+        benchmark::RegisterBenchmark((name + "/kernel/symmetric").c_str(), benchCodeKernel<N, true>);
+        benchmark::RegisterBenchmark((name + "/kernel/widened").c_str(), benchCodeKernel<N, false>);
+    }
+}
+
+
+//* ------------------ 16 bits floats ------------------ *//
+
+// dot<float> and squaredDist of Vector<H, N>: the elements are widened to float in the packets
+
+template <typename H>
+const char* halfName() {
+    return std::is_same_v<H, float16_t> ? "float16" : "bfloat16";
+}
+
+template <size_t N, typename H, bool Distance>
+void benchHalf(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    const std::vector<Vector<float, N>> a(arrays.begin(), arrays.end()), b(arraysB.begin(), arraysB.end());
+    const auto ha = convert<H>(a);
+    const auto hb = convert<H>(b);
+
+    for (auto _ : state) {
+        float sink = 0;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (Distance) {
+                sink += squaredDist(ha[v], hb[v]);
+            } else {
+                sink += ha[v].template dot<float>(hb[v]);
+            }
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(H)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <size_t N, typename H>
+void registerHalf() {
+    const std::string name = std::string("half/") + halfName<H>() + "/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/dot").c_str(), benchHalf<N, H, false>);
+    benchmark::RegisterBenchmark((name + "/squaredDist").c_str(), benchHalf<N, H, true>);
+}
+
+
+//* ------------------ approximate search ------------------ *//
+
+// a clustered dataset (ivfCount vectors around 256 centers), an index of ivfLists lists and
+// the exact neighbors of the queries, built once per N
+constexpr size_t ivfCount = 50000;
+constexpr size_t ivfLists = 256;
+constexpr size_t ivfQueries = 64;
+constexpr size_t ivfK = 10;
+
+template <size_t N>
+struct IvfDataset {
+    std::vector<Vector<float, N>> data;
+    std::vector<Vector<float, N>> queries;
+    IvfIndex<float, N> index{ivfLists};
+    KnnResult<float> exact;
+
+    IvfDataset() {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> center(-1, 1);
+        std::normal_distribution<float> noise(0, 1);
+        std::vector<Vector<float, N>> centers(256);
+        for (auto& c : centers) {
+            for (auto& x : c) {
+                x = center(rng);
+            }
+        }
+        data.resize(ivfCount + ivfQueries);
+        for (auto& v : data) {
+            v = centers[rng() % centers.size()];
+            for (auto& x : v) {
+                x += noise(rng);
+            }
+        }
+        queries.assign(data.end() - ivfQueries, data.end());
+        data.resize(ivfCount);
+        index.train(data);
+        index.add(data);
+        exact = KnnBruteForce<float, N>(data).query(queries, ivfK);
+    }
+
+    static const IvfDataset& get() {
+        static const IvfDataset dataset;
+        return dataset;
+    }
+};
+
+// nprobe 0: the exact search
+template <size_t N>
+void benchIvf(benchmark::State& state, size_t nprobe) {
+    const IvfDataset<N>& dataset = IvfDataset<N>::get();
+    KnnBruteForce<float, N> exactSearch(dataset.data);
+    KnnResult<float> result;
+    for (auto _ : state) {
+        result = nprobe == 0 ? exactSearch.query(dataset.queries, ivfK) : dataset.index.search(dataset.queries, ivfK, nprobe);
+        benchmark::DoNotOptimize(result.indices.data());
+    }
+    size_t found = 0;
+    for (size_t q = 0; q < ivfQueries; q++) {
+        for (size_t r = 0; r < ivfK; r++) {
+            for (size_t e = 0; e < ivfK; e++) {
+                found += result.index(q, r) == dataset.exact.index(q, e);
+            }
+        }
+    }
+    const int64_t queries = static_cast<int64_t>(state.iterations() * ivfQueries);
+    state.SetItemsProcessed(queries);
+    state.counters["query"] = benchmark::Counter(static_cast<double>(queries),
+                                                 benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["recall"] = static_cast<double>(found) / (ivfQueries * ivfK);
+}
+
+template <size_t N>
+void registerIvf() {
+    const std::string name = "ivf/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/exact").c_str(), benchIvf<N>, 0);
+    for (size_t nprobe : {1, 4, 16, 64}) {
+        benchmark::RegisterBenchmark((name + "/" + std::to_string(nprobe)).c_str(), benchIvf<N>, nprobe);
+    }
+}
+
+
+//* ------------------ clustering ------------------ *//
+
+// time of a fit (same seeding and result for both algorithms), with the distances computed
+template <size_t N>
+void benchKMeans(benchmark::State& state, KMeansAlgorithm algorithm) {
+    const IvfDataset<N>& dataset = IvfDataset<N>::get();
+    KMeans<float, N> kmeans(64, algorithm);
+    for (auto _ : state) {
+        kmeans = KMeans<float, N>(64, algorithm);
+        kmeans.fit(dataset.data, 50);
+        benchmark::DoNotOptimize(kmeans.centroids().data());
+    }
+    state.counters["iterations"] = static_cast<double>(kmeans.iterations());
+    state.counters["distances"] = static_cast<double>(kmeans.distanceCount());
+}
+
+template <size_t N>
+void registerKMeans() {
+    const std::string name = "kmeans/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/lloyd").c_str(), benchKMeans<N>, KMeansAlgorithm::Lloyd)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark((name + "/hamerly").c_str(), benchKMeans<N>, KMeansAlgorithm::Hamerly)->Unit(benchmark::kMillisecond);
+}
+
+//* ------------------ space filling curves ------------------ *//
+
+constexpr size_t curvePointCount = 1 << 20;
+
+// uniform point cloud in the unit cube, in random order
+const std::vector<Vector<float, 3>>& curvePoints() {
+    static const std::vector<Vector<float, 3>> points = [] {
+        std::vector<Array<float, 3>> arrays(curvePointCount), unused(curvePointCount);
+        fill<Dot, float, 3>(arrays, unused);
+        return std::vector<Vector<float, 3>>(arrays.begin(), arrays.end());
+    }();
+    return points;
+}
+
+void benchCurveSort(benchmark::State& state, Curve curve) {
+    std::vector<Vector<float, 3>> points;
+    std::vector<size_t> permutation(curvePointCount);
+    for (auto _ : state) {
+        state.PauseTiming();
+        points = curvePoints();
+        state.ResumeTiming();
+        sortByCurve(points.data(), points.size(), curve, permutation.data());
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(state.iterations() * curvePointCount);
+}
+
+// the nearest neighbor of every point, the queries in random order or sorted along the curve
+void benchCurveNearest(benchmark::State& state, bool sorted, Curve curve) {
+    static const KdTree<float, 3> tree(curvePoints());
+    std::vector<Vector<float, 3>> queries = curvePoints();
+    if (sorted) {
+        sortByCurve(queries, curve);
+    }
+    for (auto _ : state) {
+        float total = 0;
+        for (const auto& query : queries) {
+            total += tree.nearest(query).distance;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * curvePointCount);
+}
+
+void registerCurves() {
+    benchmark::RegisterBenchmark("curve/3/morton/sort", benchCurveSort, Curve::Morton)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("curve/3/hilbert/sort", benchCurveSort, Curve::Hilbert)->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("curve/3/nearest/shuffled", benchCurveNearest, false, Curve::Morton)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("curve/3/nearest/morton", benchCurveNearest, true, Curve::Morton)
+        ->Unit(benchmark::kMillisecond);
+    benchmark::RegisterBenchmark("curve/3/nearest/hilbert", benchCurveNearest, true, Curve::Hilbert)
+        ->Unit(benchmark::kMillisecond);
+}
+
+//* ------------------ matrices ------------------ *//
+
+// transform() (transformPoints() for the affine matrix, K = C - 1) of transformCount vectors,
+// next to the row by column loop over std::array
+constexpr size_t transformCount = 1 << 16;
+
+template <typename T, size_t R, size_t C, size_t K, bool Baseline>
+void benchTransform(benchmark::State& state) {
+    Matrix<T, R, C> m;
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            m(r, c) = static_cast<T>(r + 1) / static_cast<T>(c + 2);
+        }
+    }
+    std::vector<Array<T, K>> arrays(transformCount), unused(transformCount);
+    fill<Dot, T, K>(arrays, unused);
+    const std::vector<Vector<T, K>> in(arrays.begin(), arrays.end());
+    std::vector<Vector<T, R>> out(transformCount);
+    std::vector<Array<T, R>> baselineOut(transformCount);
+    std::array<std::array<T, C>, R> rows;
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            rows[r][c] = m(r, c);
+        }
+    }
+
+    for (auto _ : state) {
+        if constexpr (Baseline) {
+            for (size_t i = 0; i < transformCount; i++) {
+                for (size_t r = 0; r < R; r++) {
+                    T sum = K < C ? rows[r][C - 1] : T(0);
+                    for (size_t c = 0; c < K; c++) {
+                        sum += rows[r][c] * arrays[i][c];
+                    }
+                    baselineOut[i][r] = sum;
+                }
+            }
+            benchmark::DoNotOptimize(baselineOut.data());
+        } else {
+            if constexpr (K < C) {
+                transformPoints(m, in.data(), out.data(), transformCount);
+            } else {
+                transform(m, in.data(), out.data(), transformCount);
+            }
+            benchmark::DoNotOptimize(out.data());
+        }
+        benchmark::ClobberMemory();
+    }
+    const int64_t vectors = static_cast<int64_t>(state.iterations() * transformCount);
+    state.SetItemsProcessed(vectors);
+    state.SetBytesProcessed(vectors * static_cast<int64_t>((K + R) * sizeof(T)));
+}
+
+template <typename T, size_t R, size_t C, size_t K = C>
+void registerTransform() {
+    const std::string name = std::string("transform/") + typeName<T>() + "/" + std::to_string(R) + "x" +
+                             std::to_string(C) + (K < C ? "affine" : "");
+    benchmark::RegisterBenchmark((name + "/vectorND").c_str(), benchTransform<T, R, C, K, false>);
+    benchmark::RegisterBenchmark((name + "/baseline").c_str(), benchTransform<T, R, C, K, true>);
+}
+
+//* ------------------ runtime size ------------------ *//
+
+enum class DynOperation { dot, squaredDist, add };
+
+// the same operation on DynVector<float> (size read at run time) and on Vector<float, N>:
+// the difference is the cost of the runtime size
+template <size_t N, DynOperation Operation, bool Dynamic>
+void benchDyn(benchmark::State& state) {
+    const size_t count = std::max<size_t>(1, elementsPerArray / N);
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    using V = std::conditional_t<Dynamic, DynVector<float>, Vector<float, N>>;
+    std::vector<V> a, b;
+    for (size_t v = 0; v < count; v++) {
+        a.emplace_back(Vector<float, N>(arrays[v]));
+        b.emplace_back(Vector<float, N>(arraysB[v]));
+    }
+
+    for (auto _ : state) {
+        double sink = 0;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (Operation == DynOperation::dot) {
+                sink += a[v].dot(b[v]);
+            } else if constexpr (Operation == DynOperation::squaredDist) {
+                sink += a[v].squaredDist(b[v]);
+            } else {
+                const V sum = a[v] + b[v];
+                benchmark::DoNotOptimize(sum);
+            }
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(float)));
+    state.counters["op"] = benchmark::Counter(static_cast<double>(operations),
+                                              benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+template <size_t N, DynOperation Operation>
+void registerDyn(const std::string& operation) {
+    const std::string name = "dyn/float/" + std::to_string(N) + "/" + operation;
+    benchmark::RegisterBenchmark((name + "/dynamic").c_str(), benchDyn<N, Operation, true>);
+    benchmark::RegisterBenchmark((name + "/fixed").c_str(), benchDyn<N, Operation, false>);
+}
+
+template <size_t N>
+void registerDyn() {
+    registerDyn<N, DynOperation::dot>("dot");
+    registerDyn<N, DynOperation::squaredDist>("squaredDist");
+    registerDyn<N, DynOperation::add>("add");
+}
+
+//* ------------------ views ------------------ *//
+
+// dot of the consecutive rows of a flat row-major buffer (dot) or of the first 2 columns
+// (column, strided), through views or after copying them into Vector (the old way)
+template <size_t N, bool Column, bool Copy>
+void benchView(benchmark::State& state) {
+    const size_t rows = std::max<size_t>(2, elementsPerArray / N);
+    std::vector<float> buffer(rows * N);
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> values(-1, 1);
+    for (auto& x : buffer) {
+        x = values(rng);
+    }
+
+    for (auto _ : state) {
+        float sink = 0;
+        if constexpr (Column) {
+            // N columns of N elements: the buffer is read as a square matrix
+            for (size_t c = 0; c + 1 < N && (c + 1) * N <= buffer.size(); c++) {
+                const StridedVectorView<float, N> a(buffer.data() + c, N), b(buffer.data() + c + 1, N);
+                if constexpr (Copy) {
+                    sink += a.eval().dot(b.eval());
+                } else {
+                    sink += a.dot(b);
+                }
+            }
+        } else {
+            for (size_t r = 0; r + 1 < rows; r++) {
+                const float* a = buffer.data() + r * N;
+                if constexpr (Copy) {
+                    Array<float, N> x, y;
+                    std::copy(a, a + N, x.begin());
+                    std::copy(a + N, a + 2 * N, y.begin());
+                    sink += Vector<float, N>(x).dot(Vector<float, N>(y));
+                } else {
+                    sink += VectorView<float, N>(a).dot(VectorView<float, N>(a + N));
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    const size_t count = Column ? N - 1 : rows - 1;
+    const int64_t operations = static_cast<int64_t>(state.iterations() * count);
+    state.SetItemsProcessed(operations);
+    state.SetBytesProcessed(operations * 2 * static_cast<int64_t>(N * sizeof(float)));
+}
+
+template <size_t N>
+void registerView() {
+    const std::string name = "view/float/" + std::to_string(N);
+    benchmark::RegisterBenchmark((name + "/dot/view").c_str(), benchView<N, false, false>);
+    benchmark::RegisterBenchmark((name + "/dot/copy").c_str(), benchView<N, false, true>);
+    benchmark::RegisterBenchmark((name + "/column/view").c_str(), benchView<N, true, false>);
+    benchmark::RegisterBenchmark((name + "/column/copy").c_str(), benchView<N, true, true>);
+}
+
+#if defined(VECTORND_DISPATCH_BENCHMARKS)
+/**
+ * @brief batch dot or squaredDist of 4096 pairs with the kernels of one instruction set
+ */
+template <size_t N, bool Distance>
+void benchDispatch(benchmark::State& state, dispatch::Isa isa) {
+    constexpr size_t count = 4096;
+    std::vector<Array<float, N>> arrays(count), arraysB(count);
+    fill<Dot, float, N>(arrays, arraysB);
+    const std::vector<Vector<float, N>> a(arrays.begin(), arrays.end()), b(arraysB.begin(), arraysB.end());
+    std::vector<float> out(count);
+    const auto saved = dispatch::activeIsa();
+    dispatch::selectIsa(isa);
+    for (auto _ : state) {
+        if constexpr (Distance) {
+            dispatch::squaredDist(a.data(), b.data(), count, out.data());
+        } else {
+            dispatch::dot(a.data(), b.data(), count, out.data());
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    dispatch::selectIsa(saved);
+    state.SetItemsProcessed(state.iterations() * count);
+    state.SetBytesProcessed(state.iterations() * 2 * count * sizeof(Vector<float, N>));
+}
+
+template <size_t N>
+void registerDispatch() {
+    for (auto isa : {dispatch::Isa::Sse2, dispatch::Isa::Avx2, dispatch::Isa::Avx512}) {
+        if (isa > dispatch::detectedIsa()) {
+            continue;
+        }
+        const std::string name = "dispatch/float/" + std::to_string(N);
+        const std::string level = std::string("/") + dispatch::isaName(isa);
+        benchmark::RegisterBenchmark((name + "/dot" + level).c_str(), benchDispatch<N, false>, isa);
+        benchmark::RegisterBenchmark((name + "/squaredDist" + level).c_str(), benchDispatch<N, true>, isa);
+    }
+}
+#endif
+
+}
+
+int main(int argc, char** argv) {
+    registerAll<Add, Sub, Mul, Div, Scale, DivScalar, Negate, AddAssign, SubAssign, MulAssign, DivAssign,
+                Mod, Reverse, Dot, Norm, SquaredDist, Dist, Equal>();
+    registerSummationModes<128>();
+    registerSummationModes<1024>();
+    registerNormalize<3>();
+    registerNormalize<4>();
+    registerNormalize<16>();
+    registerQuantized<128, int8_t>();
+    registerQuantized<128, uint8_t>();
+    registerQuantized<1024, int8_t>();
+    registerQuantized<1024, uint8_t>();
+    registerHalf<128, float16_t>();
+    registerHalf<128, bfloat16_t>();
+    registerHalf<1024, float16_t>();
+    registerHalf<1024, bfloat16_t>();
+    registerIvf<64>();
+    registerIvf<256>();
+    registerKMeans<64>();
+    registerTransform<float, 2, 2>();
+    registerTransform<float, 3, 3>();
+    registerTransform<float, 4, 4>();
+    registerTransform<float, 3, 4, 3>();
+    registerTransform<double, 4, 4>();
+    registerDyn<16>();
+    registerDyn<384>();
+    registerDyn<768>();
+    registerView<16>();
+    registerView<64>();
+    registerCurves();
+#if defined(VECTORND_DISPATCH_BENCHMARKS)
+    registerDispatch<16>();
+    registerDispatch<128>();
+#endif
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
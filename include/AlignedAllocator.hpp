@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <new> // std::align_val_t
+#include <limits>
+
+namespace VectorND {
+
+/**
+ * @brief std allocator returning memory aligned on Alignment bytes
+ * (64 by default: a cache line, and the width of an AVX-512 register)
+ *
+ * @tparam T the type of the elements
+ * @tparam Alignment the alignment in bytes (power of 2)
+ */
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of 2");
+    static_assert(Alignment >= alignof(T), "the alignment must be at least alignof(T)");
+public:
+    using value_type = T;
+
+    static constexpr size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    /**
+     * @brief allocate n elements (not constructed)
+     *
+     * @param n
+     * @return T*
+     */
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    /**
+     * @brief free the memory returned by allocate
+     *
+     * @param p
+     */
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <type_traits>
+
+#include "Vector.hpp"
+
+namespace VectorND {
+
+/// alignment of the SIMD register used for Vector<T, N> (alignof(T) without SIMD backend)
+template <typename T, size_t N>
+constexpr size_t simdAlignment = [] {
+    if constexpr (simd::hasPacket<T, N>) {
+        return sizeof(typename simd::PacketFor<T, N>::type);
+    } else {
+        return alignof(T);
+    }
+}();
+
+/**
+ * @brief Vector<T, N> aligned on Alignment bytes, its size padded to a multiple of it.
+ *
+ * It is a Vector (same members, accepted everywhere a Vector is), with 2 differences:
+ *  - an array of AlignedVector never straddles a cache line or a register boundary more
+ *    than needed (Vector<float, 3> packed 16 bytes apart instead of 12)
+ *  - in the expressions and kernels, the last partial packet is loaded in full from the
+ *    padding and masked, instead of being gathered lane by lane (when the padding holds
+ *    the whole packet: AlignedVector<float, 3, 16>, AlignedVector<double, 3, 32>...)
+ *
+ * The padding is not part of the value (it is not compared, copied or written).
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ * @tparam Alignment in bytes, a power of 2 at least alignof(T): the register width by default
+ */
+template <typename T, size_t N, size_t Alignment = simdAlignment<T, N>>
+class alignas(Alignment) AlignedVector : public Vector<T, N>
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of 2");
+    static_assert(Alignment >= alignof(T), "the alignment must be at least alignof(T)");
+public:
+    static constexpr size_t alignment = Alignment;
+
+    using Vector<T, N>::Vector;
+    using Vector<T, N>::operator=;
+
+    constexpr AlignedVector() = default;
+    constexpr AlignedVector(const AlignedVector&) = default;
+    constexpr AlignedVector& operator=(const AlignedVector&) = default;
+
+    constexpr AlignedVector(const Vector<T, N>& vector): Vector<T, N>(vector) {}
+};
+
+namespace detail {
+
+// an operand of the expressions like Vector (packetOf reads the padding of the last packet)
+template <typename T, size_t N, size_t Alignment>
+struct ExprTraits<AlignedVector<T, N, Alignment>> : ExprTraits<Vector<T, N>> {};
+
+} // namespace detail
+
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Vector.hpp"
+
+/**
+ * Batch kernels with runtime instruction set dispatch, in the vectorNDDispatch library
+ * (CMake option VECTORND_DISPATCH).
+ *
+ * The header-only kernels use the widest instruction set enabled at compile time, so a binary
+ * built for a generic x86-64 runs SSE2 code on an AVX-512 server. The library compiles the same
+ * kernels for SSE2, AVX2 and AVX-512, and picks the best one supported by the cpu on the first call.
+ * The environment variable VECTORND_ISA (sse2, avx2 or avx512) lowers the level, for benchmarks
+ * and to check a build on older machines.
+ *
+ * The functions work on contiguous arrays of vectors with a runtime dimension, and run on several
+ * threads with OpenMP. The Vector<T, N> overloads forward to them.
+ */
+namespace VectorND {
+
+namespace dispatch {
+
+/**
+ * @brief instruction set of the batch kernels
+ */
+enum class Isa {
+    Sse2,  ///< baseline (the compiler flags of the library on a non x86 cpu)
+    Avx2,  ///< AVX2 and FMA
+    Avx512 ///< AVX-512 F, BW, DQ and VL
+};
+
+/**
+ * @brief widest instruction set supported by the cpu and compiled in the library
+ */
+Isa detectedIsa() noexcept;
+
+/**
+ * @brief instruction set used by the kernels: the detected one, or VECTORND_ISA if it is lower
+ */
+Isa activeIsa() noexcept;
+
+/**
+ * @brief use the kernels for isa, or for the detected one if the cpu does not support it
+ * @return the instruction set actually used
+ */
+Isa selectIsa(Isa isa) noexcept;
+
+/**
+ * @brief "sse2", "avx2" or "avx512"
+ */
+const char* isaName(Isa isa) noexcept;
+
+//* ------------------ kernels on arrays ------------------ *//
+
+/**
+ * @brief out[v] = dot product of the v-th vectors of a and b
+ * @param a count vectors of dimension values, one after the other
+ * @param b same layout as a
+ */
+void dot(const float* a, const float* b, size_t dimension, size_t count, float* out);
+void dot(const double* a, const double* b, size_t dimension, size_t count, double* out);
+
+/**
+ * @brief out[v] = squared distance between the v-th vectors of a and b
+ */
+void squaredDist(const float* a, const float* b, size_t dimension, size_t count, float* out);
+void squaredDist(const double* a, const double* b, size_t dimension, size_t count, double* out);
+
+/**
+ * @brief out[v] = squared norm of the v-th vector of a
+ */
+void squaredNorm(const float* a, size_t dimension, size_t count, float* out);
+void squaredNorm(const double* a, size_t dimension, size_t count, double* out);
+
+/**
+ * @brief out[v] = norm of the v-th vector of a
+ */
+void norm(const float* a, size_t dimension, size_t count, float* out);
+void norm(const double* a, size_t dimension, size_t count, double* out);
+
+/**
+ * @brief out[i] = a[i] * scalar for i in [0, n), out may be a
+ */
+void scale(const float* a, float scalar, float* out, size_t n);
+void scale(const double* a, double scalar, double* out, size_t n);
+
+/**
+ * @brief matrix of the squared distances between m queries and k database vectors:
+ * out[i * k + j] = squared distance between the i-th query and the j-th database vector.
+ *
+ * Unlike VectorND::pairwiseSquaredDist, each value is computed from the differences, so close
+ * vectors keep their precision.
+ */
+void pairwiseSquaredDist(const float* queries, size_t m, const float* database, size_t k, size_t dimension,
+                         float* out);
+void pairwiseSquaredDist(const double* queries, size_t m, const double* database, size_t k, size_t dimension,
+                         double* out);
+
+//* ------------------ kernels on Vector arrays ------------------ *//
+
+template <typename T, size_t N>
+void dot(const Vector<T, N>* a, const Vector<T, N>* b, size_t count, T* out);
+
+template <typename T, size_t N>
+void squaredDist(const Vector<T, N>* a, const Vector<T, N>* b, size_t count, T* out);
+
+template <typename T, size_t N>
+void squaredNorm(const Vector<T, N>* a, size_t count, T* out);
+
+template <typename T, size_t N>
+void norm(const Vector<T, N>* a, size_t count, T* out);
+
+/**
+ * @brief out[v] = a[v] * scalar, out may be a
+ */
+template <typename T, size_t N>
+void scale(const Vector<T, N>* a, T scalar, Vector<T, N>* out, size_t count);
+
+template <typename T, size_t N>
+void pairwiseSquaredDist(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out);
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+template <typename T, size_t N>
+inline const T* elements(const Vector<T, N>* vectors) noexcept {
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+    return reinterpret_cast<const T*>(vectors);
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+void dot(const Vector<T, N>* a, const Vector<T, N>* b, size_t count, T* out) {
+    dot(detail::elements(a), detail::elements(b), N, count, out);
+}
+
+template <typename T, size_t N>
+void squaredDist(const Vector<T, N>* a, const Vector<T, N>* b, size_t count, T* out) {
+    squaredDist(detail::elements(a), detail::elements(b), N, count, out);
+}
+
+template <typename T, size_t N>
+void squaredNorm(const Vector<T, N>* a, size_t count, T* out) {
+    squaredNorm(detail::elements(a), N, count, out);
+}
+
+template <typename T, size_t N>
+void norm(const Vector<T, N>* a, size_t count, T* out) {
+    norm(detail::elements(a), N, count, out);
+}
+
+template <typename T, size_t N>
+void scale(const Vector<T, N>* a, T scalar, Vector<T, N>* out, size_t count) {
+    scale(detail::elements(a), scalar, reinterpret_cast<T*>(out), N * count);
+}
+
+template <typename T, size_t N>
+void pairwiseSquaredDist(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out) {
+    pairwiseSquaredDist(detail::elements(queries), m, detail::elements(database), k, N, out);
+}
+
+} // namespace dispatch
+
+} // namespace VectorND
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max
+#include <cmath> // sqrt
+#include <type_traits>
+#include <vector>
+
+#include "Vector.hpp"
+#include "VectorArray.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+//* ------------------ metrics ------------------ *//
+
+// each metric turns the dot product of a query and a database vector into a distance,
+// using a per-vector value computed once (prepare): the squared norm or the inverse norm
+
+struct SquaredEuclideanMetric {
+    template <typename T>
+    static inline T prepare(T squaredNorm) { return squaredNorm; }
+
+    /// ||a||^2 + ||b||^2 - 2 a.b, clamped to 0 (the rounding can make it slightly negative)
+    template <typename T>
+    static inline T combine(T a, T b, T dot) { return std::max(a + b - 2 * dot, T{0}); }
+
+    template <typename P>
+    static inline typename P::type combinePacket(typename P::type a, typename P::type b, typename P::type dot) {
+        const auto d = P::sub(P::add(a, b), P::add(dot, dot));
+        return P::max(d, P::zero());
+    }
+};
+
+struct EuclideanMetric {
+    template <typename T>
+    static inline T prepare(T squaredNorm) { return squaredNorm; }
+
+    template <typename T>
+    static inline T combine(T a, T b, T dot) { return std::sqrt(SquaredEuclideanMetric::combine(a, b, dot)); }
+
+    template <typename P>
+    static inline typename P::type combinePacket(typename P::type a, typename P::type b, typename P::type dot) {
+        return P::sqrt(SquaredEuclideanMetric::combinePacket<P>(a, b, dot));
+    }
+};
+
+struct CosineMetric {
+    /// inverse norm, 0 for a null vector (its distance to any vector is then 1)
+    template <typename T>
+    static inline T prepare(T squaredNorm) { return squaredNorm > 0 ? T{1} / std::sqrt(squaredNorm) : T{0}; }
+
+    /// 1 - a.b / (||a|| ||b||)
+    template <typename T>
+    static inline T combine(T a, T b, T dot) { return T{1} - dot * a * b; }
+
+    template <typename P>
+    static inline typename P::type combinePacket(typename P::type a, typename P::type b, typename P::type dot) {
+        return P::sub(P::set1(1), P::mul(dot, P::mul(a, b)));
+    }
+};
+
+//* ------------------ blocking ------------------ *//
+
+/// number of queries processed together by a thread
+constexpr size_t distanceRowBlock = 32;
+
+/// number of database vectors of a block: N lanes of the block fit in 256 KiB (L2)
+template <typename T, size_t N>
+constexpr size_t distanceColumnBlock() {
+    constexpr size_t bytes = 256 * 1024;
+    constexpr size_t columns = bytes / (N * sizeof(T));
+    return std::max<size_t>(64, columns / 64 * 64);
+}
+
+/**
+ * @brief out[j] = Metric(query, database[j]) for j in [begin, end)
+ */
+template <typename Metric, typename T, size_t N>
+inline void distanceRow(const Vector<T, N>& query, T queryValue, const VectorArray<T, N>& database,
+                        const T* databaseValues, size_t begin, size_t end, T* out) {
+    size_t j = begin;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        const auto q = P::set1(queryValue);
+        for (; j + P::width <= end; j += P::width) {
+            auto acc = P::zero();
+            for (size_t d = 0; d < N; d++) {
+                acc = P::add(acc, P::mul(P::set1(query[d]), P::load(database.lane(d) + j)));
+            }
+            P::store(out + j, Metric::template combinePacket<P>(q, P::load(databaseValues + j), acc));
+        }
+    }
+    for (; j < end; j++) {
+        T acc{0};
+        for (size_t d = 0; d < N; d++) {
+            acc += query[d] * database.lane(d)[j];
+        }
+        out[j] = Metric::combine(queryValue, databaseValues[j], acc);
+    }
+}
+
+/**
+ * @brief M x K distance matrix, row blocks in parallel, database by cache sized blocks
+ */
+template <typename Metric, typename T, size_t N>
+void pairwise(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out) {
+    static_assert(std::is_floating_point_v<T>, "the distance matrices need a floating point type");
+    if (m == 0 || k == 0) {
+        return;
+    }
+    // the database is transposed once, so the inner loop runs on SIMD packets along the database
+    const VectorArray<T, N> soa(database, k);
+    std::vector<T> databaseValues(k);
+    soa.squaredNorm(databaseValues.data());
+    for (auto& value : databaseValues) {
+        value = Metric::prepare(value);
+    }
+
+    constexpr size_t columnBlock = distanceColumnBlock<T, N>();
+    const size_t rowBlocks = (m + distanceRowBlock - 1) / distanceRowBlock;
+
+    VECTORND_OMP(parallel for schedule(dynamic))
+    for (size_t rowBlock = 0; rowBlock < rowBlocks; rowBlock++) {
+        const size_t rowBegin = rowBlock * distanceRowBlock;
+        const size_t rowEnd = std::min(m, rowBegin + distanceRowBlock);
+        T queryValues[distanceRowBlock];
+        for (size_t i = rowBegin; i < rowEnd; i++) {
+            queryValues[i - rowBegin] = Metric::prepare(queries[i].dot(queries[i]));
+        }
+        for (size_t columnBegin = 0; columnBegin < k; columnBegin += columnBlock) {
+            const size_t columnEnd = std::min(k, columnBegin + columnBlock);
+            for (size_t i = rowBegin; i < rowEnd; i++) {
+                distanceRow<Metric>(queries[i], queryValues[i - rowBegin], soa, databaseValues.data(),
+                                    columnBegin, columnEnd, out + i * k);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief matrix of the squared distances between M queries and K database vectors:
+ * out[i * k + j] = queries[i].squaredDist(database[j]).
+ *
+ * Computed as ||a||^2 + ||b||^2 - 2 a.b with precomputed norms, by cache sized blocks and on
+ * several threads. The expansion loses precision for close vectors far from the origin:
+ * the absolute error is about epsilon * (||a||^2 + ||b||^2).
+ *
+ * @param queries m vectors
+ * @param m number of queries
+ * @param database k vectors
+ * @param k number of database vectors
+ * @param out m * k values, row major
+ */
+template <typename T, size_t N>
+void pairwiseSquaredDist(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out) {
+    detail::pairwise<detail::SquaredEuclideanMetric>(queries, m, database, k, out);
+}
+
+/**
+ * @brief matrix of the euclidean distances: out[i * k + j] = queries[i].dist(database[j])
+ *
+ * @param queries m vectors
+ * @param m number of queries
+ * @param database k vectors
+ * @param k number of database vectors
+ * @param out m * k values, row major
+ */
+template <typename T, size_t N>
+void pairwiseDist(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out) {
+    detail::pairwise<detail::EuclideanMetric>(queries, m, database, k, out);
+}
+
+/**
+ * @brief matrix of the cosine distances: out[i * k + j] = 1 - cos(queries[i], database[j]).
+ * A null vector is at distance 1 of every vector.
+ *
+ * @param queries m vectors
+ * @param m number of queries
+ * @param database k vectors
+ * @param k number of database vectors
+ * @param out m * k values, row major
+ */
+template <typename T, size_t N>
+void pairwiseCosineDist(const Vector<T, N>* queries, size_t m, const Vector<T, N>* database, size_t k, T* out) {
+    detail::pairwise<detail::CosineMetric>(queries, m, database, k, out);
+}
+
+//* ------------------ std::vector overloads ------------------ *//
+
+template <typename T, size_t N>
+void pairwiseSquaredDist(const std::vector<Vector<T, N>>& queries, const std::vector<Vector<T, N>>& database, std::vector<T>& out) {
+    out.resize(queries.size() * database.size());
+    pairwiseSquaredDist(queries.data(), queries.size(), database.data(), database.size(), out.data());
+}
+
+template <typename T, size_t N>
+void pairwiseDist(const std::vector<Vector<T, N>>& queries, const std::vector<Vector<T, N>>& database, std::vector<T>& out) {
+    out.resize(queries.size() * database.size());
+    pairwiseDist(queries.data(), queries.size(), database.data(), database.size(), out.data());
+}
+
+template <typename T, size_t N>
+void pairwiseCosineDist(const std::vector<Vector<T, N>>& queries, const std::vector<Vector<T, N>>& database, std::vector<T>& out) {
+    out.resize(queries.size() * database.size());
+    pairwiseCosineDist(queries.data(), queries.size(), database.data(), database.size(), out.data());
+}
+
+}
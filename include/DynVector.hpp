@@ -0,0 +1,527 @@
+#pragma once
+
+#include <algorithm> // std::copy, std::fill
+#include <stdexcept>
+#include <string>
+#include <utility> // std::move, std::swap
+#include <vector>
+
+#include "Vector.hpp"
+#include "VectorArray.hpp" // kernels on contiguous arrays
+#include "AlignedAllocator.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief vector whose number of elements is known at run time (embedding dimensions read
+ * from model metadata, ...), with the arithmetic, dot, norm, dist and mod API of Vector.
+ *
+ * Up to InlineCapacity elements are stored inline (no allocation), larger vectors in heap
+ * storage aligned on 64 bytes. A moved vector hands over its heap storage, and the binary
+ * operators write into the storage of an rvalue operand: a + b + c allocates once.
+ * The operations run the SIMD kernels of Vector on the runtime size (a single call, no
+ * per-size dispatch). Operands of different sizes throw std::invalid_argument.
+ *
+ * @tparam T the type of the elements
+ * @tparam InlineCapacity the number of elements stored inline (64 bytes by default)
+ */
+template <typename T, size_t InlineCapacity = std::max<size_t>(1, 64 / sizeof(T))>
+class DynVector
+{
+private:
+    T* ptr;
+    size_t count;
+    size_t storageCapacity;
+    alignas(64) T local[InlineCapacity];
+
+    // no initialization of the elements (overwritten by a kernel)
+    struct Uninitialized {};
+    DynVector(size_t n, Uninitialized);
+
+    inline bool isInline() const noexcept { return ptr == local; }
+    void release() noexcept;
+
+    // throw std::invalid_argument if the sizes differ (the message is built out of line)
+    static inline void checkSize(const DynVector& a, const DynVector& b, const char* operation) {
+        if (a.count != b.count) {
+            sizeMismatch(a.count, b.count, operation);
+        }
+    }
+    [[noreturn]] static void sizeMismatch(size_t a, size_t b, const char* operation);
+
+    // out = Op(a, b), out is a new vector or one of the operands
+    template <typename Op>
+    static DynVector combine(const DynVector& a, const DynVector& b, DynVector&& out);
+
+    // out = Op(a, scalar)
+    template <typename Op>
+    static DynVector combine(const DynVector& a, T scalar, DynVector&& out);
+public:
+    // aliases
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // number of elements stored without allocation
+    static constexpr size_t inlineCapacity = InlineCapacity;
+    //**----------
+    DynVector() noexcept: ptr{local}, count{0}, storageCapacity{InlineCapacity} {}
+
+    /**
+     * @brief null vector of n elements
+     *
+     * @param n
+     */
+    explicit DynVector(size_t n);
+
+    /**
+     * @brief n elements equal to value
+     *
+     * @param n
+     * @param value
+     */
+    DynVector(size_t n, T value);
+
+    /**
+     * @brief copy n elements
+     *
+     * @param values
+     * @param n
+     */
+    DynVector(const T* values, size_t n);
+
+    explicit DynVector(const std::vector<T>& values): DynVector(values.data(), values.size()) {}
+
+    template <size_t N>
+    explicit DynVector(const Vector<T, N>& vector): DynVector(vector.cbegin(), N) {}
+
+    DynVector(const DynVector& other): DynVector(other.ptr, other.count) {}
+
+    // takes the heap storage of other (inline elements are copied), other is left empty
+    DynVector(DynVector&& other) noexcept;
+
+    ~DynVector() { release(); }
+
+    DynVector& operator=(const DynVector& other);
+    DynVector& operator=(DynVector&& other) noexcept;
+    //**----------
+
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+    inline size_t capacity() const noexcept { return storageCapacity; }
+
+    inline T* data() noexcept { return ptr; }
+    inline const T* data() const noexcept { return ptr; }
+
+    inline iterator begin() noexcept { return ptr; }
+    inline const_iterator begin() const noexcept { return ptr; }
+    inline const_iterator cbegin() const noexcept { return ptr; }
+    inline iterator end() noexcept { return ptr + count; }
+    inline const_iterator end() const noexcept { return ptr + count; }
+    inline const_iterator cend() const noexcept { return ptr + count; }
+
+    /**
+     * @brief resize the vector, the new elements are 0
+     *
+     * @param n
+     */
+    void resize(size_t n);
+
+    /**
+     * @brief element access operator (write)
+     *
+     * @param i the index of the element
+     */
+    inline T& operator[](size_t i) { return ptr[i]; }
+
+    /**
+     * @brief element access operator (read)
+     *
+     * @param i the index of the element
+     */
+    inline T operator[](size_t i) const { return ptr[i]; }
+
+    /**
+     * @brief element access (read) with bounds checking
+     *
+     * @param i the index of the element
+     * @throw std::out_of_range if i >= size()
+     */
+    T at(size_t i) const;
+
+    /**
+     * @brief copy into a fixed-size vector
+     *
+     * @tparam N the number of elements
+     * @throw std::invalid_argument if size() != N
+     */
+    template <size_t N>
+    Vector<T, N> toVector() const;
+
+    /**
+     * @brief element by element operations, in place
+     *
+     * @param other a vector of the same size
+     * @return DynVector&
+     */
+    DynVector& operator+=(const DynVector& other);
+    DynVector& operator-=(const DynVector& other);
+    DynVector& operator*=(const DynVector& other);
+    DynVector& operator/=(const DynVector& other);
+
+    DynVector& operator*=(T scalar);
+    DynVector& operator/=(T scalar);
+
+    /**
+     * @brief dot product (in the compute type of T, rounded to T at the end)
+     *
+     * @param other
+     * @return T
+     */
+    T dot(const DynVector& other) const;
+
+    /**
+     * @brief dot product accumulated in Acc with a summation mode (see Vector::dot)
+     *
+     * @tparam Acc the accumulator (and result) type
+     * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+     */
+    template <typename Acc, typename Mode = summation::Naive>
+    Acc dot(const DynVector& other) const;
+
+    /**
+     * @brief true modulo of each element
+     *
+     * @param other a vector of the same size, or a scalar
+     * @return DynVector
+     */
+    DynVector mod(const DynVector& other) const;
+    DynVector mod(T scalar) const;
+
+    double norm() const;
+    double squaredNorm() const;
+    double dist(const DynVector& other) const;
+    double squaredDist(const DynVector& other) const;
+
+    static double norm(const DynVector& vector) { return vector.norm(); }
+    static double squaredNorm(const DynVector& vector) { return vector.squaredNorm(); }
+    static double dist(const DynVector& a, const DynVector& b) { return a.dist(b); }
+    static double squaredDist(const DynVector& a, const DynVector& b) { return a.squaredDist(b); }
+
+    /// divide by the norm (a null vector is unchanged), for floating-point elements only
+    DynVector& normalize();
+    DynVector normalized() const;
+
+    DynVector reverse() const;
+
+    bool operator==(const DynVector& other) const;
+    bool operator!=(const DynVector& other) const { return !(*this == other); }
+
+    //* binary operators: the result reuses the storage of an rvalue operand
+
+    friend DynVector operator+(const DynVector& a, const DynVector& b) { return combine<detail::Add>(a, b, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator+(DynVector&& a, const DynVector& b) { return combine<detail::Add>(a, b, std::move(a)); }
+    friend DynVector operator+(const DynVector& a, DynVector&& b) { return combine<detail::Add>(a, b, std::move(b)); }
+    friend DynVector operator+(DynVector&& a, DynVector&& b) { return combine<detail::Add>(a, b, std::move(a)); }
+
+    friend DynVector operator-(const DynVector& a, const DynVector& b) { return combine<detail::Sub>(a, b, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator-(DynVector&& a, const DynVector& b) { return combine<detail::Sub>(a, b, std::move(a)); }
+    friend DynVector operator-(const DynVector& a, DynVector&& b) { return combine<detail::Sub>(a, b, std::move(b)); }
+    friend DynVector operator-(DynVector&& a, DynVector&& b) { return combine<detail::Sub>(a, b, std::move(a)); }
+
+    friend DynVector operator*(const DynVector& a, const DynVector& b) { return combine<detail::Mul>(a, b, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator*(DynVector&& a, const DynVector& b) { return combine<detail::Mul>(a, b, std::move(a)); }
+    friend DynVector operator*(const DynVector& a, DynVector&& b) { return combine<detail::Mul>(a, b, std::move(b)); }
+    friend DynVector operator*(DynVector&& a, DynVector&& b) { return combine<detail::Mul>(a, b, std::move(a)); }
+
+    friend DynVector operator/(const DynVector& a, const DynVector& b) { return combine<detail::Div>(a, b, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator/(DynVector&& a, const DynVector& b) { return combine<detail::Div>(a, b, std::move(a)); }
+    friend DynVector operator/(const DynVector& a, DynVector&& b) { return combine<detail::Div>(a, b, std::move(b)); }
+    friend DynVector operator/(DynVector&& a, DynVector&& b) { return combine<detail::Div>(a, b, std::move(a)); }
+
+    friend DynVector operator*(const DynVector& a, T scalar) { return combine<detail::Mul>(a, scalar, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator*(DynVector&& a, T scalar) { return combine<detail::Mul>(a, scalar, std::move(a)); }
+    friend DynVector operator*(T scalar, const DynVector& a) { return a * scalar; }
+    friend DynVector operator*(T scalar, DynVector&& a) { return std::move(a) * scalar; }
+
+    friend DynVector operator/(const DynVector& a, T scalar) { return combine<detail::Div>(a, scalar, DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator/(DynVector&& a, T scalar) { return combine<detail::Div>(a, scalar, std::move(a)); }
+
+    friend DynVector operator-(const DynVector& a) { return combine<detail::Mul>(a, T(-1), DynVector(a.count, Uninitialized{})); }
+    friend DynVector operator-(DynVector&& a) { return combine<detail::Mul>(a, T(-1), std::move(a)); }
+
+    /**
+     * @brief print the vector as [a, b, ...]
+     *
+     * @param os
+     * @param vector
+     * @return std::ostream&
+     */
+    friend std::ostream& operator<<(std::ostream& os, const DynVector& vector) {
+        os << "[";
+        for (size_t i = 0; i < vector.count; i++) {
+            os << vector.ptr[i];
+            if (i < vector.count - 1) {
+                os << ", ";
+            }
+        }
+        os << "]";
+        return os;
+    }
+};
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t I>
+DynVector<T, I>::DynVector(size_t n, Uninitialized): ptr{local}, count{n}, storageCapacity{I} {
+    if (n > I) {
+        ptr = AlignedAllocator<T>().allocate(n);
+        storageCapacity = n;
+    }
+}
+
+template <typename T, size_t I>
+DynVector<T, I>::DynVector(size_t n): DynVector(n, Uninitialized{}) {
+    std::fill(ptr, ptr + n, T(0));
+}
+
+template <typename T, size_t I>
+DynVector<T, I>::DynVector(size_t n, T value): DynVector(n, Uninitialized{}) {
+    std::fill(ptr, ptr + n, value);
+}
+
+template <typename T, size_t I>
+DynVector<T, I>::DynVector(const T* values, size_t n): DynVector(n, Uninitialized{}) {
+    std::copy(values, values + n, ptr);
+}
+
+template <typename T, size_t I>
+DynVector<T, I>::DynVector(DynVector&& other) noexcept: ptr{local}, count{other.count}, storageCapacity{I} {
+    if (other.isInline()) {
+        std::copy(other.ptr, other.ptr + other.count, local);
+    } else {
+        ptr = other.ptr;
+        storageCapacity = other.storageCapacity;
+        other.ptr = other.local;
+        other.storageCapacity = I;
+    }
+    other.count = 0;
+}
+
+template <typename T, size_t I>
+void DynVector<T, I>::release() noexcept {
+    if (!isInline()) {
+        AlignedAllocator<T>().deallocate(ptr, storageCapacity);
+    }
+    ptr = local;
+    storageCapacity = I;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator=(const DynVector& other) {
+    if (this != &other) {
+        // the current storage is kept when it is large enough
+        if (other.count > storageCapacity) {
+            DynVector copy(other);
+            return *this = std::move(copy);
+        }
+        std::copy(other.ptr, other.ptr + other.count, ptr);
+        count = other.count;
+    }
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator=(DynVector&& other) noexcept {
+    if (this != &other) {
+        if (other.isInline()) {
+            // elements copied into the current storage (inline, or heap already larger)
+            std::copy(other.ptr, other.ptr + other.count, ptr);
+        } else {
+            release();
+            ptr = other.ptr;
+            storageCapacity = other.storageCapacity;
+            other.ptr = other.local;
+            other.storageCapacity = I;
+        }
+        count = other.count;
+        other.count = 0;
+    }
+    return *this;
+}
+
+template <typename T, size_t I>
+void DynVector<T, I>::resize(size_t n) {
+    if (n > storageCapacity) {
+        DynVector larger(n, Uninitialized{});
+        std::copy(ptr, ptr + count, larger.ptr);
+        larger.count = count;
+        *this = std::move(larger);
+    }
+    if (n > count) {
+        std::fill(ptr + count, ptr + n, T(0));
+    }
+    count = n;
+}
+
+template <typename T, size_t I>
+T DynVector<T, I>::at(size_t i) const {
+    if (i >= count) {
+        throw std::out_of_range("VectorND: index " + std::to_string(i) + " out of a DynVector of size " +
+                                std::to_string(count));
+    }
+    return ptr[i];
+}
+
+template <typename T, size_t I>
+template <size_t N>
+Vector<T, N> DynVector<T, I>::toVector() const {
+    if (count != N) {
+        throw std::invalid_argument("VectorND: a DynVector of size " + std::to_string(count) +
+                                    " is not a Vector of size " + std::to_string(N));
+    }
+    Vector<T, N> result;
+    std::copy(ptr, ptr + N, result.begin());
+    return result;
+}
+
+template <typename T, size_t I>
+void DynVector<T, I>::sizeMismatch(size_t a, size_t b, const char* operation) {
+    throw std::invalid_argument(std::string("VectorND: ") + operation + " of DynVector of sizes " +
+                                std::to_string(a) + " and " + std::to_string(b));
+}
+
+template <typename T, size_t I>
+template <typename Op>
+DynVector<T, I> DynVector<T, I>::combine(const DynVector& a, const DynVector& b, DynVector&& out) {
+    checkSize(a, b, "element by element operation");
+    detail::spanBinary<Op>(a.ptr, b.ptr, out.ptr, a.count);
+    return std::move(out);
+}
+
+template <typename T, size_t I>
+template <typename Op>
+DynVector<T, I> DynVector<T, I>::combine(const DynVector& a, T scalar, DynVector&& out) {
+    detail::spanScalar<Op>(a.ptr, scalar, out.ptr, a.count);
+    return std::move(out);
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator+=(const DynVector& other) {
+    checkSize(*this, other, "+=");
+    detail::spanBinary<detail::Add>(ptr, other.ptr, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator-=(const DynVector& other) {
+    checkSize(*this, other, "-=");
+    detail::spanBinary<detail::Sub>(ptr, other.ptr, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator*=(const DynVector& other) {
+    checkSize(*this, other, "*=");
+    detail::spanBinary<detail::Mul>(ptr, other.ptr, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator/=(const DynVector& other) {
+    checkSize(*this, other, "/=");
+    detail::spanBinary<detail::Div>(ptr, other.ptr, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator*=(T scalar) {
+    detail::spanScalar<detail::Mul>(ptr, scalar, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::operator/=(T scalar) {
+    detail::spanScalar<detail::Div>(ptr, scalar, ptr, count);
+    return *this;
+}
+
+template <typename T, size_t I>
+T DynVector<T, I>::dot(const DynVector& other) const {
+    checkSize(*this, other, "dot");
+    return static_cast<T>(detail::spanDot(ptr, other.ptr, count));
+}
+
+template <typename T, size_t I>
+template <typename Acc, typename Mode>
+Acc DynVector<T, I>::dot(const DynVector& other) const {
+    checkSize(*this, other, "dot");
+    return detail::spanReduce<Acc, Mode>(detail::SpanOperand<T>{ptr}, detail::SpanOperand<T>{other.ptr}, count);
+}
+
+template <typename T, size_t I>
+DynVector<T, I> DynVector<T, I>::mod(const DynVector& other) const {
+    checkSize(*this, other, "mod");
+    DynVector result(count, Uninitialized{});
+    detail::spanModElements(ptr, other.ptr, result.ptr, count);
+    return result;
+}
+
+template <typename T, size_t I>
+DynVector<T, I> DynVector<T, I>::mod(T scalar) const {
+    DynVector result(count, Uninitialized{});
+    detail::spanMod(ptr, scalar, result.ptr, count);
+    return result;
+}
+
+template <typename T, size_t I>
+double DynVector<T, I>::norm() const {
+    return detail::sqrt(squaredNorm());
+}
+
+template <typename T, size_t I>
+double DynVector<T, I>::squaredNorm() const {
+    return static_cast<double>(detail::spanSquaredNorm(ptr, count));
+}
+
+template <typename T, size_t I>
+double DynVector<T, I>::dist(const DynVector& other) const {
+    return detail::sqrt(squaredDist(other));
+}
+
+template <typename T, size_t I>
+double DynVector<T, I>::squaredDist(const DynVector& other) const {
+    checkSize(*this, other, "squaredDist");
+    return static_cast<double>(detail::spanSquaredDist(ptr, other.ptr, count));
+}
+
+template <typename T, size_t I>
+DynVector<T, I>& DynVector<T, I>::normalize() {
+    static_assert(!std::is_integral_v<T>, "normalize needs floating-point elements");
+    const auto squared = detail::spanSquaredNorm(ptr, count);
+    if (squared > 0) {
+        *this *= static_cast<T>(1 / detail::sqrt(squared));
+    }
+    return *this;
+}
+
+template <typename T, size_t I>
+DynVector<T, I> DynVector<T, I>::normalized() const {
+    DynVector result(*this);
+    result.normalize();
+    return result;
+}
+
+template <typename T, size_t I>
+DynVector<T, I> DynVector<T, I>::reverse() const {
+    DynVector result(count, Uninitialized{});
+    std::reverse_copy(ptr, ptr + count, result.ptr);
+    return result;
+}
+
+template <typename T, size_t I>
+bool DynVector<T, I>::operator==(const DynVector& other) const {
+    return count == other.count && std::equal(ptr, ptr + count, other.ptr);
+}
+
+} // namespace VectorND
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm> // std::min, std::copy
+#include <cmath> // sqrt
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+/// number of vectors whose inverse norms are computed together
+constexpr size_t invNormBlock = 16;
+
+/**
+ * @brief out[i] = 1 / sqrt(squared[i]) for i in [0, invNormBlock): the packet estimate of
+ * simd::fastInvSqrt for float, the exact value otherwise. The lanes outside the normal floats
+ * (0, subnormal, inf) are redone exactly, so 0 gives inf.
+ */
+template <typename T>
+inline void invSqrtBlock(const T* squared, T* out) {
+    size_t i = 0;
+    if constexpr (std::is_same_v<T, float> && simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        static_assert(invNormBlock % P::width == 0, "the block must be a multiple of the packet width");
+        for (; i < invNormBlock; i += P::width) {
+            P::store(out + i, simd::fastInvSqrt<P>(P::load(squared + i)));
+        }
+        for (size_t j = 0; j < invNormBlock; j++) {
+            if (!(squared[j] >= std::numeric_limits<T>::min() && squared[j] <= std::numeric_limits<T>::max())) {
+                out[j] = static_cast<T>(1 / std::sqrt(static_cast<double>(squared[j])));
+            }
+        }
+    }
+    for (; i < invNormBlock; i++) {
+        out[i] = fastInvSqrt(squared[i]);
+    }
+}
+
+/// squared norms of a block of count <= invNormBlock vectors, the unused lanes are set to 1
+template <typename T, size_t N>
+inline void squaredNormBlock(const Vector<T, N>* vectors, size_t count, T* squared) {
+    for (size_t j = 0; j < count; j++) {
+        squared[j] = static_cast<T>(vectors[j].dot(vectors[j]));
+    }
+    for (size_t j = count; j < invNormBlock; j++) {
+        squared[j] = 1;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief out[i] = vectors[i].invNorm() for i in [0, count), in parallel. The inverse square
+ * roots of a block of vectors are computed together with the widest packet (float).
+ *
+ * @param vectors
+ * @param count
+ * @param out count values, inf for a null vector
+ */
+template <typename T, size_t N>
+void invNorm(const Vector<T, N>* vectors, size_t count, T* out);
+
+template <typename T, size_t N>
+std::vector<T> invNorm(const std::vector<Vector<T, N>>& vectors) {
+    std::vector<T> out(vectors.size());
+    invNorm(vectors.data(), vectors.size(), out.data());
+    return out;
+}
+
+/**
+ * @brief vectors[i].fastNormalize() for i in [0, count), in parallel (null vectors are left
+ * unchanged)
+ *
+ * @param vectors
+ * @param count
+ */
+template <typename T, size_t N>
+void fastNormalize(Vector<T, N>* vectors, size_t count);
+
+template <typename T, size_t N>
+void fastNormalize(std::vector<Vector<T, N>>& vectors) {
+    fastNormalize(vectors.data(), vectors.size());
+}
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+void invNorm(const Vector<T, N>* vectors, size_t count, T* out) {
+    static_assert(std::is_floating_point_v<T>, "invNorm needs floating-point elements");
+    constexpr size_t B = detail::invNormBlock;
+    const size_t blocks = (count + B - 1) / B;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * B;
+        const size_t n = std::min(B, count - begin);
+        T squared[B];
+        T inverse[B];
+        detail::squaredNormBlock(vectors + begin, n, squared);
+        detail::invSqrtBlock(squared, inverse);
+        std::copy(inverse, inverse + n, out + begin);
+    }
+}
+
+template <typename T, size_t N>
+void fastNormalize(Vector<T, N>* vectors, size_t count) {
+    static_assert(std::is_floating_point_v<T>, "fastNormalize needs floating-point elements");
+    constexpr size_t B = detail::invNormBlock;
+    const size_t blocks = (count + B - 1) / B;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * B;
+        const size_t n = std::min(B, count - begin);
+        T squared[B];
+        T inverse[B];
+        detail::squaredNormBlock(vectors + begin, n, squared);
+        detail::invSqrtBlock(squared, inverse);
+        for (size_t j = 0; j < n; j++) {
+            if (squared[j] > 0) {
+                vectors[begin + j] *= inverse[j];
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,497 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <type_traits>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+//* ------------------ scalar conversions ------------------ *//
+
+inline uint32_t floatBits(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/// IEEE binary16 bits of a float, rounded to nearest even (F16C when available)
+inline uint16_t floatToHalfBits(float x) {
+#if defined(__F16C__)
+    return static_cast<uint16_t>(_cvtss_sh(x, _MM_FROUND_TO_NEAREST_INT));
+#else
+    const uint32_t bits = floatBits(x);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    if (magnitude >= 0x7F800000u) {
+        // inf, or a quiet nan keeping the high bits of the payload
+        return static_cast<uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u | ((magnitude >> 13) & 0x3FFu) : 0));
+    }
+    if (magnitude >= 0x477FF000u) {
+        // 65520 and above round to inf
+        return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (magnitude < 0x38800000u) {
+        // below 2^-14: a subnormal half, 2^-25 and below round to 0
+        if (magnitude <= 0x33000000u) {
+            return static_cast<uint16_t>(sign);
+        }
+        const uint32_t exponent = magnitude >> 23;
+        const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+        const uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t middle = 1u << (shift - 1);
+        if (rest > middle || (rest == middle && (half & 1u))) {
+            half++;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+    // normal: rebias the exponent, round the 13 dropped bits (a carry may reach the exponent)
+    uint32_t half = (magnitude - 0x38000000u) >> 13;
+    const uint32_t rest = magnitude & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        half++;
+    }
+    return static_cast<uint16_t>(sign | half);
+#endif
+}
+
+/// float value of IEEE binary16 bits (exact)
+inline float halfBitsToFloat(uint16_t half) {
+#if defined(__F16C__)
+    return _cvtsh_ss(half);
+#else
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    if (exponent == 0x1Fu) {
+        return bitsFloat(sign | 0x7F800000u | (mantissa << 13));
+    }
+    if (exponent != 0) {
+        return bitsFloat(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+    if (mantissa == 0) {
+        return bitsFloat(sign);
+    }
+    // subnormal: normalize the mantissa
+    uint32_t floatExponent = 113;
+    while (!(mantissa & 0x400u)) {
+        mantissa <<= 1;
+        floatExponent--;
+    }
+    return bitsFloat(sign | (floatExponent << 23) | ((mantissa & 0x3FFu) << 13));
+#endif
+}
+
+/// bfloat16 bits of a float (its 16 high bits), rounded to nearest even
+inline uint16_t floatToBfloat16Bits(float x) {
+    const uint32_t bits = floatBits(x);
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        // quiet nan
+        return static_cast<uint16_t>((bits >> 16) | 0x40u);
+    }
+    return static_cast<uint16_t>((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+}
+
+inline float bfloat16BitsToFloat(uint16_t bits) {
+    return bitsFloat(static_cast<uint32_t>(bits) << 16);
+}
+
+} // namespace detail
+
+//* ------------------ 16 bits floating-point types ------------------ *//
+
+/**
+ * @brief IEEE 754 half precision (binary16: 5 bits exponent, 10 bits mantissa) storage type.
+ * The values convert implicitly to and from float, every operation is computed in float:
+ * Vector<float16_t, N> stores N * 2 bytes and computes like Vector<float, N> (F16C packets).
+ */
+struct float16_t {
+    uint16_t bits;
+
+    float16_t() = default;
+    float16_t(float x): bits{detail::floatToHalfBits(x)} {}
+
+    /// the value with the given bits
+    static inline float16_t fromBits(uint16_t bits) {
+        float16_t x;
+        x.bits = bits;
+        return x;
+    }
+
+    operator float() const { return detail::halfBitsToFloat(bits); }
+
+    float16_t& operator+=(float x) { return *this = float16_t(float(*this) + x); }
+    float16_t& operator-=(float x) { return *this = float16_t(float(*this) - x); }
+    float16_t& operator*=(float x) { return *this = float16_t(float(*this) * x); }
+    float16_t& operator/=(float x) { return *this = float16_t(float(*this) / x); }
+};
+
+/**
+ * @brief bfloat16 (8 bits exponent, 7 bits mantissa: the high half of a float) storage type:
+ * the range of float with 2 or 3 significant digits. Computed in float like float16_t.
+ */
+struct bfloat16_t {
+    uint16_t bits;
+
+    bfloat16_t() = default;
+    bfloat16_t(float x): bits{detail::floatToBfloat16Bits(x)} {}
+
+    /// the value with the given bits
+    static inline bfloat16_t fromBits(uint16_t bits) {
+        bfloat16_t x;
+        x.bits = bits;
+        return x;
+    }
+
+    operator float() const { return detail::bfloat16BitsToFloat(bits); }
+
+    bfloat16_t& operator+=(float x) { return *this = bfloat16_t(float(*this) + x); }
+    bfloat16_t& operator-=(float x) { return *this = bfloat16_t(float(*this) - x); }
+    bfloat16_t& operator*=(float x) { return *this = bfloat16_t(float(*this) * x); }
+    bfloat16_t& operator/=(float x) { return *this = bfloat16_t(float(*this) / x); }
+};
+
+static_assert(sizeof(float16_t) == 2 && std::is_trivially_copyable_v<float16_t>);
+static_assert(sizeof(bfloat16_t) == 2 && std::is_trivially_copyable_v<bfloat16_t>);
+
+namespace simd {
+
+template <>
+struct ComputeTypeOf<float16_t> {
+    using type = float;
+};
+
+template <>
+struct ComputeTypeOf<bfloat16_t> {
+    using type = float;
+};
+
+#if VECTORND_SIMD
+
+//* ------------------ 16 bits lanes ------------------ *//
+
+// the raw 16 bits lanes of a packet: width 4 in the low half of a __m128i, 8 in a __m128i,
+// 16 in a __m256i. The partial accesses go through a general purpose register (no stack
+// round trip, no read or write past the n values).
+
+/// n <= 4 values of 16 bits in the low bits of an integer, the others 0
+inline uint64_t gatherBits16(const uint16_t* p, size_t n) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < n; i++) {
+        bits |= static_cast<uint64_t>(p[i]) << (16 * i);
+    }
+    return bits;
+}
+
+inline void scatterBits16(uint16_t* p, uint64_t bits, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        p[i] = static_cast<uint16_t>(bits >> (16 * i));
+    }
+}
+
+template <size_t W>
+struct Lanes16;
+
+template <>
+struct Lanes16<4> {
+    using type = __m128i;
+    static inline type load(const uint16_t* p) { return _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)); }
+    static inline void store(uint16_t* p, type x) { _mm_storel_epi64(reinterpret_cast<__m128i*>(p), x); }
+    static inline type loadFirst(const uint16_t* p, size_t n) {
+        return _mm_cvtsi64_si128(static_cast<long long>(gatherBits16(p, n)));
+    }
+    static inline void storeFirst(uint16_t* p, type x, size_t n) {
+        scatterBits16(p, static_cast<uint64_t>(_mm_cvtsi128_si64(x)), n);
+    }
+};
+
+template <>
+struct Lanes16<8> {
+    using type = __m128i;
+    static inline type load(const uint16_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static inline void store(uint16_t* p, type x) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), x); }
+    static inline type loadFirst(const uint16_t* p, size_t n) {
+        if (n >= 4) {
+            return _mm_unpacklo_epi64(Lanes16<4>::load(p), Lanes16<4>::loadFirst(p + 4, n - 4));
+        }
+        return Lanes16<4>::loadFirst(p, n);
+    }
+    static inline void storeFirst(uint16_t* p, type x, size_t n) {
+        if (n >= 4) {
+            Lanes16<4>::store(p, x);
+            Lanes16<4>::storeFirst(p + 4, _mm_unpackhi_epi64(x, x), n - 4);
+        } else {
+            Lanes16<4>::storeFirst(p, x, n);
+        }
+    }
+};
+
+#if defined(__AVX__)
+template <>
+struct Lanes16<16> {
+    using type = __m256i;
+    static inline type load(const uint16_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static inline void store(uint16_t* p, type x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+    static inline type loadFirst(const uint16_t* p, size_t n) {
+        if (n >= 8) {
+            return _mm256_set_m128i(Lanes16<8>::loadFirst(p + 8, n - 8), Lanes16<8>::load(p));
+        }
+        return _mm256_set_m128i(_mm_setzero_si128(), Lanes16<8>::loadFirst(p, n));
+    }
+    static inline void storeFirst(uint16_t* p, type x, size_t n) {
+        if (n >= 8) {
+            Lanes16<8>::store(p, _mm256_castsi256_si128(x));
+            Lanes16<8>::storeFirst(p + 8, _mm256_extractf128_si256(x, 1), n - 8);
+        } else {
+            Lanes16<8>::storeFirst(p, _mm256_castsi256_si128(x), n);
+        }
+    }
+};
+#endif
+
+//* ------------------ conversions of packets ------------------ *//
+
+/// float lanes <-> 16 bits lanes, for each storage type and float backend
+template <typename T, typename F>
+struct Float16Convert;
+
+#if defined(__F16C__)
+template <>
+struct Float16Convert<float16_t, SseFloat> {
+    static inline __m128 widen(__m128i x) { return _mm_cvtph_ps(x); }
+    static inline __m128i narrow(__m128 x) { return _mm_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT); }
+};
+
+template <>
+struct Float16Convert<float16_t, AvxFloat> {
+    static inline __m256 widen(__m128i x) { return _mm256_cvtph_ps(x); }
+    static inline __m128i narrow(__m256 x) { return _mm256_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT); }
+};
+
+#if defined(__AVX512F__)
+// the zero masked forms of the AVX-512 conversions and shifts (the plain ones warn with GCC 12)
+template <>
+struct Float16Convert<float16_t, Avx512Float> {
+    static inline __m512 widen(__m256i x) { return _mm512_maskz_cvtph_ps(0xFFFF, x); }
+    static inline __m256i narrow(__m512 x) { return _mm512_maskz_cvtps_ph(0xFFFF, x, _MM_FROUND_TO_NEAREST_INT); }
+};
+#endif
+#endif // __F16C__
+
+template <>
+struct Float16Convert<bfloat16_t, SseFloat> {
+    static inline __m128 widen(__m128i x) { return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), x)); }
+
+    /// 4 floats to bfloat16 (rounded to nearest even, nan kept quiet) in the low 64 bits
+    static inline __m128i narrow(__m128 x) {
+        const __m128i bits = _mm_castps_si128(x);
+        const __m128i high = _mm_srli_epi32(bits, 16);
+        const __m128i odd = _mm_and_si128(high, _mm_set1_epi32(1));
+        const __m128i rounded = _mm_srli_epi32(_mm_add_epi32(bits, _mm_add_epi32(_mm_set1_epi32(0x7FFF), odd)), 16);
+        const __m128i nan = _mm_castps_si128(_mm_cmpunord_ps(x, x));
+        const __m128i quiet = _mm_or_si128(high, _mm_set1_epi32(0x40));
+        const __m128i result = _mm_or_si128(_mm_and_si128(nan, quiet), _mm_andnot_si128(nan, rounded));
+        // sign extension of the 16 bits, so the signed saturation of the pack keeps them
+        return _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(result, 16), 16), _mm_setzero_si128());
+    }
+};
+
+#if defined(__AVX__)
+template <>
+struct Float16Convert<bfloat16_t, AvxFloat> {
+    static inline __m256 widen(__m128i x) {
+        const __m128i low = _mm_unpacklo_epi16(_mm_setzero_si128(), x);
+        const __m128i high = _mm_unpackhi_epi16(_mm_setzero_si128(), x);
+        return _mm256_castsi256_ps(_mm256_set_m128i(high, low));
+    }
+
+    static inline __m128i narrow(__m256 x) {
+        using Sse = Float16Convert<bfloat16_t, SseFloat>;
+        return _mm_unpacklo_epi64(Sse::narrow(_mm256_castps256_ps128(x)), Sse::narrow(_mm256_extractf128_ps(x, 1)));
+    }
+};
+#endif
+
+#if defined(__AVX512F__)
+template <>
+struct Float16Convert<bfloat16_t, Avx512Float> {
+    static inline __m512 widen(__m256i x) { return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, _mm512_maskz_cvtepu16_epi32(0xFFFF, x), 16)); }
+
+    static inline __m256i narrow(__m512 x) {
+        const __m512i bits = _mm512_castps_si512(x);
+        const __m512i high = _mm512_maskz_srli_epi32(0xFFFF, bits, 16);
+        const __m512i odd = _mm512_and_si512(high, _mm512_set1_epi32(1));
+        const __m512i rounded = _mm512_maskz_srli_epi32(0xFFFF, _mm512_add_epi32(bits, _mm512_add_epi32(_mm512_set1_epi32(0x7FFF), odd)), 16);
+        const __mmask16 nan = _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+        const __m512i result = _mm512_mask_mov_epi32(rounded, nan, _mm512_or_si512(high, _mm512_set1_epi32(0x40)));
+        return _mm512_maskz_cvtepi32_epi16(0xFFFF, result);
+    }
+};
+#endif
+
+/**
+ * @brief packet backend of the 16 bits floats: the float backend F with loads and stores
+ * converting T (F16C for float16_t, integer shifts for bfloat16_t). Every operation is
+ * computed on the float lanes; hsum returns a float.
+ */
+template <typename T, typename F>
+struct Float16Packet : F {
+    using value_type = T;
+    using ComputePacket = F;
+    using typename F::type;
+    using F::width;
+private:
+    using Lanes = Lanes16<F::width>;
+    using Convert = Float16Convert<T, F>;
+
+    static inline const uint16_t* bitsOf(const T* p) { return reinterpret_cast<const uint16_t*>(p); }
+    static inline uint16_t* bitsOf(T* p) { return reinterpret_cast<uint16_t*>(p); }
+public:
+    static inline type load(const T* p) { return Convert::widen(Lanes::load(bitsOf(p))); }
+    static inline void store(T* p, type x) { Lanes::store(bitsOf(p), Convert::narrow(x)); }
+    static inline type loadFirst(const T* p, size_t n) { return Convert::widen(Lanes::loadFirst(bitsOf(p), n)); }
+    static inline void storeFirst(T* p, type x, size_t n) { Lanes::storeFirst(bitsOf(p), Convert::narrow(x), n); }
+};
+
+template <typename T, typename F, typename = void>
+constexpr bool hasFloat16Convert = false;
+
+template <typename T, typename F>
+constexpr bool hasFloat16Convert<T, F, std::void_t<decltype(sizeof(Float16Convert<T, F>))>> = true;
+
+/// the float backend of Vector<float, N> when it converts T, void otherwise
+template <typename T, size_t N>
+using Float16PacketFor = std::conditional_t<hasFloat16Convert<T, FloatPacket<N>>, Float16Packet<T, FloatPacket<N>>, void>;
+
+template <size_t N>
+struct PacketSelector<float16_t, N> {
+    using type = Float16PacketFor<float16_t, N>;
+};
+
+template <size_t N>
+struct PacketSelector<bfloat16_t, N> {
+    using type = Float16PacketFor<bfloat16_t, N>;
+};
+
+#endif // VECTORND_SIMD
+
+} // namespace simd
+
+//* ------------------ batched conversions ------------------ *//
+
+/// number of elements converted by a task of the batched conversions
+constexpr size_t float16ConversionBlock = 16384;
+
+/**
+ * @brief out[i] = in[i] for i in [0, n), between float and float16_t or bfloat16_t (and
+ * between the 2 sides of any other implicit conversion), with the widest packets and in
+ * parallel for long arrays
+ *
+ * @param in
+ * @param out
+ * @param n
+ */
+template <typename From, typename To>
+void convert(const From* in, To* out, size_t n);
+
+/**
+ * @brief converts an array of vectors (Vector<float, N> to Vector<float16_t, N>...)
+ *
+ * @param in
+ * @param out
+ * @param count the number of vectors
+ */
+template <typename From, typename To, size_t N>
+void convert(const Vector<From, N>* in, Vector<To, N>* out, size_t count) {
+    static_assert(hasArrayLayout<From, N> && hasArrayLayout<To, N>, "the vectors must have the layout of arrays");
+    if (count == 0) {
+        return;
+    }
+    convert(in->cbegin(), out->begin(), count * N);
+}
+
+/**
+ * @brief converted copy of vectors: convert<float16_t>(vectors) for the storage of float
+ * vectors, convert<float>(halfVectors) to compute on them
+ *
+ * @tparam To the element type of the result
+ * @param vectors
+ * @return std::vector<Vector<To, N>>
+ */
+template <typename To, typename From, size_t N>
+std::vector<Vector<To, N>> convert(const std::vector<Vector<From, N>>& vectors) {
+    std::vector<Vector<To, N>> out(vectors.size());
+    convert(vectors.data(), out.data(), vectors.size());
+    return out;
+}
+
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+/// true for float16_t and bfloat16_t
+template <typename T>
+constexpr bool isFloat16 = std::is_same_v<T, float16_t> || std::is_same_v<T, bfloat16_t>;
+
+/// out[i] = in[i] for i in [0, n) on a single thread
+template <typename From, typename To>
+inline void convertBlock(const From* in, To* out, size_t n) {
+    size_t i = 0;
+    // the packet of the 16 bits side: its float lanes are read or written as float
+    using H = std::conditional_t<std::is_same_v<From, float>, To, From>;
+    if constexpr ((std::is_same_v<From, float> || std::is_same_v<To, float>) && simd::hasPacket<H, 64>) {
+        using P = simd::PacketFor<H, 64>;
+        using F = simd::ComputePacket<P>;
+        using In = std::conditional_t<std::is_same_v<From, float>, F, P>;
+        using Out = std::conditional_t<std::is_same_v<From, float>, P, F>;
+        for (; i + P::width <= n; i += P::width) {
+            Out::store(out + i, In::load(in + i));
+        }
+        if (i < n) {
+            Out::storeFirst(out + i, In::loadFirst(in + i, n - i), n - i);
+            return;
+        }
+    }
+    for (; i < n; i++) {
+        // the 16 bits types convert from and to float
+        if constexpr (isFloat16<From> || isFloat16<To>) {
+            out[i] = static_cast<To>(static_cast<float>(in[i]));
+        } else {
+            out[i] = static_cast<To>(in[i]);
+        }
+    }
+}
+
+} // namespace detail
+
+template <typename From, typename To>
+void convert(const From* in, To* out, size_t n) {
+    constexpr size_t B = float16ConversionBlock;
+    if (n <= B) {
+        detail::convertBlock(in, out, n);
+        return;
+    }
+    const size_t blocks = (n + B - 1) / B;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * B;
+        detail::convertBlock(in + begin, out + begin, std::min(B, n - begin));
+    }
+}
+
+}
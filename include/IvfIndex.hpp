@@ -0,0 +1,434 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max, std::fill
+#include <cstdint>
+#include <cstring> // memcpy, memcmp
+#include <fstream>
+#include <limits>
+#include <numeric> // std::iota
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility> // std::swap, std::move
+#include <vector>
+
+#include "Vector.hpp"
+#include "TopK.hpp"
+#include "KMeans.hpp"
+#include "Parallel.hpp"
+#include "PointFile.hpp" // PointElement
+
+namespace VectorND {
+
+/**
+ * @brief approximate k-nearest-neighbor search with an inverted file (IVF).
+ *
+ * train() clusters a sample of the dataset with KMeans into lists() coarse centroids.
+ * add() assigns each vector to its closest centroid: the vectors of a list are stored
+ * contiguously, the lists one after the other. search() computes the distances of the query
+ * to the centroids and scans only the nprobe closest lists: about nprobe / lists() of the
+ * dataset. nprobe == lists() gives the exact result.
+ *
+ * Distances are squared distances (Vector::squaredDist). The indices of the results are
+ * the ids given to add() (by default the order of insertion).
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class IvfIndex
+{
+private:
+    std::vector<Vector<T, N>> centroids;
+    // vectors of the list l at [offsets[l], offsets[l + 1]), and their ids
+    std::vector<size_t> offsets;
+    std::vector<Vector<T, N>> vectors;
+    std::vector<size_t> ids;
+
+    // number of training vectors sampled per list
+    static constexpr size_t trainingSamplesPerList = 256;
+    // number of queries of a task
+    static constexpr size_t queryBlock = 4;
+
+    // index of the closest centroid
+    size_t closestList(const Vector<T, N>& vector) const;
+
+    // the nprobe closest lists of the query
+    void probe(const Vector<T, N>& query, size_t nprobe, std::vector<size_t>& lists) const;
+
+    // the k nearest of the query in the nprobe closest lists, into heap
+    void searchLists(const Vector<T, N>& query, size_t nprobe, TopK<T>& heap, std::vector<size_t>& lists) const;
+public:
+    /// index of a missing neighbor (less than k vectors in the probed lists)
+    static constexpr size_t noNeighbor = std::numeric_limits<size_t>::max();
+
+    IvfIndex() = default;
+
+    /**
+     * @brief an index of nlist lists, to train
+     *
+     * @param nlist number of lists (about sqrt(dataset size) is a common choice)
+     * @throw std::invalid_argument if nlist is 0
+     */
+    explicit IvfIndex(size_t nlist);
+
+    /// number of lists
+    inline size_t lists() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    /// number of vectors added
+    inline size_t size() const noexcept { return vectors.size(); }
+
+    /// whether the centroids are trained
+    inline bool trained() const noexcept { return !centroids.empty(); }
+
+    /// number of vectors of the list l
+    inline size_t listSize(size_t l) const { return offsets[l + 1] - offsets[l]; }
+
+    /// centroid of the list l
+    inline const Vector<T, N>& centroid(size_t l) const { return centroids[l]; }
+
+    /**
+     * @brief compute the centroids with KMeans on a sample of the points (at most 256 per
+     * list), the vectors added before are removed
+     *
+     * @param points
+     * @param count at least lists()
+     * @param iterations maximum number of k-means iterations
+     * @param seed of the sampling and of the k-means++ seeding
+     * @throw std::invalid_argument if there are less points than lists
+     */
+    void train(const Vector<T, N>* points, size_t count, size_t iterations = 16, uint64_t seed = 1);
+
+    void train(const std::vector<Vector<T, N>>& points, size_t iterations = 16, uint64_t seed = 1) {
+        train(points.data(), points.size(), iterations, seed);
+    }
+
+    /**
+     * @brief add vectors to their lists (the lists are rebuilt: add large batches)
+     *
+     * @param points
+     * @param count
+     * @param pointIds id of each vector in the results, size(), size() + 1... if null
+     * @throw std::logic_error if the index is not trained
+     */
+    void add(const Vector<T, N>* points, size_t count, const size_t* pointIds = nullptr);
+
+    void add(const std::vector<Vector<T, N>>& points) { add(points.data(), points.size()); }
+
+    /**
+     * @brief the k nearest vectors of the query in its nprobe closest lists, sorted by
+     * increasing squared distance (less than k if the lists hold less vectors)
+     *
+     * @param query
+     * @param k number of neighbors
+     * @param nprobe number of lists scanned (at most lists())
+     * @return std::vector<Neighbor<T>> ids and squared distances
+     */
+    std::vector<Neighbor<T>> search(const Vector<T, N>& query, size_t k, size_t nprobe = 1) const;
+
+    /**
+     * @brief search of a batch of queries, in parallel. k is min(k, size()), the missing
+     * neighbors have the index noNeighbor and the largest distance.
+     *
+     * @param queries m vectors
+     * @param m number of queries
+     * @param k number of neighbors
+     * @param nprobe number of lists scanned per query
+     * @return KnnResult<T>
+     */
+    KnnResult<T> search(const Vector<T, N>* queries, size_t m, size_t k, size_t nprobe = 1) const;
+
+    KnnResult<T> search(const std::vector<Vector<T, N>>& queries, size_t k, size_t nprobe = 1) const {
+        return search(queries.data(), queries.size(), k, nprobe);
+    }
+
+    /**
+     * @brief write the index to a binary file (native byte order), replaced if it exists
+     *
+     * @param path
+     * @throw std::runtime_error if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief read an index written by save()
+     *
+     * @param path
+     * @return IvfIndex
+     * @throw std::runtime_error if the file cannot be read or holds another index type
+     */
+    static IvfIndex load(const std::string& path);
+};
+
+/// header of an index file
+struct IvfFileHeader {
+    char magic[8];
+    uint32_t version;
+    // 0x01020304 in the byte order of the writer
+    uint32_t byteOrder;
+    // PointElement<T>::code and sizeof(T)
+    uint32_t elementType;
+    uint32_t elementSize;
+    uint64_t dimension;
+    uint64_t lists;
+    uint64_t count;
+};
+static_assert(sizeof(IvfFileHeader) == 48, "the header must not have padding");
+
+constexpr char ivfFileMagic[8] = {'V', 'N', 'D', 'I', 'V', 'F', 0, 0};
+constexpr uint32_t ivfFileVersion = 1;
+
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+[[noreturn]] inline void ivfFileError(const std::string& path, const std::string& problem) {
+    throw std::runtime_error("VectorND: " + path + ": " + problem);
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+IvfIndex<T, N>::IvfIndex(size_t nlist) {
+    if (nlist == 0) {
+        throw std::invalid_argument("VectorND: an IvfIndex needs at least 1 list");
+    }
+    offsets.assign(nlist + 1, 0);
+}
+
+template <typename T, size_t N>
+void IvfIndex<T, N>::train(const Vector<T, N>* points, size_t count, size_t iterations, uint64_t seed) {
+    const size_t nlist = lists();
+    if (count < nlist || nlist == 0) {
+        throw std::invalid_argument("VectorND: " + std::to_string(count) + " points cannot train " +
+                                    std::to_string(nlist) + " lists");
+    }
+    // random sample of the points
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(seed);
+    const size_t samples = std::min(count, nlist * trainingSamplesPerList);
+    for (size_t i = 0; i < samples; i++) {
+        std::swap(order[i], order[i + std::uniform_int_distribution<size_t>(0, count - 1 - i)(rng)]);
+    }
+    std::vector<Vector<T, N>> sample(samples);
+    for (size_t i = 0; i < samples; i++) {
+        sample[i] = points[order[i]];
+    }
+    KMeans<T, N> kmeans(nlist, KMeansAlgorithm::Hamerly, seed);
+    kmeans.fit(sample, iterations);
+    centroids = kmeans.centroids();
+
+    std::fill(offsets.begin(), offsets.end(), 0);
+    vectors.clear();
+    ids.clear();
+}
+
+template <typename T, size_t N>
+size_t IvfIndex<T, N>::closestList(const Vector<T, N>& vector) const {
+    size_t best = 0;
+    T bestDistance = std::numeric_limits<T>::max();
+    for (size_t l = 0; l < centroids.size(); l++) {
+        const T distance = static_cast<T>(vector.squaredDist(centroids[l]));
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = l;
+        }
+    }
+    return best;
+}
+
+// counting sort of the old and new vectors by list
+
+template <typename T, size_t N>
+void IvfIndex<T, N>::add(const Vector<T, N>* points, size_t count, const size_t* pointIds) {
+    if (!trained()) {
+        throw std::logic_error("VectorND: the IvfIndex must be trained before add()");
+    }
+    const size_t nlist = lists();
+    std::vector<size_t> assignment(count);
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        assignment[i] = closestList(points[i]);
+    }
+
+    std::vector<size_t> newOffsets(nlist + 1, 0);
+    for (size_t l = 0; l < nlist; l++) {
+        newOffsets[l + 1] = listSize(l);
+    }
+    for (size_t i = 0; i < count; i++) {
+        newOffsets[assignment[i] + 1]++;
+    }
+    for (size_t l = 0; l < nlist; l++) {
+        newOffsets[l + 1] += newOffsets[l];
+    }
+
+    std::vector<Vector<T, N>> newVectors(vectors.size() + count);
+    std::vector<size_t> newIds(newVectors.size());
+    std::vector<size_t> next(newOffsets.begin(), newOffsets.end() - 1);
+    for (size_t l = 0; l < nlist; l++) {
+        std::copy(vectors.begin() + offsets[l], vectors.begin() + offsets[l + 1], newVectors.begin() + next[l]);
+        std::copy(ids.begin() + offsets[l], ids.begin() + offsets[l + 1], newIds.begin() + next[l]);
+        next[l] += listSize(l);
+    }
+    const size_t firstId = vectors.size();
+    for (size_t i = 0; i < count; i++) {
+        const size_t slot = next[assignment[i]]++;
+        newVectors[slot] = points[i];
+        newIds[slot] = pointIds ? pointIds[i] : firstId + i;
+    }
+    offsets = std::move(newOffsets);
+    vectors = std::move(newVectors);
+    ids = std::move(newIds);
+}
+
+template <typename T, size_t N>
+void IvfIndex<T, N>::probe(const Vector<T, N>& query, size_t nprobe, std::vector<size_t>& lists) const {
+    TopK<T> closest(std::min(nprobe, centroids.size()));
+    for (size_t l = 0; l < centroids.size(); l++) {
+        closest.push(static_cast<T>(query.squaredDist(centroids[l])), l);
+    }
+    lists.resize(closest.size());
+    std::vector<T> distances(closest.size());
+    closest.extractSorted(distances.data(), lists.data());
+}
+
+template <typename T, size_t N>
+void IvfIndex<T, N>::searchLists(const Vector<T, N>& query, size_t nprobe, TopK<T>& heap, std::vector<size_t>& lists) const {
+    if (!trained()) {
+        throw std::logic_error("VectorND: the IvfIndex must be trained before search()");
+    }
+    probe(query, nprobe, lists);
+    for (size_t l : lists) {
+        for (size_t i = offsets[l]; i < offsets[l + 1]; i++) {
+            heap.push(static_cast<T>(query.squaredDist(vectors[i])), ids[i]);
+        }
+    }
+}
+
+template <typename T, size_t N>
+std::vector<Neighbor<T>> IvfIndex<T, N>::search(const Vector<T, N>& query, size_t k, size_t nprobe) const {
+    TopK<T> heap(k);
+    std::vector<size_t> lists;
+    searchLists(query, nprobe, heap, lists);
+    return heap.extractSorted();
+}
+
+template <typename T, size_t N>
+KnnResult<T> IvfIndex<T, N>::search(const Vector<T, N>* queries, size_t m, size_t k, size_t nprobe) const {
+    if (!trained()) {
+        throw std::logic_error("VectorND: the IvfIndex must be trained before search()");
+    }
+    KnnResult<T> result;
+    result.k = std::min(k, size());
+    result.indices.assign(m * result.k, noNeighbor);
+    result.distances.assign(m * result.k, std::numeric_limits<T>::max());
+    if (m == 0 || result.k == 0) {
+        return result;
+    }
+    const size_t kk = result.k;
+    const size_t blocks = (m + queryBlock - 1) / queryBlock;
+
+    VECTORND_OMP(parallel for schedule(dynamic))
+    for (size_t block = 0; block < blocks; block++) {
+        TopK<T> heap(kk);
+        std::vector<size_t> lists;
+        for (size_t q = block * queryBlock; q < std::min(m, (block + 1) * queryBlock); q++) {
+            searchLists(queries[q], nprobe, heap, lists);
+            heap.extractSorted(&result.distances[q * kk], &result.indices[q * kk]);
+        }
+    }
+    return result;
+}
+
+// file: header, centroids, lists() + 1 offsets, ids, vectors (offsets and ids in uint64_t)
+
+template <typename T, size_t N>
+void IvfIndex<T, N>::save(const std::string& path) const {
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+    IvfFileHeader header{};
+    std::memcpy(header.magic, ivfFileMagic, sizeof(ivfFileMagic));
+    header.version = ivfFileVersion;
+    header.byteOrder = 0x01020304;
+    header.elementType = PointElement<T>::code;
+    header.elementSize = static_cast<uint32_t>(sizeof(T));
+    header.dimension = N;
+    header.lists = lists();
+    header.count = size();
+
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        detail::ivfFileError(path, "cannot be created");
+    }
+    const std::vector<uint64_t> fileOffsets(offsets.begin(), offsets.end());
+    const std::vector<uint64_t> fileIds(ids.begin(), ids.end());
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    stream.write(reinterpret_cast<const char*>(centroids.data()), static_cast<std::streamsize>(centroids.size() * sizeof(Vector<T, N>)));
+    stream.write(reinterpret_cast<const char*>(fileOffsets.data()), static_cast<std::streamsize>(fileOffsets.size() * sizeof(uint64_t)));
+    stream.write(reinterpret_cast<const char*>(fileIds.data()), static_cast<std::streamsize>(fileIds.size() * sizeof(uint64_t)));
+    stream.write(reinterpret_cast<const char*>(vectors.data()), static_cast<std::streamsize>(vectors.size() * sizeof(Vector<T, N>)));
+    if (!stream.flush()) {
+        detail::ivfFileError(path, "write failed");
+    }
+}
+
+template <typename T, size_t N>
+IvfIndex<T, N> IvfIndex<T, N>::load(const std::string& path) {
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        detail::ivfFileError(path, "cannot be opened");
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(stream.tellg());
+    stream.seekg(0);
+    IvfFileHeader header{};
+    if (fileSize < sizeof(header) || !stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, ivfFileMagic, sizeof(ivfFileMagic)) != 0) {
+        detail::ivfFileError(path, "not an IvfIndex file");
+    }
+    if (header.version != ivfFileVersion) {
+        detail::ivfFileError(path, "unsupported version " + std::to_string(header.version));
+    }
+    if (header.byteOrder != 0x01020304) {
+        detail::ivfFileError(path, "written with another byte order");
+    }
+    if (header.elementType != PointElement<T>::code || header.elementSize != sizeof(T) || header.dimension != N) {
+        detail::ivfFileError(path, "holds vectors of " + std::to_string(header.dimension) + " elements of type " +
+                                   std::to_string(header.elementType) + ", not of the requested type");
+    }
+    // sizes compared without overflow
+    const uint64_t available = fileSize - sizeof(header);
+    const uint64_t vectorBytes = sizeof(Vector<T, N>);
+    if (header.lists == 0 || header.lists > available / (vectorBytes + sizeof(uint64_t)) ||
+        header.count > available / (vectorBytes + sizeof(uint64_t)) ||
+        (header.lists + header.count) * (vectorBytes + sizeof(uint64_t)) + sizeof(uint64_t) != available) {
+        detail::ivfFileError(path, "truncated");
+    }
+
+    IvfIndex index(static_cast<size_t>(header.lists));
+    index.centroids.resize(header.lists);
+    std::vector<uint64_t> fileOffsets(header.lists + 1);
+    std::vector<uint64_t> fileIds(header.count);
+    index.vectors.resize(header.count);
+    stream.read(reinterpret_cast<char*>(index.centroids.data()), static_cast<std::streamsize>(header.lists * vectorBytes));
+    stream.read(reinterpret_cast<char*>(fileOffsets.data()), static_cast<std::streamsize>(fileOffsets.size() * sizeof(uint64_t)));
+    stream.read(reinterpret_cast<char*>(fileIds.data()), static_cast<std::streamsize>(fileIds.size() * sizeof(uint64_t)));
+    stream.read(reinterpret_cast<char*>(index.vectors.data()), static_cast<std::streamsize>(header.count * vectorBytes));
+    if (!stream) {
+        detail::ivfFileError(path, "read failed");
+    }
+    for (size_t l = 0; l < header.lists; l++) {
+        if (fileOffsets[l] > fileOffsets[l + 1]) {
+            detail::ivfFileError(path, "invalid lists");
+        }
+    }
+    if (fileOffsets.front() != 0 || fileOffsets.back() != header.count) {
+        detail::ivfFileError(path, "invalid lists");
+    }
+    index.offsets.assign(fileOffsets.begin(), fileOffsets.end());
+    index.ids.assign(fileIds.begin(), fileIds.end());
+    return index;
+}
+
+}
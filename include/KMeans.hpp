@@ -0,0 +1,453 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max, std::fill, std::upper_bound
+#include <cmath> // std::sqrt
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/// assignment step of KMeans::fit
+enum class KMeansAlgorithm {
+    /// distances to every centroid at each iteration
+    Lloyd,
+    /// Hamerly's bounds: a point is only compared to every centroid when the triangle
+    /// inequality cannot prove that its centroid is still the closest (same result as Lloyd)
+    Hamerly
+};
+
+/**
+ * @brief k-means clustering of Vector<T, N>.
+ *
+ * fit() seeds the centroids with k-means++ and runs Lloyd iterations until no point changes
+ * of cluster. The assignments are computed in parallel; the new centroids are the means of
+ * the clusters, summed in double in a buffer per thread and then reduced. An empty cluster
+ * takes the point farthest from its centroid.
+ *
+ * partialFit() is the mini-batch k-means of Sculley (2010) for streamed data: each batch
+ * moves the centroids towards the mean of its points, weighted by the number of points
+ * seen by each centroid.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class KMeans
+{
+private:
+    using Sum = Vector<double, N>;
+
+    size_t k;
+    KMeansAlgorithm algorithm;
+    std::mt19937_64 rng;
+
+    std::vector<Vector<T, N>> centers;
+    std::vector<size_t> pointLabels;
+    // points seen by each centroid (partialFit)
+    std::vector<double> weights;
+    double pointsInertia{0};
+    size_t iterationCount{0};
+    size_t distanceCounter{0};
+
+    // per thread: k sums and k counts
+    std::vector<Sum> threadSums;
+    std::vector<size_t> threadCounts;
+
+    void seed(const Vector<T, N>* points, size_t count);
+
+    // sums and counts of the clusters of the labels, reduced into the first k of the buffers
+    void accumulate(const Vector<T, N>* points, size_t count, const size_t* labels);
+
+    // means of the clusters, an empty one takes the point of largest distance
+    void updateCentroids(const Vector<T, N>* points, const double* distances);
+
+    size_t lloyd(const Vector<T, N>* points, size_t count, size_t maxIterations);
+    size_t hamerly(const Vector<T, N>* points, size_t count, size_t maxIterations);
+public:
+    /**
+     * @brief k clusters to find
+     *
+     * @param k number of clusters
+     * @param algorithm of the assignment step (same result, Hamerly skips most distances)
+     * @param seed of the k-means++ seeding
+     * @throw std::invalid_argument if k is 0
+     */
+    explicit KMeans(size_t k, KMeansAlgorithm algorithm = KMeansAlgorithm::Hamerly, uint64_t seed = 1);
+
+    /// number of clusters
+    inline size_t clusters() const noexcept { return k; }
+
+    /// the centroids (empty before the first fit)
+    inline const std::vector<Vector<T, N>>& centroids() const noexcept { return centers; }
+
+    /// cluster of each point of the last fit()
+    inline const std::vector<size_t>& labels() const noexcept { return pointLabels; }
+
+    /// sum of the squared distances of the points of the last fit() to their centroid
+    inline double inertia() const noexcept { return pointsInertia; }
+
+    /// iterations of the last fit()
+    inline size_t iterations() const noexcept { return iterationCount; }
+
+    /// distances computed by the last fit(), seeding included
+    inline size_t distanceCount() const noexcept { return distanceCounter; }
+
+    /**
+     * @brief cluster the points (the previous centroids are dropped)
+     *
+     * @param points
+     * @param count at least clusters()
+     * @param maxIterations
+     * @return size_t the number of iterations
+     * @throw std::invalid_argument if there are less points than clusters
+     */
+    size_t fit(const Vector<T, N>* points, size_t count, size_t maxIterations = 100);
+
+    size_t fit(const std::vector<Vector<T, N>>& points, size_t maxIterations = 100) {
+        return fit(points.data(), points.size(), maxIterations);
+    }
+
+    /**
+     * @brief mini-batch update with a batch of points (the first batch seeds the centroids
+     * with k-means++ and must hold at least clusters() points)
+     *
+     * @param batch
+     * @param count
+     * @throw std::invalid_argument if the first batch has less points than clusters
+     */
+    void partialFit(const Vector<T, N>* batch, size_t count);
+
+    void partialFit(const std::vector<Vector<T, N>>& batch) { partialFit(batch.data(), batch.size()); }
+
+    /**
+     * @brief cluster of the closest centroid
+     *
+     * @param point
+     * @return size_t
+     * @throw std::logic_error before fit() or partialFit()
+     */
+    size_t predict(const Vector<T, N>& point) const;
+
+    /**
+     * @brief clusters of the closest centroids, in parallel
+     *
+     * @param points
+     * @param count
+     * @param labels count values
+     * @throw std::logic_error before fit() or partialFit()
+     */
+    void predict(const Vector<T, N>* points, size_t count, size_t* labels) const;
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+// closest centroid and its squared distance
+template <typename T, size_t N>
+inline size_t closestCentroid(const Vector<T, N>& point, const std::vector<Vector<T, N>>& centroids, double& best) {
+    size_t label = 0;
+    best = std::numeric_limits<double>::max();
+    for (size_t c = 0; c < centroids.size(); c++) {
+        const double distance = point.squaredDist(centroids[c]);
+        if (distance < best) {
+            best = distance;
+            label = c;
+        }
+    }
+    return label;
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+KMeans<T, N>::KMeans(size_t k, KMeansAlgorithm algorithm, uint64_t seed): k{k}, algorithm{algorithm}, rng{seed} {
+    if (k == 0) {
+        throw std::invalid_argument("VectorND: KMeans needs at least 1 cluster");
+    }
+}
+
+// k-means++: each new centroid is a point drawn with a probability proportional to its
+// squared distance to the closest centroid so far
+
+template <typename T, size_t N>
+void KMeans<T, N>::seed(const Vector<T, N>* points, size_t count) {
+    if (count < k) {
+        throw std::invalid_argument("VectorND: " + std::to_string(count) + " points cannot make " +
+                                    std::to_string(k) + " clusters");
+    }
+    centers.assign(1, points[std::uniform_int_distribution<size_t>(0, count - 1)(rng)]);
+    std::vector<double> closest(count, std::numeric_limits<double>::max());
+    std::vector<double> cumulative(count);
+    for (size_t c = 1; c < k; c++) {
+        const Vector<T, N>& last = centers.back();
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t i = 0; i < count; i++) {
+            closest[i] = std::min(closest[i], points[i].squaredDist(last));
+        }
+        double total = 0;
+        for (size_t i = 0; i < count; i++) {
+            total += closest[i];
+            cumulative[i] = total;
+        }
+        size_t chosen;
+        if (total > 0) {
+            const double draw = std::uniform_real_distribution<double>(0, total)(rng);
+            chosen = std::min(count - 1, static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), draw) -
+                                                             cumulative.begin()));
+        } else {
+            // fewer distinct points than clusters
+            chosen = std::uniform_int_distribution<size_t>(0, count - 1)(rng);
+        }
+        centers.push_back(points[chosen]);
+    }
+    distanceCounter += count * (k - 1);
+}
+
+template <typename T, size_t N>
+void KMeans<T, N>::accumulate(const Vector<T, N>* points, size_t count, const size_t* labels) {
+    const size_t threads = parallel::threadCount();
+    threadSums.assign(threads * k, Sum());
+    threadCounts.assign(threads * k, 0);
+    VECTORND_OMP(parallel)
+    {
+        Sum* sums = &threadSums[parallel::threadIndex() * k];
+        size_t* counts = &threadCounts[parallel::threadIndex() * k];
+        VECTORND_OMP(for schedule(static))
+        for (size_t i = 0; i < count; i++) {
+            sums[labels[i]] += static_cast<Sum>(points[i]);
+            counts[labels[i]]++;
+        }
+        VECTORND_OMP(for schedule(static))
+        for (size_t c = 0; c < k; c++) {
+            for (size_t t = 1; t < threads; t++) {
+                threadSums[c] += threadSums[t * k + c];
+                threadCounts[c] += threadCounts[t * k + c];
+            }
+        }
+    }
+}
+
+template <typename T, size_t N>
+void KMeans<T, N>::updateCentroids(const Vector<T, N>* points, const double* distances) {
+    const size_t count = pointLabels.size();
+    std::vector<double> candidates;
+    for (size_t c = 0; c < k; c++) {
+        if (threadCounts[c] > 0) {
+            Sum& mean = threadSums[c];
+            mean /= static_cast<double>(threadCounts[c]);
+            centers[c] = static_cast<Vector<T, N>>(mean);
+            continue;
+        }
+        if (candidates.empty()) {
+            candidates.assign(distances, distances + count);
+        }
+        const size_t farthest = static_cast<size_t>(std::max_element(candidates.begin(), candidates.end()) - candidates.begin());
+        centers[c] = points[farthest];
+        candidates[farthest] = -1;
+    }
+}
+
+template <typename T, size_t N>
+size_t KMeans<T, N>::fit(const Vector<T, N>* points, size_t count, size_t maxIterations) {
+    distanceCounter = 0;
+    weights.clear();
+    seed(points, count);
+    pointLabels.assign(count, 0);
+    iterationCount = algorithm == KMeansAlgorithm::Lloyd ? lloyd(points, count, maxIterations)
+                                                         : hamerly(points, count, maxIterations);
+
+    // inertia of the final centroids
+    double total = 0;
+    VECTORND_OMP(parallel for schedule(static) reduction(+ : total))
+    for (size_t i = 0; i < count; i++) {
+        total += points[i].squaredDist(centers[pointLabels[i]]);
+    }
+    pointsInertia = total;
+    weights.assign(k, 0);
+    for (size_t i = 0; i < count; i++) {
+        weights[pointLabels[i]]++;
+    }
+    return iterationCount;
+}
+
+template <typename T, size_t N>
+size_t KMeans<T, N>::lloyd(const Vector<T, N>* points, size_t count, size_t maxIterations) {
+    std::vector<double> distances(count);
+    size_t iteration = 0;
+    while (iteration < maxIterations) {
+        size_t changed = 0;
+        VECTORND_OMP(parallel for schedule(static) reduction(+ : changed))
+        for (size_t i = 0; i < count; i++) {
+            const size_t label = detail::closestCentroid(points[i], centers, distances[i]);
+            changed += iteration == 0 || label != pointLabels[i];
+            pointLabels[i] = label;
+        }
+        distanceCounter += count * k;
+        if (changed == 0) {
+            break;
+        }
+        accumulate(points, count, pointLabels.data());
+        updateCentroids(points, distances.data());
+        iteration++;
+    }
+    return iteration;
+}
+
+// Hamerly: upper[i] bounds the distance of the point to its centroid, lower[i] the distance
+// to every other one. A point keeps its centroid without distance computation when upper[i]
+// is below lower[i] or half the distance of its centroid to the closest other centroid.
+// Moving the centroids by shift[c] loosens the bounds by the shifts.
+
+template <typename T, size_t N>
+size_t KMeans<T, N>::hamerly(const Vector<T, N>* points, size_t count, size_t maxIterations) {
+    std::vector<double> upper(count), lower(count);
+    std::vector<double> halfGap(k), shift(k);
+    std::vector<Vector<T, N>> previous;
+    size_t iteration = 0;
+    size_t distances = 0;
+    while (iteration < maxIterations) {
+        for (size_t c = 0; c < k; c++) {
+            double closest = std::numeric_limits<double>::max();
+            for (size_t o = 0; o < k; o++) {
+                if (o != c) {
+                    closest = std::min(closest, centers[c].squaredDist(centers[o]));
+                }
+            }
+            halfGap[c] = std::sqrt(closest) / 2;
+        }
+        distances += k * (k - 1);
+
+        size_t changed = 0;
+        VECTORND_OMP(parallel for schedule(static) reduction(+ : changed, distances))
+        for (size_t i = 0; i < count; i++) {
+            const size_t label = pointLabels[i];
+            if (iteration > 0) {
+                const double bound = std::max(halfGap[label], lower[i]);
+                if (upper[i] <= bound) {
+                    continue;
+                }
+                upper[i] = points[i].dist(centers[label]);
+                distances++;
+                if (upper[i] <= bound) {
+                    continue;
+                }
+            }
+            // the 2 closest centroids
+            double first = std::numeric_limits<double>::max(), second = first;
+            size_t best = 0;
+            for (size_t c = 0; c < k; c++) {
+                const double distance = points[i].squaredDist(centers[c]);
+                if (distance < first) {
+                    second = first;
+                    first = distance;
+                    best = c;
+                } else if (distance < second) {
+                    second = distance;
+                }
+            }
+            distances += k;
+            changed += iteration == 0 || best != label;
+            pointLabels[i] = best;
+            upper[i] = std::sqrt(first);
+            lower[i] = std::sqrt(second);
+        }
+        if (changed == 0) {
+            break;
+        }
+
+        previous = centers;
+        accumulate(points, count, pointLabels.data());
+        // an empty cluster takes the farthest point: the upper bounds can be loose, use the
+        // exact squared distances, as Lloyd
+        if (std::find(threadCounts.begin(), threadCounts.begin() + k, size_t(0)) != threadCounts.begin() + k) {
+            std::vector<double> exact(count);
+            VECTORND_OMP(parallel for schedule(static))
+            for (size_t i = 0; i < count; i++) {
+                exact[i] = points[i].squaredDist(centers[pointLabels[i]]);
+                upper[i] = std::sqrt(exact[i]);
+            }
+            distances += count;
+            updateCentroids(points, exact.data());
+        } else {
+            updateCentroids(points, upper.data());
+        }
+        double largest = 0, secondLargest = 0;
+        size_t largestCluster = 0;
+        for (size_t c = 0; c < k; c++) {
+            shift[c] = centers[c].dist(previous[c]);
+            if (shift[c] > largest) {
+                secondLargest = largest;
+                largest = shift[c];
+                largestCluster = c;
+            } else if (shift[c] > secondLargest) {
+                secondLargest = shift[c];
+            }
+        }
+        distances += k;
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t i = 0; i < count; i++) {
+            upper[i] += shift[pointLabels[i]];
+            lower[i] -= pointLabels[i] == largestCluster ? secondLargest : largest;
+        }
+        iteration++;
+    }
+    distanceCounter += distances;
+    return iteration;
+}
+
+template <typename T, size_t N>
+void KMeans<T, N>::partialFit(const Vector<T, N>* batch, size_t count) {
+    if (centers.empty()) {
+        distanceCounter = 0;
+        seed(batch, count);
+        weights.assign(k, 0);
+    }
+    std::vector<size_t> labels(count);
+    predict(batch, count, labels.data());
+    distanceCounter += count * k;
+    accumulate(batch, count, labels.data());
+    // running mean of the points seen by each centroid
+    for (size_t c = 0; c < k; c++) {
+        if (threadCounts[c] == 0) {
+            continue;
+        }
+        Sum center = static_cast<Sum>(centers[c]);
+        center *= weights[c];
+        center += threadSums[c];
+        weights[c] += static_cast<double>(threadCounts[c]);
+        center /= weights[c];
+        centers[c] = static_cast<Vector<T, N>>(center);
+    }
+}
+
+template <typename T, size_t N>
+size_t KMeans<T, N>::predict(const Vector<T, N>& point) const {
+    if (centers.empty()) {
+        throw std::logic_error("VectorND: KMeans::predict needs a fit first");
+    }
+    double distance;
+    return detail::closestCentroid(point, centers, distance);
+}
+
+template <typename T, size_t N>
+void KMeans<T, N>::predict(const Vector<T, N>* points, size_t count, size_t* labels) const {
+    if (centers.empty()) {
+        throw std::logic_error("VectorND: KMeans::predict needs a fit first");
+    }
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        double distance;
+        labels[i] = detail::closestCentroid(points[i], centers, distance);
+    }
+}
+
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm> // std::nth_element, std::sort
+#include <cstdint>
+#include <limits>
+#include <numeric> // std::iota
+#include <vector>
+
+#include "Vector.hpp"
+#include "TopK.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief static k-d tree over a set of Vector<T, N>, for nearest, k nearest and radius queries.
+ *
+ * The tree is balanced: each node splits its points at the median of the axis with the
+ * widest spread (std::nth_element). It is stored as a flat array in heap order (children of
+ * node i at 2i + 1 and 2i + 2): the range of points of a node follows from the splits, so a
+ * node only holds its axis and split value. The points are copied in tree order, each leaf
+ * is a contiguous run of at most about leafSize points.
+ *
+ * Distances are squared distances (Vector::squaredDist).
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class KdTree
+{
+private:
+    struct Node {
+        T split;
+        uint32_t axis;
+    };
+
+    // points in tree order, and their index in the input
+    std::vector<Vector<T, N>> points;
+    std::vector<size_t> indices;
+    std::vector<Node> nodes;
+    // number of levels of nodes, the leaves are below
+    size_t depth{0};
+
+    // nodes covering more points are built in a separate task
+    static constexpr size_t parallelBuildSize = 16384;
+
+    // order is a pointer: a reference would be firstprivate in the tasks (copied)
+    void build(size_t node, size_t level, size_t begin, size_t end, size_t* order, const Vector<T, N>* input);
+
+    template <typename Visitor>
+    void search(const Vector<T, N>& query, size_t node, size_t level, size_t begin, size_t end,
+                T& bound, Visitor& visit) const;
+public:
+    /// maximum number of points of a leaf
+    static constexpr size_t leafSize = 16;
+
+    /// index of the nearest point of an empty tree
+    static constexpr size_t noNeighbor = std::numeric_limits<size_t>::max();
+
+    KdTree() = default;
+
+    /**
+     * @brief build the tree over a copy of the points (in parallel)
+     *
+     * @param input
+     * @param count
+     */
+    KdTree(const Vector<T, N>* input, size_t count);
+
+    explicit KdTree(const std::vector<Vector<T, N>>& input): KdTree(input.data(), input.size()) {}
+
+    /// number of points
+    inline size_t size() const noexcept { return points.size(); }
+
+    /**
+     * @brief the nearest point of the query (index noNeighbor and the largest distance if the
+     * tree is empty)
+     *
+     * @param query
+     * @return Neighbor<T> index in the input and squared distance
+     */
+    Neighbor<T> nearest(const Vector<T, N>& query) const;
+
+    /**
+     * @brief the k nearest points of the query, sorted by increasing distance
+     *
+     * @param query
+     * @param k
+     * @return std::vector<Neighbor<T>> min(k, size()) neighbors
+     */
+    std::vector<Neighbor<T>> knn(const Vector<T, N>& query, size_t k) const;
+
+    /**
+     * @brief the points at a distance <= radius of the query, sorted by increasing distance
+     *
+     * @param query
+     * @param radius euclidean distance (not squared)
+     * @return std::vector<Neighbor<T>>
+     */
+    std::vector<Neighbor<T>> radiusSearch(const Vector<T, N>& query, T radius) const;
+
+    /**
+     * @brief k nearest points of a batch of queries (in parallel)
+     *
+     * @param queries m vectors
+     * @param m number of queries
+     * @param k number of neighbors
+     * @return KnnResult<T>
+     */
+    KnnResult<T> knn(const Vector<T, N>* queries, size_t m, size_t k) const;
+
+    KnnResult<T> knn(const std::vector<Vector<T, N>>& queries, size_t k) const {
+        return knn(queries.data(), queries.size(), k);
+    }
+
+    /**
+     * @brief radius search of a batch of queries (in parallel)
+     *
+     * @param queries m vectors
+     * @param m number of queries
+     * @param radius
+     * @return std::vector<std::vector<Neighbor<T>>> the neighbors of each query
+     */
+    std::vector<std::vector<Neighbor<T>>> radiusSearch(const Vector<T, N>* queries, size_t m, T radius) const;
+
+    std::vector<std::vector<Neighbor<T>>> radiusSearch(const std::vector<Vector<T, N>>& queries, T radius) const {
+        return radiusSearch(queries.data(), queries.size(), radius);
+    }
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+KdTree<T, N>::KdTree(const Vector<T, N>* input, size_t count) {
+    while ((count >> depth) > leafSize) {
+        depth++;
+    }
+    nodes.resize((size_t{1} << depth) - 1);
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+
+    VECTORND_OMP(parallel)
+    VECTORND_OMP(single)
+    build(0, 0, 0, count, order.data(), input);
+
+    points.resize(count);
+    indices = std::move(order);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = input[indices[i]];
+    }
+}
+
+template <typename T, size_t N>
+void KdTree<T, N>::build(size_t node, size_t level, size_t begin, size_t end, size_t* order,
+                         const Vector<T, N>* input) {
+    if (level == depth) {
+        return;
+    }
+    // axis of the widest spread
+    Vector<T, N> low = input[order[begin]];
+    Vector<T, N> high = low;
+    for (size_t i = begin + 1; i < end; i++) {
+        const Vector<T, N>& p = input[order[i]];
+        for (size_t d = 0; d < N; d++) {
+            low[d] = std::min(low[d], p[d]);
+            high[d] = std::max(high[d], p[d]);
+        }
+    }
+    uint32_t axis = 0;
+    for (size_t d = 1; d < N; d++) {
+        if (high[d] - low[d] > high[axis] - low[axis]) {
+            axis = static_cast<uint32_t>(d);
+        }
+    }
+    // median split: [begin, mid) <= split <= [mid, end)
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(order + begin, order + mid, order + end,
+                     [input, axis](size_t a, size_t b) { return input[a][axis] < input[b][axis]; });
+    nodes[node] = {input[order[mid]][axis], axis};
+
+    VECTORND_OMP(task if(end - begin > parallelBuildSize))
+    build(2 * node + 1, level + 1, begin, mid, order, input);
+    VECTORND_OMP(task if(end - begin > parallelBuildSize))
+    build(2 * node + 2, level + 1, mid, end, order, input);
+    VECTORND_OMP(taskwait)
+}
+
+// depth first search, nearest child first. bound is the squared distance beyond which the
+// visitor is no longer interested (it can shrink during the search)
+
+template <typename T, size_t N>
+template <typename Visitor>
+void KdTree<T, N>::search(const Vector<T, N>& query, size_t node, size_t level, size_t begin, size_t end,
+                          T& bound, Visitor& visit) const {
+    if (level == depth) {
+        for (size_t i = begin; i < end; i++) {
+            const T distance = static_cast<T>(query.squaredDist(points[i]));
+            if (distance <= bound) {
+                visit(distance, i);
+            }
+        }
+        return;
+    }
+    const Node& n = nodes[node];
+    const size_t mid = begin + (end - begin) / 2;
+    const T diff = query[n.axis] - n.split;
+    if (diff < 0) {
+        search(query, 2 * node + 1, level + 1, begin, mid, bound, visit);
+        if (diff * diff <= bound) {
+            search(query, 2 * node + 2, level + 1, mid, end, bound, visit);
+        }
+    } else {
+        search(query, 2 * node + 2, level + 1, mid, end, bound, visit);
+        if (diff * diff <= bound) {
+            search(query, 2 * node + 1, level + 1, begin, mid, bound, visit);
+        }
+    }
+}
+
+template <typename T, size_t N>
+Neighbor<T> KdTree<T, N>::nearest(const Vector<T, N>& query) const {
+    Neighbor<T> best{noNeighbor, std::numeric_limits<T>::max()};
+    if (points.empty()) {
+        return best;
+    }
+    T bound = std::numeric_limits<T>::max();
+    auto visit = [&](T distance, size_t i) {
+        const Neighbor<T> candidate{indices[i], distance};
+        if (candidate < best) {
+            best = candidate;
+            bound = distance;
+        }
+    };
+    search(query, 0, 0, 0, points.size(), bound, visit);
+    return best;
+}
+
+template <typename T, size_t N>
+std::vector<Neighbor<T>> KdTree<T, N>::knn(const Vector<T, N>& query, size_t k) const {
+    TopK<T> heap(std::min(k, points.size()));
+    if (heap.capacity() == 0) {
+        return {};
+    }
+    T bound = std::numeric_limits<T>::max();
+    auto visit = [&](T distance, size_t i) {
+        heap.push(distance, indices[i]);
+        if (heap.full()) {
+            bound = heap.worst();
+        }
+    };
+    search(query, 0, 0, 0, points.size(), bound, visit);
+    return heap.extractSorted();
+}
+
+template <typename T, size_t N>
+std::vector<Neighbor<T>> KdTree<T, N>::radiusSearch(const Vector<T, N>& query, T radius) const {
+    std::vector<Neighbor<T>> result;
+    if (points.empty()) {
+        return result;
+    }
+    T bound = radius * radius;
+    auto visit = [&](T distance, size_t i) {
+        result.push_back({indices[i], distance});
+    };
+    search(query, 0, 0, 0, points.size(), bound, visit);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+template <typename T, size_t N>
+KnnResult<T> KdTree<T, N>::knn(const Vector<T, N>* queries, size_t m, size_t k) const {
+    KnnResult<T> result;
+    result.k = std::min(k, points.size());
+    result.indices.resize(m * result.k);
+    result.distances.resize(m * result.k);
+    VECTORND_OMP(parallel for schedule(dynamic, 16))
+    for (size_t q = 0; q < m; q++) {
+        const auto neighbors = knn(queries[q], result.k);
+        for (size_t r = 0; r < neighbors.size(); r++) {
+            result.indices[q * result.k + r] = neighbors[r].index;
+            result.distances[q * result.k + r] = neighbors[r].distance;
+        }
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+std::vector<std::vector<Neighbor<T>>> KdTree<T, N>::radiusSearch(const Vector<T, N>* queries, size_t m, T radius) const {
+    std::vector<std::vector<Neighbor<T>>> result(m);
+    VECTORND_OMP(parallel for schedule(dynamic, 16))
+    for (size_t q = 0; q < m; q++) {
+        result[q] = radiusSearch(queries[q], radius);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max
+#include <vector>
+
+#include "Vector.hpp"
+#include "VectorArray.hpp"
+#include "TopK.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief exact k-nearest-neighbor search by brute force (squaredDist of every pair).
+ *
+ * The dataset is stored as a VectorArray so the distances of a query to a run of the
+ * dataset are computed with the SIMD kernel. A batch of queries is split into blocks of
+ * queries and shards of the dataset, processed in parallel, and the partial top-k of the
+ * shards are merged.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class KnnBruteForce
+{
+private:
+    VectorArray<T, N> data;
+
+    // number of queries of a task
+    static constexpr size_t queryBlock = 16;
+    // smallest shard of the dataset worth its own task
+    static constexpr size_t minShard = 4096;
+    // number of distances computed at once
+    static constexpr size_t distanceBlock = 256;
+
+    // top-k of the query in the dataset range [begin, end)
+    void searchRange(const Vector<T, N>& query, size_t begin, size_t end, TopK<T>& heap) const;
+public:
+    /**
+     * @brief build the engine over a copy of the dataset
+     *
+     * @param points
+     * @param count
+     */
+    KnnBruteForce(const Vector<T, N>* points, size_t count): data{points, count} {}
+
+    explicit KnnBruteForce(const std::vector<Vector<T, N>>& points): data{points} {}
+
+    /// number of vectors of the dataset
+    inline size_t size() const noexcept { return data.size(); }
+
+    /**
+     * @brief the k nearest vectors of each query, sorted by increasing squared distance
+     * (min(k, size()) neighbors per query)
+     *
+     * @param queries m vectors
+     * @param m number of queries
+     * @param k number of neighbors
+     * @return KnnResult<T> indices in the dataset and squared distances
+     */
+    KnnResult<T> query(const Vector<T, N>* queries, size_t m, size_t k) const;
+
+    KnnResult<T> query(const std::vector<Vector<T, N>>& queries, size_t k) const {
+        return query(queries.data(), queries.size(), k);
+    }
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+void KnnBruteForce<T, N>::searchRange(const Vector<T, N>& query, size_t begin, size_t end, TopK<T>& heap) const {
+    T distances[distanceBlock];
+    for (size_t blockBegin = begin; blockBegin < end; blockBegin += distanceBlock) {
+        const size_t blockEnd = std::min(end, blockBegin + distanceBlock);
+        data.squaredDist(query, blockBegin, blockEnd, distances);
+        for (size_t j = blockBegin; j < blockEnd; j++) {
+            heap.push(distances[j - blockBegin], j);
+        }
+    }
+}
+
+template <typename T, size_t N>
+KnnResult<T> KnnBruteForce<T, N>::query(const Vector<T, N>* queries, size_t m, size_t k) const {
+    KnnResult<T> result;
+    result.k = std::min(k, data.size());
+    result.indices.resize(m * result.k);
+    result.distances.resize(m * result.k);
+    if (m == 0 || result.k == 0) {
+        return result;
+    }
+    const size_t kk = result.k;
+
+    // enough tasks for every thread: split the dataset when there are few query blocks
+    const size_t queryBlocks = (m + queryBlock - 1) / queryBlock;
+    const size_t maxShards = std::max<size_t>(1, data.size() / minShard);
+    const size_t shards = std::min(maxShards, (parallel::threadCount() + queryBlocks - 1) / queryBlocks);
+    const size_t shardSize = (data.size() + shards - 1) / shards;
+
+    if (shards == 1) {
+        VECTORND_OMP(parallel for schedule(dynamic))
+        for (size_t block = 0; block < queryBlocks; block++) {
+            TopK<T> heap(kk);
+            for (size_t q = block * queryBlock; q < std::min(m, (block + 1) * queryBlock); q++) {
+                searchRange(queries[q], 0, data.size(), heap);
+                heap.extractSorted(&result.distances[q * kk], &result.indices[q * kk]);
+            }
+        }
+        return result;
+    }
+
+    // partial results: shards sorted lists of kk neighbors per query (or less for a small shard)
+    std::vector<T> partialDistances(m * shards * kk);
+    std::vector<size_t> partialIndices(m * shards * kk);
+    std::vector<size_t> partialSizes(m * shards);
+
+    VECTORND_OMP(parallel for collapse(2) schedule(dynamic))
+    for (size_t block = 0; block < queryBlocks; block++) {
+        for (size_t shard = 0; shard < shards; shard++) {
+            TopK<T> heap(kk);
+            const size_t begin = shard * shardSize;
+            const size_t end = std::min(data.size(), begin + shardSize);
+            for (size_t q = block * queryBlock; q < std::min(m, (block + 1) * queryBlock); q++) {
+                searchRange(queries[q], begin, end, heap);
+                const size_t slot = q * shards + shard;
+                partialSizes[slot] = heap.size();
+                heap.extractSorted(&partialDistances[slot * kk], &partialIndices[slot * kk]);
+            }
+        }
+    }
+
+    // merge the shards of each query
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t q = 0; q < m; q++) {
+        TopK<T> heap(kk);
+        for (size_t shard = 0; shard < shards; shard++) {
+            const size_t slot = q * shards + shard;
+            for (size_t r = 0; r < partialSizes[slot]; r++) {
+                heap.push(partialDistances[slot * kk + r], partialIndices[slot * kk + r]);
+            }
+        }
+        heap.extractSorted(&result.distances[q * kk], &result.indices[q * kk]);
+    }
+    return result;
+}
+
+}
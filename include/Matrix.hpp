@@ -0,0 +1,415 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <array>
+#include <iostream>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+template <typename T, size_t R, size_t C>
+class Matrix;
+
+namespace detail {
+
+/**
+ * @brief out[i] = m * in[i] for i in [0, count), or the affine transform m * (in[i], 1) when
+ * K == C - 1 (the last column is the translation).
+ *
+ * When a column fits in a packet, the C columns are loaded once into registers and each
+ * vector costs K broadcasts and fused multiply-adds: 2x2, 3x3, 4x4 and 3x4 in float, 2x2
+ * and 4x4 in double. Otherwise each column is added with Vector::axpy.
+ */
+template <typename T, size_t R, size_t C, size_t K>
+constexpr void transformKernel(const Matrix<T, R, C>& m, const Vector<T, K>* in, Vector<T, R>* out, size_t count);
+
+} // namespace detail
+
+/**
+ * @brief R x C matrix of T (fixed size), stored by columns: Matrix * Vector is a sum of
+ * columns scaled by the elements of the vector, computed on whole columns.
+ *
+ * A Matrix<T, R, C> maps Vector<T, C> to Vector<T, R>. A Matrix<T, R, R + 1> is also an
+ * affine transform of Vector<T, R> (transformPoint, transformPoints): the last column is
+ * the translation, Matrix<float, 3, 4> for the 3D rigid transforms.
+ *
+ * @tparam T the type of the elements
+ * @tparam R the number of rows
+ * @tparam C the number of columns
+ */
+template <typename T, size_t R, size_t C>
+class Matrix
+{
+private:
+    std::array<Vector<T, R>, C> columns;
+
+    template <typename, size_t, size_t>
+    friend class Matrix;
+public:
+    // dimensions of the matrix (for convenience)
+    static constexpr size_t rows = R;
+    static constexpr size_t cols = C;
+    //**----------
+    /// null matrix
+    constexpr Matrix(): columns{} {}
+
+    /**
+     * @brief matrix from its rows (as written): Matrix<float, 2, 2>({{{1, 2}, {3, 4}}})
+     *
+     * @param rowValues R rows of C elements
+     */
+    constexpr Matrix(const std::array<std::array<T, C>, R>& rowValues);
+
+    /**
+     * @brief matrix from its columns
+     *
+     * @param columnVectors
+     * @return Matrix
+     */
+    static constexpr Matrix fromColumns(const std::array<Vector<T, R>, C>& columnVectors);
+
+    /**
+     * @brief matrix from its rows
+     *
+     * @param rowVectors
+     * @return Matrix
+     */
+    static constexpr Matrix fromRows(const std::array<Vector<T, C>, R>& rowVectors);
+
+    /**
+     * @brief identity matrix (square matrices only)
+     *
+     * @return Matrix
+     */
+    static constexpr Matrix identity();
+    //**----------
+
+    /// element of row r and column c (write)
+    constexpr T& operator()(size_t r, size_t c) { return columns[c][r]; }
+
+    /// element of row r and column c (read)
+    constexpr T operator()(size_t r, size_t c) const { return columns[c][r]; }
+
+    /// column c
+    constexpr const Vector<T, R>& column(size_t c) const { return columns[c]; }
+    constexpr Vector<T, R>& column(size_t c) { return columns[c]; }
+
+    /// row r (a copy: the rows are not contiguous)
+    constexpr Vector<T, C> row(size_t r) const;
+
+    /**
+     * @brief the transposed matrix
+     *
+     * @return Matrix<T, C, R>
+     */
+    constexpr Matrix<T, C, R> transpose() const;
+
+    /**
+     * @brief the affine transform of a point: m * (point, 1), the last column is the
+     * translation (matrices of R rows and R + 1 columns)
+     *
+     * @param point
+     * @return Vector<T, R>
+     */
+    constexpr Vector<T, R> transformPoint(const Vector<T, R>& point) const;
+
+    constexpr Matrix& operator+=(const Matrix& other);
+    constexpr Matrix& operator-=(const Matrix& other);
+    constexpr Matrix& operator*=(T scalar);
+
+    constexpr Matrix operator+(const Matrix& other) const { return Matrix(*this) += other; }
+    constexpr Matrix operator-(const Matrix& other) const { return Matrix(*this) -= other; }
+    constexpr Matrix operator*(T scalar) const { return Matrix(*this) *= scalar; }
+
+    /**
+     * @brief product with a vector
+     *
+     * @param vector
+     * @return Vector<T, R>
+     */
+    constexpr Vector<T, R> operator*(const Vector<T, C>& vector) const;
+
+    /**
+     * @brief product of matrices, each column of the result is this * a column of other
+     *
+     * @param other
+     * @return Matrix<T, R, K>
+     */
+    template <size_t K>
+    constexpr Matrix<T, R, K> operator*(const Matrix<T, C, K>& other) const;
+
+    constexpr bool operator==(const Matrix& other) const;
+    constexpr bool operator!=(const Matrix& other) const { return !(*this == other); }
+
+    /**
+     * @brief print the matrix row by row: [[1, 2], [3, 4]]
+     *
+     * @param os
+     * @param matrix
+     * @return std::ostream&
+     */
+    friend std::ostream& operator<<(std::ostream& os, const Matrix& matrix) {
+        os << "[";
+        for (size_t r = 0; r < R; r++) {
+            os << matrix.row(r);
+            if (r < R - 1) {
+                os << ", ";
+            }
+        }
+        os << "]";
+        return os;
+    }
+
+    template <typename U, size_t R2, size_t C2, size_t K>
+    friend constexpr void detail::transformKernel(const Matrix<U, R2, C2>& m, const Vector<U, K>* in, Vector<U, R2>* out, size_t count);
+};
+
+/// scalar * matrix
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> operator*(T scalar, const Matrix<T, R, C>& matrix) {
+    return matrix * scalar;
+}
+
+/// number of vectors transformed by a task of the batched transforms
+constexpr size_t transformBlock = 4096;
+
+/**
+ * @brief out[i] = matrix * in[i] for i in [0, count), in parallel for long arrays
+ *
+ * @param matrix
+ * @param in count vectors
+ * @param out count vectors (must not overlap in, unless in == out for a square matrix)
+ * @param count
+ */
+template <typename T, size_t R, size_t C>
+void transform(const Matrix<T, R, C>& matrix, const Vector<T, C>* in, Vector<T, R>* out, size_t count);
+
+template <typename T, size_t R, size_t C>
+void transform(const Matrix<T, R, C>& matrix, const std::vector<Vector<T, C>>& in, std::vector<Vector<T, R>>& out) {
+    out.resize(in.size());
+    transform(matrix, in.data(), out.data(), in.size());
+}
+
+/**
+ * @brief out[i] = matrix.transformPoint(in[i]) for i in [0, count): the affine transform of
+ * points by a R x (R + 1) matrix, in parallel for long arrays
+ *
+ * @param matrix
+ * @param in count points
+ * @param out count points (may be in)
+ * @param count
+ */
+template <typename T, size_t R>
+void transformPoints(const Matrix<T, R, R + 1>& matrix, const Vector<T, R>* in, Vector<T, R>* out, size_t count);
+
+template <typename T, size_t R>
+void transformPoints(const Matrix<T, R, R + 1>& matrix, const std::vector<Vector<T, R>>& in, std::vector<Vector<T, R>>& out) {
+    out.resize(in.size());
+    transformPoints(matrix, in.data(), out.data(), in.size());
+}
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>::Matrix(const std::array<std::array<T, C>, R>& rowValues): columns{} {
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            columns[c][r] = rowValues[r][c];
+        }
+    }
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::fromColumns(const std::array<Vector<T, R>, C>& columnVectors) {
+    Matrix matrix;
+    matrix.columns = columnVectors;
+    return matrix;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::fromRows(const std::array<Vector<T, C>, R>& rowVectors) {
+    Matrix matrix;
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            matrix.columns[c][r] = rowVectors[r][c];
+        }
+    }
+    return matrix;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C> Matrix<T, R, C>::identity() {
+    static_assert(R == C, "the identity is a square matrix");
+    Matrix matrix;
+    for (size_t i = 0; i < R; i++) {
+        matrix.columns[i][i] = T(1);
+    }
+    return matrix;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Vector<T, C> Matrix<T, R, C>::row(size_t r) const {
+    Vector<T, C> result;
+    for (size_t c = 0; c < C; c++) {
+        result[c] = columns[c][r];
+    }
+    return result;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, C, R> Matrix<T, R, C>::transpose() const {
+    Matrix<T, C, R> result;
+    for (size_t r = 0; r < R; r++) {
+        result.columns[r] = row(r);
+    }
+    return result;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>& Matrix<T, R, C>::operator+=(const Matrix& other) {
+    for (size_t c = 0; c < C; c++) {
+        columns[c] += other.columns[c];
+    }
+    return *this;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>& Matrix<T, R, C>::operator-=(const Matrix& other) {
+    for (size_t c = 0; c < C; c++) {
+        columns[c] -= other.columns[c];
+    }
+    return *this;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Matrix<T, R, C>& Matrix<T, R, C>::operator*=(T scalar) {
+    for (size_t c = 0; c < C; c++) {
+        columns[c] *= scalar;
+    }
+    return *this;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr bool Matrix<T, R, C>::operator==(const Matrix& other) const {
+    for (size_t c = 0; c < C; c++) {
+        if (columns[c] != other.columns[c]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Vector<T, R> Matrix<T, R, C>::operator*(const Vector<T, C>& vector) const {
+    Vector<T, R> result;
+    detail::transformKernel(*this, &vector, &result, 1);
+    return result;
+}
+
+template <typename T, size_t R, size_t C>
+template <size_t K>
+constexpr Matrix<T, R, K> Matrix<T, R, C>::operator*(const Matrix<T, C, K>& other) const {
+    Matrix<T, R, K> result;
+    detail::transformKernel(*this, other.columns.data(), result.columns.data(), K);
+    return result;
+}
+
+template <typename T, size_t R, size_t C>
+constexpr Vector<T, R> Matrix<T, R, C>::transformPoint(const Vector<T, R>& point) const {
+    static_assert(C == R + 1, "an affine transform has a column more than rows");
+    Vector<T, R> result;
+    detail::transformKernel(*this, &point, &result, 1);
+    return result;
+}
+
+namespace detail {
+
+// a column of R elements in a single packet
+template <typename T, size_t R>
+constexpr bool hasColumnPacket = [] {
+    if constexpr (simd::hasPacket<T, R>) {
+        return R <= simd::PacketFor<T, R>::width;
+    } else {
+        return false;
+    }
+}();
+
+// the packet path of transformKernel: the columns stay in registers for the whole batch
+template <typename T, size_t R, size_t C, size_t K>
+inline void transformPackets(const Vector<T, R>* matrixColumns, const Vector<T, K>* in, Vector<T, R>* out, size_t count) {
+    using P = simd::PacketFor<T, R>;
+    constexpr bool affine = K < C;
+    typename P::type columns[C];
+    for (size_t c = 0; c < C; c++) {
+        columns[c] = R == P::width ? P::load(matrixColumns[c].cbegin()) : P::loadFirst(matrixColumns[c].cbegin(), R);
+    }
+    for (size_t i = 0; i < count; i++) {
+        const T* v = in[i].cbegin();
+        auto acc = affine ? columns[C - 1] : P::mul(columns[0], P::set1(v[0]));
+        for (size_t c = affine ? 0 : 1; c < K; c++) {
+            acc = P::fmadd(columns[c], P::set1(v[c]), acc);
+        }
+        // stored after the loads: in[i] may be out[i]
+        if constexpr (R == P::width) {
+            P::store(out[i].begin(), acc);
+        } else {
+            P::storeFirst(out[i].begin(), acc, R);
+        }
+    }
+}
+
+template <typename T, size_t R, size_t C, size_t K>
+constexpr void transformKernel(const Matrix<T, R, C>& m, const Vector<T, K>* in, Vector<T, R>* out, size_t count) {
+    static_assert(K == C || K + 1 == C, "the vectors have C elements, or C - 1 for an affine transform");
+    constexpr bool affine = K < C;
+    if constexpr (hasColumnPacket<T, R>) {
+        if (!isConstantEvaluated()) {
+            transformPackets<T, R, C, K>(m.columns.data(), in, out, count);
+            return;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        const Vector<T, K> v = in[i];
+        Vector<T, R> result = m.columns[C - 1];
+        if (!affine) {
+            result = m.columns[0] * v[0];
+        }
+        for (size_t c = affine ? 0 : 1; c < K; c++) {
+            result.axpy(v[c], m.columns[c]);
+        }
+        out[i] = result;
+    }
+}
+
+// blocks of transformBlock vectors in parallel
+template <typename T, size_t R, size_t C, size_t K>
+void transformBatch(const Matrix<T, R, C>& matrix, const Vector<T, K>* in, Vector<T, R>* out, size_t count) {
+    if (count <= transformBlock) {
+        transformKernel(matrix, in, out, count);
+        return;
+    }
+    const size_t blocks = (count + transformBlock - 1) / transformBlock;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * transformBlock;
+        transformKernel(matrix, in + begin, out + begin, std::min(transformBlock, count - begin));
+    }
+}
+
+} // namespace detail
+
+template <typename T, size_t R, size_t C>
+void transform(const Matrix<T, R, C>& matrix, const Vector<T, C>* in, Vector<T, R>* out, size_t count) {
+    detail::transformBatch(matrix, in, out, count);
+}
+
+template <typename T, size_t R>
+void transformPoints(const Matrix<T, R, R + 1>& matrix, const Vector<T, R>* in, Vector<T, R>* out, size_t count) {
+    detail::transformBatch(matrix, in, out, count);
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+/**
+ * @brief OpenMP pragma that compiles to nothing (and without unknown-pragma warnings)
+ * when OpenMP is not enabled. Example: VECTORND_OMP(parallel for schedule(dynamic))
+ */
+#if defined(_OPENMP)
+#define VECTORND_OMP(...) _Pragma(VECTORND_OMP_STRING(omp __VA_ARGS__))
+#define VECTORND_OMP_STRING(...) #__VA_ARGS__
+#else
+#define VECTORND_OMP(...)
+#endif
+
+namespace VectorND {
+namespace parallel {
+
+/// maximum number of threads used by the parallel kernels
+inline size_t threadCount() {
+#if defined(_OPENMP)
+    return static_cast<size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+/// index of the calling thread inside a parallel region (0 outside)
+inline size_t threadIndex() {
+#if defined(_OPENMP)
+    return static_cast<size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+} // namespace parallel
+} // namespace VectorND
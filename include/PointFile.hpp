@@ -0,0 +1,602 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cerrno>
+#include <cstdint>
+#include <cstring> // memcpy, memcmp
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define VECTORND_MMAP 1
+#else
+#define VECTORND_MMAP 0
+#endif
+
+#include "Vector.hpp"
+#include "VectorArray.hpp"
+#include "AlignedAllocator.hpp"
+
+namespace VectorND {
+
+/**
+ * Binary point files: a versioned format for collections of Vector<T, N>, read back without
+ * parsing nor per-element copy (memory mapped).
+ *
+ * The file starts with a PointFileHeader (64 bytes, native byte order), the data starts at
+ * header.dataOffset, a multiple of header.alignment:
+ *  - AoS: count vectors of N elements, in order (the layout of an array of Vector<T, N>)
+ *  - SoA: N lanes of count elements (the layout of VectorArray), lane d starts
+ *    d * laneStride elements after the data, each lane is aligned
+ */
+
+/// order of the elements in a point file
+enum class PointLayout : uint32_t {
+    AoS = 0,
+    SoA = 1
+};
+
+/// header of a point file
+struct PointFileHeader {
+    char magic[8];
+    uint32_t version;
+    // 0x01020304 in the byte order of the writer
+    uint32_t byteOrder;
+    // PointElement<T>::code and sizeof(T)
+    uint32_t elementType;
+    uint32_t elementSize;
+    uint64_t dimension;
+    uint64_t count;
+    uint32_t layout;
+    // alignment in bytes of the data (and of the lanes)
+    uint32_t alignment;
+    uint64_t dataOffset;
+    // elements between 2 lanes (SoA only)
+    uint64_t laneStride;
+};
+static_assert(sizeof(PointFileHeader) == 64, "the header must not have padding");
+
+constexpr char pointFileMagic[8] = {'V', 'N', 'D', 'P', 'O', 'I', 'N', 'T'};
+constexpr uint32_t pointFileVersion = 1;
+constexpr uint32_t pointFileAlignment = 64;
+
+/**
+ * @brief code of the element type in a point file: the kind (1 floating point, 2 signed
+ * integer, 3 unsigned integer) times 16, plus sizeof(T). Specialize it for other types.
+ */
+template <typename T, typename = void>
+struct PointElement {};
+
+template <typename T>
+struct PointElement<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+    static constexpr uint32_t code =
+        (std::is_floating_point_v<T> ? 1u : (std::is_signed_v<T> ? 2u : 3u)) * 16u + static_cast<uint32_t>(sizeof(T));
+};
+
+/**
+ * @brief read-only view of contiguous vectors (the std::span of C++20)
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class VectorSpan
+{
+private:
+    const Vector<T, N>* first{nullptr};
+    size_t count{0};
+public:
+    using value_type = Vector<T, N>;
+    using iterator = const Vector<T, N>*;
+
+    VectorSpan() = default;
+    VectorSpan(const Vector<T, N>* data, size_t count): first{data}, count{count} {}
+
+    inline const Vector<T, N>* data() const noexcept { return first; }
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+    inline iterator begin() const noexcept { return first; }
+    inline iterator end() const noexcept { return first + count; }
+    inline const Vector<T, N>& operator[](size_t i) const { return first[i]; }
+};
+
+/**
+ * @brief write vectors to a point file (replaced if it exists)
+ *
+ * @param path
+ * @param vectors
+ * @param count
+ * @param layout AoS (default) or SoA
+ */
+template <typename T, size_t N>
+void writePointFile(const std::string& path, const Vector<T, N>* vectors, size_t count,
+                    PointLayout layout = PointLayout::AoS);
+
+template <typename T, size_t N>
+void writePointFile(const std::string& path, const std::vector<Vector<T, N>>& vectors,
+                    PointLayout layout = PointLayout::AoS) {
+    writePointFile(path, vectors.data(), vectors.size(), layout);
+}
+
+/**
+ * @brief write a VectorArray to a point file (its lanes are written as they are in SoA)
+ *
+ * @param path
+ * @param array
+ * @param layout SoA (default) or AoS
+ */
+template <typename T, size_t N>
+void writePointFile(const std::string& path, const VectorArray<T, N>& array,
+                    PointLayout layout = PointLayout::SoA);
+
+/**
+ * @brief point file mapped in memory (read only): the vectors are read in place, the pages
+ * are loaded by the system on first access. Without mmap (not POSIX), the file is read
+ * into an aligned buffer at once.
+ *
+ * @tparam T the type of the elements, it must match the file
+ * @tparam N the number of elements, it must match the file
+ */
+template <typename T, size_t N>
+class MappedPointFile
+{
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+private:
+    PointFileHeader info{};
+    const unsigned char* bytes{nullptr};
+    size_t byteCount{0};
+#if !VECTORND_MMAP
+    std::vector<unsigned char, AlignedAllocator<unsigned char>> buffer;
+#endif
+
+    void release() noexcept;
+    inline const T* elements() const noexcept { return reinterpret_cast<const T*>(bytes + info.dataOffset); }
+public:
+    MappedPointFile() = default;
+
+    /**
+     * @brief map a point file, std::runtime_error if it cannot be read or does not hold
+     * Vector<T, N> (std::system_error for the errors of the system)
+     *
+     * @param path
+     */
+    explicit MappedPointFile(const std::string& path);
+
+    MappedPointFile(const MappedPointFile&) = delete;
+    MappedPointFile& operator=(const MappedPointFile&) = delete;
+    MappedPointFile(MappedPointFile&& other) noexcept;
+    MappedPointFile& operator=(MappedPointFile&& other) noexcept;
+    ~MappedPointFile() { release(); }
+
+    inline const PointFileHeader& header() const noexcept { return info; }
+    inline PointLayout layout() const noexcept { return static_cast<PointLayout>(info.layout); }
+
+    /// number of vectors
+    inline size_t size() const noexcept { return static_cast<size_t>(info.count); }
+
+    /**
+     * @brief the vectors of an AoS file, in place (std::logic_error for a SoA file)
+     *
+     * @return VectorSpan<T, N>
+     */
+    VectorSpan<T, N> vectors() const;
+
+    /**
+     * @brief lane of the component d of a SoA file, in place: size() values aligned on
+     * header().alignment bytes (std::logic_error for an AoS file)
+     *
+     * @param d
+     * @return const T*
+     */
+    const T* lane(size_t d) const;
+
+    /// vector i (a copy, for both layouts)
+    Vector<T, N> operator[](size_t i) const;
+
+    /// copy of the vectors as an array of structures
+    std::vector<Vector<T, N>> toVectors() const;
+
+    /// copy of the vectors as a structure of arrays
+    VectorArray<T, N> toVectorArray() const;
+};
+
+/**
+ * @brief sequential reader of a point file, chunk by chunk: only the current chunk is in
+ * memory, for files larger than the RAM (or read once)
+ *
+ * @tparam T the type of the elements, it must match the file
+ * @tparam N the number of elements, it must match the file
+ */
+template <typename T, size_t N>
+class PointFileReader
+{
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+private:
+    std::ifstream stream;
+    std::string path;
+    PointFileHeader info{};
+    size_t position{0};
+    // a lane of a chunk of a SoA file
+    std::vector<T> laneBuffer;
+public:
+    /**
+     * @brief open a point file, std::runtime_error if it cannot be read or does not hold
+     * Vector<T, N>
+     *
+     * @param path
+     */
+    explicit PointFileReader(const std::string& path);
+
+    inline const PointFileHeader& header() const noexcept { return info; }
+
+    /// number of vectors of the file
+    inline size_t size() const noexcept { return static_cast<size_t>(info.count); }
+
+    /// index of the next vector read
+    inline size_t tell() const noexcept { return position; }
+
+    /// the next read starts at vector index (<= size())
+    void seek(size_t index);
+
+    /**
+     * @brief read the next vectors
+     *
+     * @param out at least max vectors
+     * @param max
+     * @return size_t number of vectors read, min(max, size() - tell()): 0 at the end
+     */
+    size_t read(Vector<T, N>* out, size_t max);
+
+    /**
+     * @brief read the next chunk
+     *
+     * @param chunk resized to the number of vectors read
+     * @param chunkSize maximum number of vectors
+     * @return false at the end of the file (the chunk is then empty)
+     */
+    bool next(std::vector<Vector<T, N>>& chunk, size_t chunkSize);
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+[[noreturn]] inline void pointFileError(const std::string& path, const std::string& problem) {
+    throw std::runtime_error("VectorND: " + path + ": " + problem);
+}
+
+// lanes of a SoA file start on multiples of the alignment
+template <typename T>
+constexpr uint64_t pointLaneStride(uint64_t count) {
+    constexpr uint64_t step = pointFileAlignment / sizeof(T) > 0 ? pointFileAlignment / sizeof(T) : 1;
+    return (count + step - 1) / step * step;
+}
+
+template <typename T, size_t N>
+PointFileHeader makePointFileHeader(size_t count, PointLayout layout) {
+    PointFileHeader header{};
+    std::memcpy(header.magic, pointFileMagic, sizeof(pointFileMagic));
+    header.version = pointFileVersion;
+    header.byteOrder = 0x01020304;
+    header.elementType = PointElement<T>::code;
+    header.elementSize = static_cast<uint32_t>(sizeof(T));
+    header.dimension = N;
+    header.count = count;
+    header.layout = static_cast<uint32_t>(layout);
+    header.alignment = pointFileAlignment;
+    header.dataOffset = (sizeof(PointFileHeader) + pointFileAlignment - 1) / pointFileAlignment * pointFileAlignment;
+    header.laneStride = layout == PointLayout::SoA ? pointLaneStride<T>(count) : 0;
+    return header;
+}
+
+// throw if the header does not describe Vector<T, N> data held in fileSize bytes
+template <typename T, size_t N>
+void checkPointFileHeader(const PointFileHeader& header, uint64_t fileSize, const std::string& path) {
+    if (fileSize < sizeof(PointFileHeader) || std::memcmp(header.magic, pointFileMagic, sizeof(pointFileMagic)) != 0) {
+        pointFileError(path, "not a point file");
+    }
+    if (header.version != pointFileVersion) {
+        pointFileError(path, "unsupported version " + std::to_string(header.version));
+    }
+    if (header.byteOrder != 0x01020304) {
+        pointFileError(path, "written with another byte order");
+    }
+    if (header.elementType != PointElement<T>::code || header.elementSize != sizeof(T) || header.dimension != N) {
+        pointFileError(path, "holds vectors of " + std::to_string(header.dimension) + " elements of type " +
+                             std::to_string(header.elementType) + ", not of the requested type");
+    }
+    if (header.layout != static_cast<uint32_t>(PointLayout::AoS) && header.layout != static_cast<uint32_t>(PointLayout::SoA)) {
+        pointFileError(path, "unknown layout");
+    }
+    if (header.alignment == 0 || header.alignment % alignof(T) != 0 || header.dataOffset % header.alignment != 0 ||
+        header.dataOffset < sizeof(PointFileHeader) || header.dataOffset > fileSize) {
+        pointFileError(path, "misaligned data");
+    }
+    // in elements, compared without overflow
+    const uint64_t available = (fileSize - header.dataOffset) / sizeof(T);
+    bool fits;
+    if (header.layout == static_cast<uint32_t>(PointLayout::AoS)) {
+        fits = header.count <= available / N;
+    } else {
+        fits = header.laneStride >= header.count && header.laneStride <= available / N &&
+               (N - 1) * header.laneStride + header.count <= available &&
+               (header.laneStride * sizeof(T)) % header.alignment == 0;
+    }
+    if (!fits) {
+        pointFileError(path, "truncated");
+    }
+}
+
+inline void writeZeros(std::ofstream& stream, uint64_t n) {
+    const char zeros[pointFileAlignment] = {};
+    for (; n > 0; n -= std::min<uint64_t>(n, sizeof(zeros))) {
+        stream.write(zeros, static_cast<std::streamsize>(std::min<uint64_t>(n, sizeof(zeros))));
+    }
+}
+
+// create the file and write the header, the data follows
+inline std::ofstream startPointFile(const std::string& path, const PointFileHeader& header) {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        pointFileError(path, "cannot be created");
+    }
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeZeros(stream, header.dataOffset - sizeof(header));
+    return stream;
+}
+
+inline void finishPointFile(std::ofstream& stream, const std::string& path) {
+    if (!stream.flush()) {
+        pointFileError(path, "write failed");
+    }
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+void writePointFile(const std::string& path, const Vector<T, N>* vectors, size_t count, PointLayout layout) {
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+    const PointFileHeader header = detail::makePointFileHeader<T, N>(count, layout);
+    std::ofstream stream = detail::startPointFile(path, header);
+    if (layout == PointLayout::AoS) {
+        stream.write(reinterpret_cast<const char*>(vectors), static_cast<std::streamsize>(count * sizeof(Vector<T, N>)));
+    } else {
+        // gather each lane by chunks
+        constexpr size_t chunk = 4096;
+        std::vector<T> lane(std::min(count, chunk));
+        for (size_t d = 0; d < N; d++) {
+            for (size_t begin = 0; begin < count; begin += chunk) {
+                const size_t n = std::min(chunk, count - begin);
+                for (size_t i = 0; i < n; i++) {
+                    lane[i] = vectors[begin + i][d];
+                }
+                stream.write(reinterpret_cast<const char*>(lane.data()), static_cast<std::streamsize>(n * sizeof(T)));
+            }
+            detail::writeZeros(stream, (header.laneStride - count) * sizeof(T));
+        }
+    }
+    detail::finishPointFile(stream, path);
+}
+
+template <typename T, size_t N>
+void writePointFile(const std::string& path, const VectorArray<T, N>& array, PointLayout layout) {
+    static_assert(hasArrayLayout<T, N>, "Vector<T, N> must have the layout of T[N]");
+    if (layout == PointLayout::AoS) {
+        writePointFile(path, array.toVectors(), layout);
+        return;
+    }
+    const size_t count = array.size();
+    const PointFileHeader header = detail::makePointFileHeader<T, N>(count, layout);
+    std::ofstream stream = detail::startPointFile(path, header);
+    for (size_t d = 0; d < N; d++) {
+        stream.write(reinterpret_cast<const char*>(array.lane(d)), static_cast<std::streamsize>(count * sizeof(T)));
+        detail::writeZeros(stream, (header.laneStride - count) * sizeof(T));
+    }
+    detail::finishPointFile(stream, path);
+}
+
+//* ------------------ MappedPointFile ------------------ *//
+
+template <typename T, size_t N>
+MappedPointFile<T, N>::MappedPointFile(const std::string& path) {
+#if VECTORND_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "VectorND: " + path);
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "VectorND: " + path);
+    }
+    const size_t fileSize = static_cast<size_t>(status.st_size);
+    if (fileSize < sizeof(PointFileHeader)) {
+        ::close(fd);
+        detail::pointFileError(path, "not a point file");
+    }
+    void* mapping = ::mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::system_error(error, std::generic_category(), "VectorND: mmap " + path);
+    }
+    bytes = static_cast<const unsigned char*>(mapping);
+    byteCount = fileSize;
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        detail::pointFileError(path, "cannot be opened");
+    }
+    const size_t fileSize = static_cast<size_t>(stream.tellg());
+    buffer.resize(fileSize);
+    stream.seekg(0);
+    if (!stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(fileSize))) {
+        detail::pointFileError(path, "read failed");
+    }
+    bytes = buffer.data();
+    byteCount = fileSize;
+#endif
+    if (byteCount >= sizeof(PointFileHeader)) {
+        std::memcpy(&info, bytes, sizeof(info));
+    }
+    try {
+        detail::checkPointFileHeader<T, N>(info, byteCount, path);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+template <typename T, size_t N>
+void MappedPointFile<T, N>::release() noexcept {
+#if VECTORND_MMAP
+    if (bytes != nullptr) {
+        ::munmap(const_cast<unsigned char*>(bytes), byteCount);
+    }
+#else
+    buffer = {};
+#endif
+    bytes = nullptr;
+    byteCount = 0;
+    info = {};
+}
+
+template <typename T, size_t N>
+MappedPointFile<T, N>::MappedPointFile(MappedPointFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+template <typename T, size_t N>
+MappedPointFile<T, N>& MappedPointFile<T, N>::operator=(MappedPointFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        info = other.info;
+        bytes = other.bytes;
+        byteCount = other.byteCount;
+#if !VECTORND_MMAP
+        buffer = std::move(other.buffer);
+#endif
+        other.bytes = nullptr;
+        other.byteCount = 0;
+        other.info = {};
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorSpan<T, N> MappedPointFile<T, N>::vectors() const {
+    if (layout() != PointLayout::AoS) {
+        throw std::logic_error("VectorND: vectors() needs an AoS point file, use lane()");
+    }
+    return {reinterpret_cast<const Vector<T, N>*>(elements()), size()};
+}
+
+template <typename T, size_t N>
+const T* MappedPointFile<T, N>::lane(size_t d) const {
+    if (layout() != PointLayout::SoA) {
+        throw std::logic_error("VectorND: lane() needs a SoA point file, use vectors()");
+    }
+    return elements() + d * info.laneStride;
+}
+
+template <typename T, size_t N>
+Vector<T, N> MappedPointFile<T, N>::operator[](size_t i) const {
+    if (layout() == PointLayout::AoS) {
+        return vectors()[i];
+    }
+    Vector<T, N> vector;
+    for (size_t d = 0; d < N; d++) {
+        vector[d] = lane(d)[i];
+    }
+    return vector;
+}
+
+template <typename T, size_t N>
+std::vector<Vector<T, N>> MappedPointFile<T, N>::toVectors() const {
+    if (layout() == PointLayout::AoS) {
+        return std::vector<Vector<T, N>>(vectors().begin(), vectors().end());
+    }
+    return toVectorArray().toVectors();
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> MappedPointFile<T, N>::toVectorArray() const {
+    if (layout() == PointLayout::AoS) {
+        return VectorArray<T, N>(vectors().data(), size());
+    }
+    VectorArray<T, N> array(size());
+    for (size_t d = 0; d < N; d++) {
+        std::copy(lane(d), lane(d) + size(), array.lane(d));
+    }
+    return array;
+}
+
+//* ------------------ PointFileReader ------------------ *//
+
+template <typename T, size_t N>
+PointFileReader<T, N>::PointFileReader(const std::string& path): stream(path, std::ios::binary | std::ios::ate), path{path} {
+    if (!stream) {
+        detail::pointFileError(path, "cannot be opened");
+    }
+    const uint64_t fileSize = static_cast<uint64_t>(stream.tellg());
+    stream.seekg(0);
+    if (fileSize >= sizeof(PointFileHeader)) {
+        stream.read(reinterpret_cast<char*>(&info), sizeof(info));
+    }
+    detail::checkPointFileHeader<T, N>(info, fileSize, path);
+    seek(0);
+}
+
+template <typename T, size_t N>
+void PointFileReader<T, N>::seek(size_t index) {
+    position = std::min(index, size());
+    if (static_cast<PointLayout>(info.layout) == PointLayout::AoS) {
+        stream.seekg(static_cast<std::streamoff>(info.dataOffset + position * sizeof(Vector<T, N>)));
+    }
+}
+
+template <typename T, size_t N>
+size_t PointFileReader<T, N>::read(Vector<T, N>* out, size_t max) {
+    const size_t n = std::min(max, size() - position);
+    if (n == 0) {
+        return 0;
+    }
+    if (static_cast<PointLayout>(info.layout) == PointLayout::AoS) {
+        stream.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(n * sizeof(Vector<T, N>)));
+    } else {
+        // one read per lane, scattered into the vectors
+        laneBuffer.resize(n);
+        for (size_t d = 0; d < N; d++) {
+            stream.seekg(static_cast<std::streamoff>(info.dataOffset + (d * info.laneStride + position) * sizeof(T)));
+            stream.read(reinterpret_cast<char*>(laneBuffer.data()), static_cast<std::streamsize>(n * sizeof(T)));
+            for (size_t i = 0; i < n; i++) {
+                out[i][d] = laneBuffer[i];
+            }
+        }
+    }
+    if (!stream) {
+        detail::pointFileError(path, "read failed");
+    }
+    position += n;
+    return n;
+}
+
+template <typename T, size_t N>
+bool PointFileReader<T, N>::next(std::vector<Vector<T, N>>& chunk, size_t chunkSize) {
+    chunk.resize(std::min(chunkSize, size() - position));
+    chunk.resize(read(chunk.data(), chunk.size()));
+    return !chunk.empty();
+}
+
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(VECTORND_PROFILE)
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#endif
+
+/**
+ * Opt-in instrumentation of the hot paths, enabled by defining VECTORND_PROFILE before including
+ * the library (or -DVECTORND_PROFILE). It counts, for each Vector<T, N>:
+ * - the calls of the operators (+, -, *, /, unary -, and +=, -=, *=, /=), dot, the norms,
+ *   the distances, mod and the casting operator Vector<U, N>,
+ * - the temporaries built by the default and copy constructors (moves are copies: Vector has no
+ *   move constructor of its own),
+ * - an estimate of the flops and of the bytes touched, as if every operation ran on its own:
+ *   an operator inside an expression is not evaluated alone, so the bytes of the expressions are
+ *   what fusing them saves.
+ *
+ * Each thread counts in its own counters, merged on demand by profile::report(), which prints as
+ * text or JSON. Without VECTORND_PROFILE the counting macro compiles to nothing (and report(),
+ * reset() are not declared).
+ *
+ * In profiling builds the copy constructor of Vector is not trivial: hasArrayLayout only checks the
+ * layout then, the copies still copy the same bytes.
+ */
+namespace VectorND {
+
+namespace profile {
+
+/**
+ * @brief counted operations
+ */
+enum class Op : size_t {
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Negate,
+    AddAssign,
+    SubAssign,
+    MulAssign,
+    DivAssign,
+    Dot,
+    Norm, ///< norm and squaredNorm
+    Dist, ///< dist and squaredDist
+    Mod,
+    Cast,
+    DefaultConstruct,
+    CopyConstruct,
+    Count
+};
+
+constexpr size_t opCount = static_cast<size_t>(Op::Count);
+
+/// true when the library is built with VECTORND_PROFILE
+#if defined(VECTORND_PROFILE)
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/**
+ * @brief name of an operation in the reports ("add", "dot", "copyConstruct"...)
+ */
+constexpr const char* opName(Op op) noexcept {
+    constexpr const char* names[opCount] = {"add",       "sub",       "mul",       "div",  "negate",
+                                            "addAssign", "subAssign", "mulAssign", "divAssign",
+                                            "dot",       "norm",      "dist",      "mod",  "cast",
+                                            "defaultConstruct",       "copyConstruct"};
+    return names[static_cast<size_t>(op)];
+}
+
+#if defined(VECTORND_PROFILE)
+
+/**
+ * @brief counters of one Vector<T, N> type, merged over the threads
+ */
+struct Entry {
+    std::string type; ///< element type: "float", "int32", ...
+    size_t size{0};   ///< N
+    std::array<uint64_t, opCount> calls{};
+    uint64_t flops{0};
+    uint64_t bytes{0};
+
+    uint64_t count(Op op) const noexcept { return calls[static_cast<size_t>(op)]; }
+    /// vectors built by the default and copy constructors
+    uint64_t temporaries() const noexcept { return count(Op::DefaultConstruct) + count(Op::CopyConstruct); }
+};
+
+/**
+ * @brief the counters of every Vector<T, N> type used so far
+ */
+struct Report {
+    std::vector<Entry> entries;
+
+    /// entry of Vector<T, N> (all zero if it was not used)
+    template <typename T, size_t N>
+    Entry entry() const;
+
+    /// one line per type: the operations called at least once, flops and bytes
+    std::string text() const;
+    /// {"types": [{"type": "float", "size": 3, "calls": {"add": 2, ...}, "flops": 6, "bytes": 72}, ...]}
+    std::string json() const;
+};
+
+/**
+ * @brief merges the counters of all the threads (running and finished)
+ */
+Report report();
+
+/**
+ * @brief sets all the counters to 0
+ */
+void reset();
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+/// Vector<T, N> types with their own counters, the others share the last slot ("other")
+constexpr size_t maxTypes = 64;
+
+/// counters of one type in one thread: written by their thread only, read by report()
+struct TypeCounters {
+    std::array<std::atomic<uint64_t>, opCount> calls{};
+    std::atomic<uint64_t> flops{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+// single writer: a relaxed load and store, no locked instruction
+inline void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+struct ThreadCounters {
+    std::array<TypeCounters, maxTypes> types;
+
+    ThreadCounters();
+    ~ThreadCounters();
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> threads;
+    // counters of the finished threads
+    std::array<Entry, maxTypes> finished;
+    size_t typeCount{0};
+
+    size_t addType(std::string type, size_t size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (typeCount == maxTypes - 1) {
+            finished[typeCount].type = "other";
+            return typeCount;
+        }
+        finished[typeCount].type = std::move(type);
+        finished[typeCount].size = size;
+        return typeCount++;
+    }
+};
+
+// constructed before the first thread counters: destroyed after the counters of the main thread
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+inline void mergeInto(Entry& entry, const TypeCounters& counters) noexcept {
+    for (size_t op = 0; op < opCount; op++) {
+        entry.calls[op] += counters.calls[op].load(std::memory_order_relaxed);
+    }
+    entry.flops += counters.flops.load(std::memory_order_relaxed);
+    entry.bytes += counters.bytes.load(std::memory_order_relaxed);
+}
+
+inline ThreadCounters::ThreadCounters() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    shared.threads.push_back(this);
+}
+
+inline ThreadCounters::~ThreadCounters() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (size_t t = 0; t < maxTypes; t++) {
+        mergeInto(shared.finished[t], types[t]);
+    }
+    for (auto& thread : shared.threads) {
+        if (thread == this) {
+            thread = shared.threads.back();
+            shared.threads.pop_back();
+            break;
+        }
+    }
+}
+
+inline ThreadCounters& threadCounters() {
+    thread_local ThreadCounters counters;
+    return counters;
+}
+
+template <typename T>
+std::string typeName() {
+    if constexpr (std::is_same_v<T, float>) {
+        return "float";
+    } else if constexpr (std::is_same_v<T, double>) {
+        return "double";
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return "int" + std::to_string(8 * sizeof(T));
+    } else if constexpr (std::is_integral_v<T>) {
+        return "uint" + std::to_string(8 * sizeof(T));
+    } else {
+        return typeid(T).name();
+    }
+}
+
+/// counters slot of Vector<T, N>, assigned on first use
+template <typename T, size_t N>
+size_t typeSlot() {
+    static const size_t slot = registry().addType(typeName<T>(), N);
+    return slot;
+}
+
+template <typename T, size_t N>
+void count(Op op, uint64_t flops, uint64_t bytes) {
+    TypeCounters& counters = threadCounters().types[typeSlot<T, N>()];
+    add(counters.calls[static_cast<size_t>(op)], 1);
+    add(counters.flops, flops);
+    add(counters.bytes, bytes);
+}
+
+inline void appendCalls(std::ostringstream& out, const Entry& entry, bool json) {
+    bool first = true;
+    for (size_t op = 0; op < opCount; op++) {
+        if (entry.calls[op] == 0) {
+            continue;
+        }
+        out << (first ? "" : ", ");
+        if (json) {
+            out << '"' << opName(static_cast<Op>(op)) << "\": " << entry.calls[op];
+        } else {
+            out << opName(static_cast<Op>(op)) << ' ' << entry.calls[op];
+        }
+        first = false;
+    }
+}
+
+} // namespace detail
+
+inline Report report() {
+    detail::Registry& shared = detail::registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    const bool overflow = shared.finished[detail::maxTypes - 1].type == "other";
+    Report result;
+    for (size_t t = 0; t < shared.typeCount + (overflow ? 1 : 0); t++) {
+        Entry entry = shared.finished[t];
+        for (const auto* thread : shared.threads) {
+            detail::mergeInto(entry, thread->types[t]);
+        }
+        result.entries.push_back(std::move(entry));
+    }
+    return result;
+}
+
+inline void reset() {
+    detail::Registry& shared = detail::registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    for (auto& entry : shared.finished) {
+        entry.calls.fill(0);
+        entry.flops = 0;
+        entry.bytes = 0;
+    }
+    for (auto* thread : shared.threads) {
+        for (auto& counters : thread->types) {
+            for (auto& call : counters.calls) {
+                call.store(0, std::memory_order_relaxed);
+            }
+            counters.flops.store(0, std::memory_order_relaxed);
+            counters.bytes.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T, size_t N>
+Entry Report::entry() const {
+    const std::string type = detail::typeName<T>();
+    for (const auto& e : entries) {
+        if (e.type == type && e.size == N) {
+            return e;
+        }
+    }
+    Entry empty;
+    empty.type = type;
+    empty.size = N;
+    return empty;
+}
+
+inline std::string Report::text() const {
+    std::ostringstream out;
+    for (const auto& entry : entries) {
+        out << "Vector<" << entry.type << ", " << entry.size << ">: ";
+        detail::appendCalls(out, entry, false);
+        out << " | flops " << entry.flops << ", bytes " << entry.bytes << '\n';
+    }
+    return out.str();
+}
+
+inline std::string Report::json() const {
+    std::ostringstream out;
+    out << "{\"types\": [";
+    for (size_t e = 0; e < entries.size(); e++) {
+        const Entry& entry = entries[e];
+        out << (e == 0 ? "" : ", ") << "{\"type\": \"" << entry.type << "\", \"size\": " << entry.size
+            << ", \"calls\": {";
+        detail::appendCalls(out, entry, true);
+        out << "}, \"flops\": " << entry.flops << ", \"bytes\": " << entry.bytes << '}';
+    }
+    out << "]}";
+    return out.str();
+}
+
+#endif // VECTORND_PROFILE
+
+} // namespace profile
+
+} // namespace VectorND
+
+/**
+ * @brief counts an operation of Vector<T, N>, with its flops and bytes per element
+ * (nothing without VECTORND_PROFILE, and nothing inside constant expressions)
+ */
+#if defined(VECTORND_PROFILE)
+#define VECTORND_PROFILE_COUNT(T, N, op, flops, bytes)                                                         \
+    do {                                                                                                       \
+        if (!::VectorND::detail::isConstantEvaluated()) {                                                      \
+            ::VectorND::profile::detail::count<T, N>(::VectorND::profile::Op::op, (flops) * N, (bytes) * N);   \
+        }                                                                                                      \
+    } while (false)
+#else
+#define VECTORND_PROFILE_COUNT(T, N, op, flops, bytes) ((void)0)
+#endif
@@ -0,0 +1,564 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max
+#include <array>
+#include <cmath> // std::nearbyint, std::fabs
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+//* ------------------ integer code kernels ------------------ *//
+
+// The int8 codes are kept in [-127, 127] (symmetric quantization): |a| then fits an unsigned
+// byte and sign(b, a) a signed one, and the u8 x s8 multiply-adds (pmaddubsw, vpdpbusd) give
+// the exact products. The other kernels widen the codes to int16 first (pmaddwd), which is
+// exact for any code and zero point. The sums are int32: a block has at most 32768 codes.
+
+template <typename Code>
+constexpr int32_t codeMin = std::is_signed_v<Code> ? -127 : 0;
+
+template <typename Code>
+constexpr int32_t codeMax = std::is_signed_v<Code> ? 127 : 255;
+
+#if VECTORND_SIMD
+/// sum of the 4 int32 lanes
+inline int32_t hsumEpi32(__m128i x) {
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+    x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(x);
+}
+
+/// the 8 low (high) codes of x widened to int16
+template <typename Code>
+inline __m128i widenLow(__m128i x) {
+    if constexpr (std::is_signed_v<Code>) {
+        return _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+    } else {
+        return _mm_unpacklo_epi8(x, _mm_setzero_si128());
+    }
+}
+
+template <typename Code>
+inline __m128i widenHigh(__m128i x) {
+    if constexpr (std::is_signed_v<Code>) {
+        return _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+    } else {
+        return _mm_unpackhi_epi8(x, _mm_setzero_si128());
+    }
+}
+#endif
+
+#if defined(__AVX2__)
+inline int32_t hsumEpi32(__m256i x) {
+    return hsumEpi32(_mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+}
+
+/// 16 codes widened to int16
+template <typename Code>
+inline __m256i widen(__m128i x) {
+    if constexpr (std::is_signed_v<Code>) {
+        return _mm256_cvtepi8_epi16(x);
+    } else {
+        return _mm256_cvtepu8_epi16(x);
+    }
+}
+#endif
+
+#if defined(__AVX512BW__)
+inline int32_t hsumEpi32(__m512i x) {
+    // masked extracts, as in Avx512Float::hsum (the unmasked ones warn with GCC 12)
+    const __m256i low = _mm512_mask_extracti64x4_epi64(_mm256_setzero_si256(), 0xF, x, 0);
+    const __m256i high = _mm512_mask_extracti64x4_epi64(_mm256_setzero_si256(), 0xF, x, 1);
+    return hsumEpi32(_mm256_add_epi32(low, high));
+}
+
+/// 32 codes widened to int16
+template <typename Code>
+inline __m512i widen(__m256i x) {
+    if constexpr (std::is_signed_v<Code>) {
+        return _mm512_cvtepi8_epi16(x);
+    } else {
+        return _mm512_cvtepu8_epi16(x);
+    }
+}
+#endif
+
+/// the sums computed by widenedCodeKernel
+enum class CodeSum { products, squaredDiffs, moments };
+
+/// sums over n codes of (a - za) * (b - zb) (ab), (a - za)^2 (aa) and (b - zb)^2 (bb)
+struct CodeMoments {
+    int32_t ab;
+    int32_t aa;
+    int32_t bb;
+};
+
+/**
+ * @brief sum of a[i] * b[i] (and of a[i]^2 and b[i]^2 for Moments) over int8 codes in
+ * [-127, 127]: vpdpbusd (AVX-512 VNNI) or pmaddubsw of |a| and sign(b, a), 64 / 32 / 16
+ * codes per instruction
+ */
+template <bool Moments>
+inline CodeMoments symmetricCodeKernel(const int8_t* a, const int8_t* b, size_t n) {
+    size_t i = 0;
+    CodeMoments sums{0, 0, 0};
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    __m512i ab = _mm512_setzero_si512();
+    __m512i aa = _mm512_setzero_si512();
+    __m512i bb = _mm512_setzero_si512();
+    const auto accumulate = [&](__m512i x, __m512i y) {
+        const __m512i absX = _mm512_abs_epi8(x);
+        const __m512i signedY = _mm512_mask_sub_epi8(y, _mm512_movepi8_mask(x), _mm512_setzero_si512(), y);
+        ab = _mm512_dpbusd_epi32(ab, absX, signedY);
+        if constexpr (Moments) {
+            const __m512i absY = _mm512_abs_epi8(y);
+            aa = _mm512_dpbusd_epi32(aa, absX, absX);
+            bb = _mm512_dpbusd_epi32(bb, absY, absY);
+        }
+    };
+    for (; i + 64 <= n; i += 64) {
+        accumulate(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i));
+    }
+    if (i < n) {
+        const __mmask64 mask = (__mmask64{1} << (n - i)) - 1;
+        accumulate(_mm512_maskz_loadu_epi8(mask, a + i), _mm512_maskz_loadu_epi8(mask, b + i));
+        i = n;
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#elif defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i ab = _mm256_setzero_si256();
+    __m256i aa = _mm256_setzero_si256();
+    __m256i bb = _mm256_setzero_si256();
+    for (; i + 32 <= n; i += 32) {
+        const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i absX = _mm256_abs_epi8(x);
+        ab = _mm256_add_epi32(ab, _mm256_madd_epi16(_mm256_maddubs_epi16(absX, _mm256_sign_epi8(y, x)), ones));
+        if constexpr (Moments) {
+            const __m256i absY = _mm256_abs_epi8(y);
+            aa = _mm256_add_epi32(aa, _mm256_madd_epi16(_mm256_maddubs_epi16(absX, absX), ones));
+            bb = _mm256_add_epi32(bb, _mm256_madd_epi16(_mm256_maddubs_epi16(absY, absY), ones));
+        }
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#elif defined(__SSSE3__)
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i ab = _mm_setzero_si128();
+    __m128i aa = _mm_setzero_si128();
+    __m128i bb = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        const __m128i absX = _mm_abs_epi8(x);
+        ab = _mm_add_epi32(ab, _mm_madd_epi16(_mm_maddubs_epi16(absX, _mm_sign_epi8(y, x)), ones));
+        if constexpr (Moments) {
+            const __m128i absY = _mm_abs_epi8(y);
+            aa = _mm_add_epi32(aa, _mm_madd_epi16(_mm_maddubs_epi16(absX, absX), ones));
+            bb = _mm_add_epi32(bb, _mm_madd_epi16(_mm_maddubs_epi16(absY, absY), ones));
+        }
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#endif
+    for (; i < n; i++) {
+        sums.ab += static_cast<int32_t>(a[i]) * b[i];
+        sums.aa += static_cast<int32_t>(a[i]) * a[i];
+        sums.bb += static_cast<int32_t>(b[i]) * b[i];
+    }
+    return sums;
+}
+
+/**
+ * @brief the codes widened to int16 and multiplied-added in pairs (pmaddwd), in a single pass:
+ *  - products: ab
+ *  - squaredDiffs: the sum of (a[i] - b[i])^2 in ab
+ *  - moments: ab, aa and bb
+ */
+template <CodeSum Sum, typename Code>
+inline CodeMoments widenedCodeKernel(const Code* a, int32_t za, const Code* b, int32_t zb, size_t n) {
+    size_t i = 0;
+    CodeMoments sums{0, 0, 0};
+#if defined(__AVX512BW__)
+    const __m512i zeroA = _mm512_set1_epi16(static_cast<int16_t>(za));
+    const __m512i zeroB = _mm512_set1_epi16(static_cast<int16_t>(zb));
+    __m512i ab = _mm512_setzero_si512();
+    __m512i aa = _mm512_setzero_si512();
+    __m512i bb = _mm512_setzero_si512();
+    for (; i + 32 <= n; i += 32) {
+        const __m512i x = widen<Code>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)));
+        const __m512i y = widen<Code>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if constexpr (Sum == CodeSum::squaredDiffs) {
+            const __m512i d = _mm512_sub_epi16(x, y);
+            ab = _mm512_add_epi32(ab, _mm512_madd_epi16(d, d));
+        } else {
+            const __m512i u = _mm512_sub_epi16(x, zeroA);
+            const __m512i v = _mm512_sub_epi16(y, zeroB);
+            ab = _mm512_add_epi32(ab, _mm512_madd_epi16(u, v));
+            if constexpr (Sum == CodeSum::moments) {
+                aa = _mm512_add_epi32(aa, _mm512_madd_epi16(u, u));
+                bb = _mm512_add_epi32(bb, _mm512_madd_epi16(v, v));
+            }
+        }
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#elif defined(__AVX2__)
+    const __m256i zeroA = _mm256_set1_epi16(static_cast<int16_t>(za));
+    const __m256i zeroB = _mm256_set1_epi16(static_cast<int16_t>(zb));
+    __m256i ab = _mm256_setzero_si256();
+    __m256i aa = _mm256_setzero_si256();
+    __m256i bb = _mm256_setzero_si256();
+    for (; i + 16 <= n; i += 16) {
+        const __m256i x = widen<Code>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+        const __m256i y = widen<Code>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if constexpr (Sum == CodeSum::squaredDiffs) {
+            const __m256i d = _mm256_sub_epi16(x, y);
+            ab = _mm256_add_epi32(ab, _mm256_madd_epi16(d, d));
+        } else {
+            const __m256i u = _mm256_sub_epi16(x, zeroA);
+            const __m256i v = _mm256_sub_epi16(y, zeroB);
+            ab = _mm256_add_epi32(ab, _mm256_madd_epi16(u, v));
+            if constexpr (Sum == CodeSum::moments) {
+                aa = _mm256_add_epi32(aa, _mm256_madd_epi16(u, u));
+                bb = _mm256_add_epi32(bb, _mm256_madd_epi16(v, v));
+            }
+        }
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#elif VECTORND_SIMD
+    const __m128i zeroA = _mm_set1_epi16(static_cast<int16_t>(za));
+    const __m128i zeroB = _mm_set1_epi16(static_cast<int16_t>(zb));
+    __m128i ab = _mm_setzero_si128();
+    __m128i aa = _mm_setzero_si128();
+    __m128i bb = _mm_setzero_si128();
+    const auto accumulate = [&](__m128i x, __m128i y) {
+        if constexpr (Sum == CodeSum::squaredDiffs) {
+            const __m128i d = _mm_sub_epi16(x, y);
+            ab = _mm_add_epi32(ab, _mm_madd_epi16(d, d));
+        } else {
+            const __m128i u = _mm_sub_epi16(x, zeroA);
+            const __m128i v = _mm_sub_epi16(y, zeroB);
+            ab = _mm_add_epi32(ab, _mm_madd_epi16(u, v));
+            if constexpr (Sum == CodeSum::moments) {
+                aa = _mm_add_epi32(aa, _mm_madd_epi16(u, u));
+                bb = _mm_add_epi32(bb, _mm_madd_epi16(v, v));
+            }
+        }
+    };
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        accumulate(widenLow<Code>(x), widenLow<Code>(y));
+        accumulate(widenHigh<Code>(x), widenHigh<Code>(y));
+    }
+    sums = {hsumEpi32(ab), hsumEpi32(aa), hsumEpi32(bb)};
+#endif
+    for (; i < n; i++) {
+        if constexpr (Sum == CodeSum::squaredDiffs) {
+            const int32_t d = static_cast<int32_t>(a[i]) - b[i];
+            sums.ab += d * d;
+        } else {
+            const int32_t u = static_cast<int32_t>(a[i]) - za;
+            const int32_t v = static_cast<int32_t>(b[i]) - zb;
+            sums.ab += u * v;
+            sums.aa += u * u;
+            sums.bb += v * v;
+        }
+    }
+    return sums;
+}
+
+/// true when symmetricCodeKernel has a SIMD path (SSSE3 and above): with SSE2 only it is scalar,
+/// while the pmaddwd path of widenedCodeKernel is exact for every zero point
+#if defined(__SSSE3__)
+constexpr bool hasSymmetricCodeKernel = true;
+#else
+constexpr bool hasSymmetricCodeKernel = false;
+#endif
+
+/// sum of (a[i] - za) * (b[i] - zb) over n codes, in int32
+template <typename Code>
+inline int32_t sumCodeProducts(const Code* a, int32_t za, const Code* b, int32_t zb, size_t n) {
+    if constexpr (std::is_signed_v<Code> && hasSymmetricCodeKernel) {
+        if (za == 0 && zb == 0) {
+            return symmetricCodeKernel<false>(a, b, n).ab;
+        }
+    }
+    return widenedCodeKernel<CodeSum::products>(a, za, b, zb, n).ab;
+}
+
+/// sum of (a[i] - b[i])^2 over n codes, in int32
+template <typename Code>
+inline int32_t sumCodeSquaredDiffs(const Code* a, const Code* b, size_t n) {
+    return widenedCodeKernel<CodeSum::squaredDiffs>(a, 0, b, 0, n).ab;
+}
+
+/// the products and the squares of (a[i] - za) and (b[i] - zb) over n codes, in a single pass
+template <typename Code>
+inline CodeMoments sumCodeMoments(const Code* a, int32_t za, const Code* b, int32_t zb, size_t n) {
+    if constexpr (std::is_signed_v<Code> && hasSymmetricCodeKernel) {
+        if (za == 0 && zb == 0) {
+            return symmetricCodeKernel<true>(a, b, n);
+        }
+    }
+    return widenedCodeKernel<CodeSum::moments>(a, za, b, zb, n);
+}
+
+} // namespace detail
+
+/**
+ * @brief Vector<float, N> stored as 8 bits codes: x[i] = scale * (code[i] - zeroPoint), with a
+ * scale and a zero point per block of Block elements (a single block by default).
+ *
+ *  - int8_t codes: symmetric quantization, zero point 0 and codes in [-127, 127]
+ *  - uint8_t codes: affine quantization of [min, max] (0 included) on [0, 255]
+ *
+ * A vector takes N bytes and 5 bytes per block instead of 4 N bytes. The products of the
+ * codes are accumulated in int32 (exactly), the scales are applied once per block: the dot
+ * products and the distances only carry the quantization error.
+ *
+ * @tparam N the number of elements
+ * @tparam Code int8_t or uint8_t
+ * @tparam Block the number of elements sharing a scale and a zero point
+ */
+template <size_t N, typename Code = int8_t, size_t Block = N>
+class QuantizedVector
+{
+    static_assert(std::is_same_v<Code, int8_t> || std::is_same_v<Code, uint8_t>, "the codes are int8_t or uint8_t");
+    static_assert(Block > 0 && Block <= N, "invalid block size");
+    static_assert(Block <= 32768, "the int32 sums of a block would overflow");
+public:
+    using code_type = Code;
+    static constexpr size_t size = N;
+    static constexpr size_t blockSize = Block;
+    static constexpr size_t blockCount = (N + Block - 1) / Block;
+private:
+    std::array<Code, N> codeArray;
+    std::array<float, blockCount> scaleArray;
+    std::array<Code, blockCount> zeroPointArray;
+
+    void quantizeBlock(const float* values, size_t block);
+public:
+    /// null vector (scales 0)
+    QuantizedVector(): codeArray{}, scaleArray{}, zeroPointArray{} {}
+
+    /**
+     * @brief lossy conversion of a float vector: each element is rounded to the nearest
+     * code, the error is at most scale / 2
+     *
+     * @param vector
+     */
+    explicit QuantizedVector(const Vector<float, N>& vector);
+
+    /**
+     * @brief vector from its codes and quantization parameters (to load saved vectors)
+     *
+     * @param codes int8_t codes in [-127, 127]
+     * @param scales one per block
+     * @param zeroPoints one per block
+     * @throw std::invalid_argument if a code is -128
+     */
+    QuantizedVector(const std::array<Code, N>& codes, const std::array<float, blockCount>& scales,
+                    const std::array<Code, blockCount>& zeroPoints);
+
+    /**
+     * @brief the float vector represented by the codes
+     *
+     * @return Vector<float, N>
+     */
+    Vector<float, N> dequantize() const;
+
+    /// the value of the i-th element
+    inline float operator[](size_t i) const {
+        const size_t block = i / Block;
+        return scaleArray[block] * static_cast<float>(static_cast<int32_t>(codeArray[i]) - zeroPointArray[block]);
+    }
+
+    inline const std::array<Code, N>& codes() const { return codeArray; }
+    inline float scale(size_t block = 0) const { return scaleArray[block]; }
+    inline int32_t zeroPoint(size_t block = 0) const { return zeroPointArray[block]; }
+
+    /**
+     * @brief dot product, the codes multiplied in int32
+     *
+     * @param otherVector
+     * @return float
+     */
+    float dot(const QuantizedVector& otherVector) const;
+
+    /**
+     * @brief squared distance, exact on the codes when the 2 vectors have the same scale and
+     * zero point (quantized with shared parameters), from the norms and the dot product else
+     *
+     * @param otherVector
+     * @return double
+     */
+    double squaredDist(const QuantizedVector& otherVector) const;
+
+    inline double dist(const QuantizedVector& otherVector) const { return std::sqrt(squaredDist(otherVector)); }
+
+    double squaredNorm() const;
+
+    inline double norm() const { return std::sqrt(squaredNorm()); }
+};
+
+template <size_t N, typename Code, size_t Block>
+inline float dot(const QuantizedVector<N, Code, Block>& a, const QuantizedVector<N, Code, Block>& b) {
+    return a.dot(b);
+}
+
+template <size_t N, typename Code, size_t Block>
+inline double squaredDist(const QuantizedVector<N, Code, Block>& a, const QuantizedVector<N, Code, Block>& b) {
+    return a.squaredDist(b);
+}
+
+template <size_t N, typename Code, size_t Block>
+inline double dist(const QuantizedVector<N, Code, Block>& a, const QuantizedVector<N, Code, Block>& b) {
+    return a.dist(b);
+}
+
+/**
+ * @brief quantizes count vectors in parallel: out[i] = Q(vectors[i])
+ *
+ * @tparam Q QuantizedVector<N, Code, Block>
+ * @param vectors
+ * @param count
+ * @param out
+ */
+template <typename Q, size_t N>
+void quantize(const Vector<float, N>* vectors, size_t count, Q* out);
+
+template <typename Q, size_t N>
+std::vector<Q> quantize(const std::vector<Vector<float, N>>& vectors) {
+    std::vector<Q> out(vectors.size());
+    quantize(vectors.data(), vectors.size(), out.data());
+    return out;
+}
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <size_t N, typename Code, size_t Block>
+QuantizedVector<N, Code, Block>::QuantizedVector(const Vector<float, N>& vector) {
+    for (size_t block = 0; block < blockCount; block++) {
+        quantizeBlock(vector.cbegin() + block * Block, block);
+    }
+}
+
+template <size_t N, typename Code, size_t Block>
+QuantizedVector<N, Code, Block>::QuantizedVector(const std::array<Code, N>& codes,
+                                                 const std::array<float, blockCount>& scales,
+                                                 const std::array<Code, blockCount>& zeroPoints)
+    : codeArray{codes}, scaleArray{scales}, zeroPointArray{zeroPoints} {
+    for (Code code : codes) {
+        if (code < detail::codeMin<Code>) {
+            throw std::invalid_argument("VectorND: the int8 codes must be in [-127, 127]");
+        }
+    }
+}
+
+// the scale maps the largest magnitude (int8) or the range (uint8) of the block on the codes
+
+template <size_t N, typename Code, size_t Block>
+void QuantizedVector<N, Code, Block>::quantizeBlock(const float* values, size_t block) {
+    const size_t n = std::min(Block, N - block * Block);
+    float low = 0;
+    float high = 0;
+    for (size_t i = 0; i < n; i++) {
+        low = std::min(low, values[i]);
+        high = std::max(high, values[i]);
+    }
+    float scale = 0;
+    int32_t zeroPoint = 0;
+    if constexpr (std::is_signed_v<Code>) {
+        scale = std::max(-low, high) / detail::codeMax<Code>;
+    } else {
+        scale = (high - low) / detail::codeMax<Code>;
+        if (scale > 0) {
+            zeroPoint = static_cast<int32_t>(std::nearbyint(-low / scale));
+            zeroPoint = std::min(std::max(zeroPoint, detail::codeMin<Code>), detail::codeMax<Code>);
+        }
+    }
+    const float inverse = scale > 0 ? 1 / scale : 0;
+    Code* codes = codeArray.data() + block * Block;
+    for (size_t i = 0; i < n; i++) {
+        const int32_t code = static_cast<int32_t>(std::nearbyint(values[i] * inverse)) + zeroPoint;
+        codes[i] = static_cast<Code>(std::min(std::max(code, detail::codeMin<Code>), detail::codeMax<Code>));
+    }
+    scaleArray[block] = scale;
+    zeroPointArray[block] = static_cast<Code>(zeroPoint);
+}
+
+template <size_t N, typename Code, size_t Block>
+Vector<float, N> QuantizedVector<N, Code, Block>::dequantize() const {
+    Vector<float, N> vector;
+    for (size_t i = 0; i < N; i++) {
+        vector[i] = (*this)[i];
+    }
+    return vector;
+}
+
+template <size_t N, typename Code, size_t Block>
+float QuantizedVector<N, Code, Block>::dot(const QuantizedVector& otherVector) const {
+    double sum = 0;
+    for (size_t block = 0; block < blockCount; block++) {
+        const size_t begin = block * Block;
+        const int32_t products = detail::sumCodeProducts(codeArray.data() + begin, zeroPoint(block),
+                                                         otherVector.codeArray.data() + begin,
+                                                         otherVector.zeroPoint(block), std::min(Block, N - begin));
+        sum += static_cast<double>(scaleArray[block]) * otherVector.scaleArray[block] * products;
+    }
+    return static_cast<float>(sum);
+}
+
+template <size_t N, typename Code, size_t Block>
+double QuantizedVector<N, Code, Block>::squaredDist(const QuantizedVector& otherVector) const {
+    double sum = 0;
+    for (size_t block = 0; block < blockCount; block++) {
+        const size_t begin = block * Block;
+        const size_t n = std::min(Block, N - begin);
+        const Code* a = codeArray.data() + begin;
+        const Code* b = otherVector.codeArray.data() + begin;
+        const double sa = scaleArray[block];
+        const double sb = otherVector.scaleArray[block];
+        const int32_t za = zeroPoint(block);
+        const int32_t zb = otherVector.zeroPoint(block);
+        if (sa == sb && za == zb) {
+            sum += sa * sa * detail::sumCodeSquaredDiffs(a, b, n);
+        } else {
+            const detail::CodeMoments m = detail::sumCodeMoments(a, za, b, zb, n);
+            sum += std::max(sa * sa * m.aa + sb * sb * m.bb - 2 * sa * sb * m.ab, 0.0);
+        }
+    }
+    return sum;
+}
+
+template <size_t N, typename Code, size_t Block>
+double QuantizedVector<N, Code, Block>::squaredNorm() const {
+    double sum = 0;
+    for (size_t block = 0; block < blockCount; block++) {
+        const size_t begin = block * Block;
+        const Code* a = codeArray.data() + begin;
+        const double scale = scaleArray[block];
+        sum += scale * scale * detail::sumCodeProducts(a, zeroPoint(block), a, zeroPoint(block), std::min(Block, N - begin));
+    }
+    return sum;
+}
+
+template <typename Q, size_t N>
+void quantize(const Vector<float, N>* vectors, size_t count, Q* out) {
+    static_assert(Q::size == N, "the quantized vectors must have N elements");
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        out[i] = Q(vectors[i]);
+    }
+}
+
+}
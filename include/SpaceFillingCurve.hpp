@@ -0,0 +1,370 @@
+#pragma once
+
+#include <algorithm> // std::min, std::max, std::fill
+#include <array>
+#include <cstdint>
+#include <numeric> // std::iota
+#include <vector>
+
+#if defined(__BMI2__)
+#include <immintrin.h> // _pdep_u64
+#endif
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief axis aligned box [lower, upper] quantized by the space filling curves
+ */
+template <typename T, size_t N>
+struct Bounds {
+    Vector<T, N> lower;
+    Vector<T, N> upper;
+};
+
+/**
+ * @brief space filling curve of sortByCurve
+ */
+enum class Curve {
+    Morton, ///< Z-order: interleaved bits, cheapest to compute
+    Hilbert ///< consecutive cells are neighbors: better locality, slower to compute
+};
+
+/// bits per coordinate of the curve codes: the N coordinates fill a 64 bits code (32 in 2D, 21 in 3D)
+template <size_t N>
+constexpr unsigned curveBits = 64 / N;
+
+/**
+ * @brief smallest box containing the points
+ */
+template <typename T, size_t N>
+Bounds<T, N> boundsOf(const Vector<T, N>* points, size_t count);
+
+/**
+ * @brief position of a point on the Morton curve (Z-order) of the box.
+ *
+ * The box is divided in 2^curveBits<N> cells in each dimension (points outside are clamped to the
+ * border cells) and the bits of the cell coordinates are interleaved, coordinate 0 in the lowest bit.
+ * Uses the BMI2 pdep instruction when it is enabled at compile time (-mbmi2, -march=haswell),
+ * a table otherwise.
+ *
+ * @tparam N 2 or 3
+ */
+template <typename T, size_t N>
+uint64_t mortonCode(const Vector<T, N>& v, const Bounds<T, N>& bounds);
+
+/**
+ * @brief position of a point on the Hilbert curve of the box, with the cells of mortonCode.
+ * Consecutive codes are neighbor cells.
+ *
+ * @tparam N 2 or 3
+ */
+template <typename T, size_t N>
+uint64_t hilbertCode(const Vector<T, N>& v, const Bounds<T, N>& bounds);
+
+/**
+ * @brief out[i] = curve code of points[i], on several threads
+ */
+template <typename T, size_t N>
+void curveCodes(const Vector<T, N>* points, size_t count, const Bounds<T, N>& bounds, Curve curve, uint64_t* out);
+
+/**
+ * @brief reorders the points along a space filling curve of their bounding box, so that points
+ * close in space are close in memory (before neighbor searches, stencil sweeps...).
+ *
+ * Parallel LSD radix sort of the codes, skipping the digits common to all the codes.
+ * The sort is stable.
+ *
+ * @param permutation if not null, count values: permutation[i] = index in the input of the
+ * point now at i, to reorder the data attached to the points (see reorder)
+ */
+template <typename T, size_t N>
+void sortByCurve(Vector<T, N>* points, size_t count, Curve curve = Curve::Hilbert, size_t* permutation = nullptr);
+
+/**
+ * @brief sortByCurve of a vector of points
+ * @return std::vector<size_t> the permutation: index in the input of each sorted point
+ */
+template <typename T, size_t N>
+std::vector<size_t> sortByCurve(std::vector<Vector<T, N>>& points, Curve curve = Curve::Hilbert);
+
+/**
+ * @brief values[i] = old values[permutation[i]]: applies the permutation of sortByCurve to a payload
+ */
+template <typename U>
+void reorder(std::vector<U>& values, const std::vector<size_t>& permutation);
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+/// bits of the lowest cell coordinate in a Morton code
+template <size_t N>
+constexpr uint64_t mortonMask() {
+    uint64_t mask = 0;
+    for (unsigned bit = 0; bit < curveBits<N>; bit++) {
+        mask |= uint64_t{1} << (bit * N);
+    }
+    return mask;
+}
+
+/// spreadTable<N>[b] = bits of the byte b moved N - 1 bits apart
+template <size_t N>
+constexpr std::array<uint64_t, 256> makeSpreadTable() {
+    std::array<uint64_t, 256> table{};
+    for (uint64_t byte = 0; byte < 256; byte++) {
+        for (unsigned bit = 0; bit < 8; bit++) {
+            table[byte] |= ((byte >> bit) & 1) << (bit * N);
+        }
+    }
+    return table;
+}
+
+template <size_t N>
+constexpr std::array<uint64_t, 256> spreadTable = makeSpreadTable<N>();
+
+/**
+ * @brief bits of x (the lowest curveBits<N>) moved N - 1 bits apart, by bytes with a table
+ */
+template <size_t N>
+inline uint64_t spreadBitsTable(uint32_t x) noexcept {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < curveBits<N>; shift += 8) {
+        result |= spreadTable<N>[(x >> shift) & 0xff] << (shift * N);
+    }
+    return result & mortonMask<N>();
+}
+
+/**
+ * @brief bits of x (the lowest curveBits<N>) moved N - 1 bits apart
+ */
+template <size_t N>
+inline uint64_t spreadBits(uint32_t x) noexcept {
+#if defined(__BMI2__)
+    return _pdep_u64(x, mortonMask<N>());
+#else
+    return spreadBitsTable<N>(x);
+#endif
+}
+
+/**
+ * @brief cell of v in the box, each coordinate in [0, 2^curveBits<N>)
+ */
+template <typename T, size_t N>
+inline std::array<uint32_t, N> curveCell(const Vector<T, N>& v, const Bounds<T, N>& bounds) noexcept {
+    constexpr double cells = static_cast<double>(uint64_t{1} << curveBits<N>);
+    std::array<uint32_t, N> cell;
+    for (size_t d = 0; d < N; d++) {
+        const double extent = static_cast<double>(bounds.upper[d]) - static_cast<double>(bounds.lower[d]);
+        const double position = extent > 0
+            ? (static_cast<double>(v[d]) - static_cast<double>(bounds.lower[d])) / extent * cells
+            : 0.0;
+        // (NaN goes to the first cell)
+        cell[d] = position > 0 ? static_cast<uint32_t>(std::min(position, cells - 1)) : 0;
+    }
+    return cell;
+}
+
+/**
+ * @brief interleaved bits of the cell coordinates, coordinate 0 in the lowest bit
+ */
+template <size_t N>
+inline uint64_t interleave(const std::array<uint32_t, N>& cell) noexcept {
+    uint64_t code = 0;
+    for (size_t d = 0; d < N; d++) {
+        code |= spreadBits<N>(cell[d]) << d;
+    }
+    return code;
+}
+
+/**
+ * @brief Hilbert index of a cell of a grid of 2^bits cells per dimension
+ * (J. Skilling, "Programming the Hilbert curve", 2004): the coordinates are transformed in place
+ * into the "transposed" index, whose interleaved bits are the index (coordinate 0 most significant).
+ */
+template <size_t N>
+inline uint64_t hilbertIndex(std::array<uint32_t, N> x, unsigned bits) noexcept {
+    const uint32_t top = uint32_t{1} << (bits - 1);
+    // inverse undo of the rotations and reflections
+    for (uint32_t q = top; q > 1; q >>= 1) {
+        const uint32_t p = q - 1;
+        for (size_t d = 0; d < N; d++) {
+            if (x[d] & q) {
+                x[0] ^= p;
+            } else {
+                const uint32_t t = (x[0] ^ x[d]) & p;
+                x[0] ^= t;
+                x[d] ^= t;
+            }
+        }
+    }
+    // Gray encode
+    for (size_t d = 1; d < N; d++) {
+        x[d] ^= x[d - 1];
+    }
+    uint32_t t = 0;
+    for (uint32_t q = top; q > 1; q >>= 1) {
+        if (x[N - 1] & q) {
+            t ^= q - 1;
+        }
+    }
+    uint64_t code = 0;
+    for (size_t d = 0; d < N; d++) {
+        code |= spreadBits<N>(x[d] ^ t) << (N - 1 - d);
+    }
+    return code;
+}
+
+/// codes sorted by a task of the radix sort: small sorts stay on one thread
+constexpr size_t radixTaskSize = 16384;
+/// bits of a radix digit: 6 passes over 64 bits codes (scattering 2048 buckets costs about as
+/// much as 256, the passes are bound by memory)
+constexpr unsigned radixDigitBits = 11;
+constexpr size_t radixBuckets = size_t{1} << radixDigitBits;
+
+/**
+ * @brief stable LSD radix sort of (keys, values) by digits of radixDigitBits, on several threads:
+ * each task counts the digits of a fixed chunk, then scatters it at its offsets. The digits
+ * equal in all the keys are skipped.
+ */
+inline void radixSort(std::vector<uint64_t>& keys, std::vector<size_t>& values) {
+    const size_t count = keys.size();
+    uint64_t anyBits = 0;
+    uint64_t allBits = ~uint64_t{0};
+    for (uint64_t key : keys) {
+        anyBits |= key;
+        allBits &= key;
+    }
+    const uint64_t varying = anyBits ^ allBits;
+    if (varying == 0) {
+        return;
+    }
+
+    const size_t tasks = std::max<size_t>(1, std::min(parallel::threadCount(), count / radixTaskSize));
+    const size_t chunk = (count + tasks - 1) / tasks;
+    std::vector<uint64_t> keysOut(count);
+    std::vector<size_t> valuesOut(count);
+    std::vector<size_t> offsets(tasks * radixBuckets);
+    constexpr uint64_t digitMask = radixBuckets - 1;
+
+    for (unsigned shift = 0; shift < 64; shift += radixDigitBits) {
+        if (((varying >> shift) & digitMask) == 0) {
+            continue;
+        }
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t task = 0; task < tasks; task++) {
+            size_t* histogram = &offsets[task * radixBuckets];
+            std::fill(histogram, histogram + radixBuckets, 0);
+            const size_t end = std::min(count, (task + 1) * chunk);
+            for (size_t i = task * chunk; i < end; i++) {
+                histogram[(keys[i] >> shift) & digitMask]++;
+            }
+        }
+        // offset of each (digit, task), the tasks of a digit in input order: the sort is stable
+        size_t offset = 0;
+        for (size_t digit = 0; digit < radixBuckets; digit++) {
+            for (size_t task = 0; task < tasks; task++) {
+                const size_t n = offsets[task * radixBuckets + digit];
+                offsets[task * radixBuckets + digit] = offset;
+                offset += n;
+            }
+        }
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t task = 0; task < tasks; task++) {
+            size_t* next = &offsets[task * radixBuckets];
+            const size_t end = std::min(count, (task + 1) * chunk);
+            for (size_t i = task * chunk; i < end; i++) {
+                const size_t slot = next[(keys[i] >> shift) & digitMask]++;
+                keysOut[slot] = keys[i];
+                valuesOut[slot] = values[i];
+            }
+        }
+        keys.swap(keysOut);
+        values.swap(valuesOut);
+    }
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+Bounds<T, N> boundsOf(const Vector<T, N>* points, size_t count) {
+    Bounds<T, N> bounds;
+    if (count == 0) {
+        return bounds;
+    }
+    bounds.lower = points[0];
+    bounds.upper = points[0];
+    for (size_t i = 1; i < count; i++) {
+        for (size_t d = 0; d < N; d++) {
+            bounds.lower[d] = std::min(bounds.lower[d], points[i][d]);
+            bounds.upper[d] = std::max(bounds.upper[d], points[i][d]);
+        }
+    }
+    return bounds;
+}
+
+template <typename T, size_t N>
+uint64_t mortonCode(const Vector<T, N>& v, const Bounds<T, N>& bounds) {
+    static_assert(N == 2 || N == 3, "the space filling curves are defined for N = 2 and 3");
+    return detail::interleave<N>(detail::curveCell(v, bounds));
+}
+
+template <typename T, size_t N>
+uint64_t hilbertCode(const Vector<T, N>& v, const Bounds<T, N>& bounds) {
+    static_assert(N == 2 || N == 3, "the space filling curves are defined for N = 2 and 3");
+    return detail::hilbertIndex<N>(detail::curveCell(v, bounds), curveBits<N>);
+}
+
+template <typename T, size_t N>
+void curveCodes(const Vector<T, N>* points, size_t count, const Bounds<T, N>& bounds, Curve curve, uint64_t* out) {
+    if (curve == Curve::Morton) {
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t i = 0; i < count; i++) {
+            out[i] = mortonCode(points[i], bounds);
+        }
+    } else {
+        VECTORND_OMP(parallel for schedule(static))
+        for (size_t i = 0; i < count; i++) {
+            out[i] = hilbertCode(points[i], bounds);
+        }
+    }
+}
+
+template <typename T, size_t N>
+void sortByCurve(Vector<T, N>* points, size_t count, Curve curve, size_t* permutation) {
+    std::vector<uint64_t> codes(count);
+    curveCodes(points, count, boundsOf(points, count), curve, codes.data());
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), size_t{0});
+    detail::radixSort(codes, order);
+
+    const std::vector<Vector<T, N>> input(points, points + count);
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        points[i] = input[order[i]];
+    }
+    if (permutation != nullptr) {
+        std::copy(order.begin(), order.end(), permutation);
+    }
+}
+
+template <typename T, size_t N>
+std::vector<size_t> sortByCurve(std::vector<Vector<T, N>>& points, Curve curve) {
+    std::vector<size_t> permutation(points.size());
+    sortByCurve(points.data(), points.size(), curve, permutation.data());
+    return permutation;
+}
+
+template <typename U>
+void reorder(std::vector<U>& values, const std::vector<size_t>& permutation) {
+    std::vector<U> reordered;
+    reordered.reserve(permutation.size());
+    for (size_t index : permutation) {
+        reordered.push_back(std::move(values[index]));
+    }
+    values = std::move(reordered);
+}
+
+} // namespace VectorND
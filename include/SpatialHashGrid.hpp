@@ -0,0 +1,411 @@
+#pragma once
+
+#include <algorithm> // std::sort, std::unique, std::min
+#include <array>
+#include <cmath> // std::floor, std::ceil
+#include <cstdint>
+#include <type_traits>
+#include <utility> // std::pair
+#include <vector>
+
+#include "Vector.hpp"
+#include "TopK.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief uniform grid binning Vector<T, N> points into cells of a given size, for fixed-radius
+ * queries: the neighbors of a point within r, and all the pairs within r (broad-phase).
+ *
+ * The cells of an unbounded space are hashed into a table of about twice the number of points.
+ * In periodic mode (a box [0, box) in each dimension) the coordinates are wrapped with
+ * Vector::mod, the grid is dense, and the distances use the minimum image convention
+ * (valid for a radius up to half the box).
+ *
+ * rebuild() sorts the points by bucket with a counting sort into flat arrays, reusing the memory
+ * of the previous step: call it once per time step.
+ *
+ * @tparam T the type of the elements (floating point)
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class SpatialHashGrid
+{
+    static_assert(std::is_floating_point_v<T>, "the spatial hash grid needs a floating point type");
+private:
+    using Cell = std::array<int64_t, N>;
+
+    T width;
+    bool wrap{false};
+    Vector<T, N> box;
+    // periodic mode: number of cells and width of a cell in each dimension
+    std::array<int64_t, N> cells{};
+    Vector<T, N> cellWidth;
+
+    // points of bucket b: [bucketStart[b], bucketStart[b + 1]) of the sorted arrays
+    std::vector<size_t> bucketStart;
+    // points (wrapped in periodic mode) and their index in the input, sorted by bucket
+    std::vector<Vector<T, N>> sortedPoints;
+    std::vector<size_t> sortedIndices;
+    // rebuild buffers: bucket and wrapped position of each input point, next slot of each bucket
+    std::vector<size_t> pointBucket;
+    std::vector<Vector<T, N>> wrapped;
+    std::vector<size_t> bucketNext;
+
+    // bucket rows processed by a task of the parallel pair iteration
+    static constexpr size_t pairBlock = 64;
+
+    Cell cellOf(const Vector<T, N>& p) const;
+    size_t bucketOf(const Cell& cell) const;
+    // sorted distinct buckets of the cells at most reach cells away from cell
+    void neighborBuckets(const Cell& cell, int64_t reach, std::vector<size_t>& out) const;
+    // number of cells a radius covers
+    int64_t reachOf(T radius) const;
+    // pairs with a point of bucket b (the other point in bucket >= b)
+    template <typename F>
+    void pairsOfBucket(size_t b, T radius, int64_t reach, std::vector<size_t>& buckets, F& f) const;
+public:
+    /**
+     * @brief grid of an unbounded space
+     *
+     * @param cellSize width of the cells (typically the query radius)
+     */
+    explicit SpatialHashGrid(T cellSize): width{cellSize} {}
+
+    /**
+     * @brief grid of the periodic box [0, box[0]) x ... x [0, box[N - 1])
+     *
+     * @param cellSize minimum width of the cells (the box is divided in a whole number of cells)
+     * @param box size of the box
+     */
+    SpatialHashGrid(T cellSize, const Vector<T, N>& box);
+
+    /// width of the cells
+    inline T cellSize() const noexcept { return width; }
+
+    inline bool periodic() const noexcept { return wrap; }
+
+    /// number of points
+    inline size_t count() const noexcept { return sortedPoints.size(); }
+
+    /**
+     * @brief sort a new set of points into the grid (the points are copied)
+     *
+     * @param points
+     * @param count
+     */
+    void rebuild(const Vector<T, N>* points, size_t count);
+
+    void rebuild(const std::vector<Vector<T, N>>& points) { rebuild(points.data(), points.size()); }
+
+    /**
+     * @brief b - a, the minimum image in periodic mode
+     *
+     * @param a
+     * @param b
+     * @return Vector<T, N>
+     */
+    Vector<T, N> displacement(const Vector<T, N>& a, const Vector<T, N>& b) const;
+
+    /**
+     * @brief squared distance, the minimum image in periodic mode
+     */
+    inline T squaredDist(const Vector<T, N>& a, const Vector<T, N>& b) const {
+        const Vector<T, N> d = displacement(a, b);
+        return d.dot(d);
+    }
+
+    /**
+     * @brief call f(index, squaredDistance) for each point at a distance <= radius of p
+     *
+     * @param p
+     * @param radius
+     * @param f
+     */
+    template <typename F>
+    void forEachNeighbor(const Vector<T, N>& p, T radius, F&& f) const;
+
+    /**
+     * @brief the points at a distance <= radius of p, sorted by increasing distance
+     *
+     * @param p
+     * @param radius
+     * @return std::vector<Neighbor<T>> index in the input and squared distance
+     */
+    std::vector<Neighbor<T>> neighbors(const Vector<T, N>& p, T radius) const;
+
+    /**
+     * @brief call f(i, j, squaredDistance) once for each pair of points at a distance <= radius
+     * (i and j are indices in the input, in no particular order)
+     *
+     * @param radius
+     * @param f
+     */
+    template <typename F>
+    void forEachPair(T radius, F&& f) const;
+
+    /**
+     * @brief forEachPair on several threads: f is called concurrently and must be thread safe
+     * (parallel::threadIndex() identifies the calling thread, e.g. for per-thread accumulators)
+     *
+     * @param radius
+     * @param f
+     */
+    template <typename F>
+    void forEachPairParallel(T radius, F&& f) const;
+
+    /**
+     * @brief the pairs of points at a distance <= radius, as (i, j) with i < j, sorted
+     *
+     * @param radius
+     * @return std::vector<std::pair<size_t, size_t>>
+     */
+    std::vector<std::pair<size_t, size_t>> pairs(T radius) const;
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+SpatialHashGrid<T, N>::SpatialHashGrid(T cellSize, const Vector<T, N>& box): width{cellSize}, wrap{true}, box{box} {
+    for (size_t d = 0; d < N; d++) {
+        cells[d] = std::max<int64_t>(1, static_cast<int64_t>(std::floor(box[d] / cellSize)));
+        cellWidth[d] = box[d] / static_cast<T>(cells[d]);
+    }
+}
+
+template <typename T, size_t N>
+typename SpatialHashGrid<T, N>::Cell SpatialHashGrid<T, N>::cellOf(const Vector<T, N>& p) const {
+    Cell cell;
+    for (size_t d = 0; d < N; d++) {
+        if (wrap) {
+            // p is wrapped, min() for a coordinate rounded up to the box
+            cell[d] = std::min(cells[d] - 1, static_cast<int64_t>(p[d] / cellWidth[d]));
+        } else {
+            cell[d] = static_cast<int64_t>(std::floor(p[d] / width));
+        }
+    }
+    return cell;
+}
+
+template <typename T, size_t N>
+size_t SpatialHashGrid<T, N>::bucketOf(const Cell& cell) const {
+    if (wrap) {
+        // dense grid: linear index of the cell
+        size_t bucket = 0;
+        for (size_t d = 0; d < N; d++) {
+            bucket = bucket * static_cast<size_t>(cells[d]) + static_cast<size_t>(cell[d]);
+        }
+        return bucket;
+    }
+    // spatial hash of the cell (multiply by large odd constants and mix), table size is a power of 2
+    uint64_t h = 0;
+    for (size_t d = 0; d < N; d++) {
+        h = (h ^ static_cast<uint64_t>(cell[d])) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+    }
+    return static_cast<size_t>(h) & (bucketStart.size() - 2);
+}
+
+template <typename T, size_t N>
+int64_t SpatialHashGrid<T, N>::reachOf(T radius) const {
+    T smallest = width;
+    if (wrap) {
+        for (size_t d = 0; d < N; d++) {
+            smallest = std::min(smallest, cellWidth[d]);
+        }
+    }
+    return std::max<int64_t>(1, static_cast<int64_t>(std::ceil(radius / smallest)));
+}
+
+template <typename T, size_t N>
+void SpatialHashGrid<T, N>::neighborBuckets(const Cell& cell, int64_t reach, std::vector<size_t>& out) const {
+    out.clear();
+    Cell offset;
+    offset.fill(-reach);
+    // odometer over the offsets in [-reach, reach]^N
+    while (true) {
+        Cell neighbor;
+        for (size_t d = 0; d < N; d++) {
+            neighbor[d] = cell[d] + offset[d];
+            if (wrap) {
+                neighbor[d] = ((neighbor[d] % cells[d]) + cells[d]) % cells[d];
+            }
+        }
+        out.push_back(bucketOf(neighbor));
+        size_t d = 0;
+        while (d < N && offset[d] == reach) {
+            offset[d] = -reach;
+            d++;
+        }
+        if (d == N) {
+            break;
+        }
+        offset[d]++;
+    }
+    // several cells can share a bucket (hash collision, or a periodic grid narrower than the reach)
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+template <typename T, size_t N>
+void SpatialHashGrid<T, N>::rebuild(const Vector<T, N>* points, size_t count) {
+    size_t buckets = 1;
+    if (wrap) {
+        for (size_t d = 0; d < N; d++) {
+            buckets *= static_cast<size_t>(cells[d]);
+        }
+    } else {
+        while (buckets < 2 * count) {
+            buckets *= 2;
+        }
+    }
+    bucketStart.assign(buckets + 1, 0);
+    sortedPoints.resize(count);
+    sortedIndices.resize(count);
+    pointBucket.resize(count);
+    wrapped.resize(count);
+
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        wrapped[i] = wrap ? points[i].mod(box) : points[i];
+        pointBucket[i] = bucketOf(cellOf(wrapped[i]));
+    }
+
+    // counting sort: sizes, then start of each bucket
+    for (size_t i = 0; i < count; i++) {
+        bucketStart[pointBucket[i] + 1]++;
+    }
+    for (size_t b = 0; b < buckets; b++) {
+        bucketStart[b + 1] += bucketStart[b];
+    }
+    bucketNext.assign(bucketStart.begin(), bucketStart.end() - 1);
+    for (size_t i = 0; i < count; i++) {
+        sortedIndices[bucketNext[pointBucket[i]]++] = i;
+    }
+
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t i = 0; i < count; i++) {
+        sortedPoints[i] = wrapped[sortedIndices[i]];
+    }
+}
+
+template <typename T, size_t N>
+Vector<T, N> SpatialHashGrid<T, N>::displacement(const Vector<T, N>& a, const Vector<T, N>& b) const {
+    Vector<T, N> d = b - a;
+    if (wrap) {
+        for (size_t i = 0; i < N; i++) {
+            if (d[i] > box[i] / 2) {
+                d[i] -= box[i];
+            } else if (d[i] < -box[i] / 2) {
+                d[i] += box[i];
+            }
+        }
+    }
+    return d;
+}
+
+template <typename T, size_t N>
+template <typename F>
+void SpatialHashGrid<T, N>::forEachNeighbor(const Vector<T, N>& p, T radius, F&& f) const {
+    if (sortedPoints.empty()) {
+        return;
+    }
+    const Vector<T, N> query = wrap ? p.mod(box) : p;
+    const T bound = radius * radius;
+    std::vector<size_t> buckets;
+    neighborBuckets(cellOf(query), reachOf(radius), buckets);
+    for (size_t b : buckets) {
+        for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; i++) {
+            const T distance = squaredDist(query, sortedPoints[i]);
+            if (distance <= bound) {
+                f(sortedIndices[i], distance);
+            }
+        }
+    }
+}
+
+template <typename T, size_t N>
+std::vector<Neighbor<T>> SpatialHashGrid<T, N>::neighbors(const Vector<T, N>& p, T radius) const {
+    std::vector<Neighbor<T>> result;
+    forEachNeighbor(p, radius, [&](size_t index, T distance) { result.push_back({index, distance}); });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// each pair is found from the point of the lower bucket, or of the lower position in a shared bucket
+
+template <typename T, size_t N>
+template <typename F>
+void SpatialHashGrid<T, N>::pairsOfBucket(size_t b, T radius, int64_t reach, std::vector<size_t>& buckets, F& f) const {
+    const T bound = radius * radius;
+    Cell previous;
+    bool cached = false;
+    for (size_t i = bucketStart[b]; i < bucketStart[b + 1]; i++) {
+        const Vector<T, N>& p = sortedPoints[i];
+        // the points of a bucket usually share their cell
+        const Cell cell = cellOf(p);
+        if (!cached || cell != previous) {
+            neighborBuckets(cell, reach, buckets);
+            previous = cell;
+            cached = true;
+        }
+        for (auto it = std::lower_bound(buckets.begin(), buckets.end(), b); it != buckets.end(); ++it) {
+            const size_t begin = *it == b ? i + 1 : bucketStart[*it];
+            for (size_t j = begin; j < bucketStart[*it + 1]; j++) {
+                const T distance = squaredDist(p, sortedPoints[j]);
+                if (distance <= bound) {
+                    f(sortedIndices[i], sortedIndices[j], distance);
+                }
+            }
+        }
+    }
+}
+
+template <typename T, size_t N>
+template <typename F>
+void SpatialHashGrid<T, N>::forEachPair(T radius, F&& f) const {
+    if (sortedPoints.empty()) {
+        return;
+    }
+    const int64_t reach = reachOf(radius);
+    std::vector<size_t> buckets;
+    for (size_t b = 0; b + 1 < bucketStart.size(); b++) {
+        pairsOfBucket(b, radius, reach, buckets, f);
+    }
+}
+
+template <typename T, size_t N>
+template <typename F>
+void SpatialHashGrid<T, N>::forEachPairParallel(T radius, F&& f) const {
+    if (sortedPoints.empty()) {
+        return;
+    }
+    const int64_t reach = reachOf(radius);
+    const size_t buckets = bucketStart.size() - 1;
+    VECTORND_OMP(parallel)
+    {
+        std::vector<size_t> neighbors;
+        VECTORND_OMP(for schedule(dynamic, pairBlock))
+        for (size_t b = 0; b < buckets; b++) {
+            pairsOfBucket(b, radius, reach, neighbors, f);
+        }
+    }
+}
+
+template <typename T, size_t N>
+std::vector<std::pair<size_t, size_t>> SpatialHashGrid<T, N>::pairs(T radius) const {
+    std::vector<std::vector<std::pair<size_t, size_t>>> found(parallel::threadCount());
+    forEachPairParallel(radius, [&found](size_t i, size_t j, T) {
+        found[parallel::threadIndex()].push_back({std::min(i, j), std::max(i, j)});
+    });
+    std::vector<std::pair<size_t, size_t>> result;
+    for (const auto& part : found) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm> // std::push_heap, std::pop_heap, std::sort_heap
+#include <cstddef>
+#include <utility> // std::pair
+#include <vector>
+
+namespace VectorND {
+
+/**
+ * @brief a neighbor found by a search: its index in the dataset and its distance
+ *
+ * @tparam D the type of the distances
+ */
+template <typename D>
+struct Neighbor
+{
+    size_t index;
+    D distance;
+
+    inline bool operator<(const Neighbor& other) const {
+        return distance < other.distance || (distance == other.distance && index < other.index);
+    }
+};
+
+/**
+ * @brief the k smallest (distance, index) pairs seen so far: a max-heap of fixed capacity.
+ * Equal distances are ordered by index, so the result does not depend on the push order.
+ *
+ * @tparam D the type of the distances
+ */
+template <typename D>
+class TopK
+{
+private:
+    std::vector<std::pair<D, size_t>> heap;
+    size_t k;
+public:
+    explicit TopK(size_t k): k{k} { heap.reserve(k); }
+
+    inline size_t capacity() const noexcept { return k; }
+    inline size_t size() const noexcept { return heap.size(); }
+    inline bool full() const noexcept { return heap.size() == k; }
+    inline void clear() noexcept { heap.clear(); }
+
+    /// largest distance kept (only valid if full())
+    inline D worst() const { return heap.front().first; }
+
+    /**
+     * @brief keep (distance, index) if it is one of the k smallest
+     *
+     * @param distance
+     * @param index
+     */
+    inline void push(D distance, size_t index) {
+        const std::pair<D, size_t> item{distance, index};
+        if (heap.size() < k) {
+            heap.push_back(item);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (k > 0 && item < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = item;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    /**
+     * @brief write the pairs sorted by increasing distance and empty the heap
+     *
+     * @param distances size() values
+     * @param indices size() values
+     */
+    void extractSorted(D* distances, size_t* indices) {
+        std::sort_heap(heap.begin(), heap.end());
+        for (size_t i = 0; i < heap.size(); i++) {
+            distances[i] = heap[i].first;
+            indices[i] = heap[i].second;
+        }
+        heap.clear();
+    }
+
+    /**
+     * @brief the neighbors sorted by increasing distance, empty the heap
+     *
+     * @return std::vector<Neighbor<D>>
+     */
+    std::vector<Neighbor<D>> extractSorted() {
+        std::sort_heap(heap.begin(), heap.end());
+        std::vector<Neighbor<D>> result(heap.size());
+        for (size_t i = 0; i < heap.size(); i++) {
+            result[i] = {heap[i].second, heap[i].first};
+        }
+        heap.clear();
+        return result;
+    }
+};
+
+/**
+ * @brief neighbors of a batch of queries: k (index, distance) per query, sorted by
+ * increasing distance, stored row major
+ *
+ * @tparam D the type of the distances
+ */
+template <typename D>
+struct KnnResult
+{
+    /// number of neighbors per query
+    size_t k{0};
+    std::vector<size_t> indices;
+    std::vector<D> distances;
+
+    /// number of queries
+    inline size_t size() const noexcept { return k == 0 ? 0 : indices.size() / k; }
+
+    /// index of the neighbor r of the query q
+    inline size_t index(size_t q, size_t r) const { return indices[q * k + r]; }
+
+    /// distance of the neighbor r of the query q
+    inline D distance(size_t q, size_t r) const { return distances[q * k + r]; }
+};
+
+}
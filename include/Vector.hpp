@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <cmath> // sqrt
 #include <iomanip> // std::setprecision
 
+#include "VectorExpr.hpp"
+
 // TODO: add scalar adition to Vector
 // TODO: add %= for consistency
 // TODO: add inline functions where possible
@@ -30,29 +33,54 @@ public:
     // size of the vector (for convenience)
     static constexpr size_t size = N;
     //**----------
-    Vector(): data{} {}
-    //TODO: remove copy constructor
-    Vector(const Vector& v): data{v.data} {}
+    constexpr Vector(): data{} { VECTORND_PROFILE_COUNT(T, N, DefaultConstruct, 0, sizeof(T)); }
+#if defined(VECTORND_PROFILE)
+    // counted, so not trivial in profiling builds (see Profile.hpp)
+    constexpr Vector(const Vector& v): data{v.data} { VECTORND_PROFILE_COUNT(T, N, CopyConstruct, 0, 2 * sizeof(T)); }
+#else
+    // trivial: a Vector is copied as its T[N] (and can be read from raw memory, see PointFile)
+    constexpr Vector(const Vector& v) = default;
+#endif
     
-    Vector(const std::array<T, N>& data): data{data} {}
+    constexpr Vector(const std::array<T, N>& data): data{data} {}
+
+    /**
+     * @brief evaluate an expression (a + b * s - c, ...) in a single loop
+     *
+     * @param expr
+     */
+    template <typename E>
+    constexpr Vector(const VectorExpr<E, T, N>& expr);
+
+    constexpr Vector& operator=(const Vector& v) = default;
+
+    /**
+     * @brief evaluate an expression into the current vector in a single loop
+     *
+     * @param expr
+     * @return Vector&
+     */
+    template <typename E>
+    constexpr Vector& operator=(const VectorExpr<E, T, N>& expr);
     //**----------
     // iterators
-    inline iterator begin() noexcept { return data.data(); }
-    inline const_iterator cbegin() const noexcept { return data.data(); }
-    inline iterator end() noexcept { return data.data() + N; }
-    inline const_iterator cend() const noexcept { return data.data() + N; }
+    constexpr iterator begin() noexcept { return data.data(); }
+    constexpr const_iterator cbegin() const noexcept { return data.data(); }
+    constexpr iterator end() noexcept { return data.data() + N; }
+    constexpr const_iterator cend() const noexcept { return data.data() + N; }
     //**----------
 
     /// cast to std::array
-    inline operator std::array<T, N>() const { return data; }
-    inline operator std::array<T, N>&() { return data; }
+    constexpr operator std::array<T, N>() const { return data; }
+    constexpr operator std::array<T, N>&() { return data; }
 
     /**
      * @brief Operator for the casting to one vector to another
      * 
      */
     template <typename U>
-    operator Vector<U, N>() const {
+    constexpr operator Vector<U, N>() const {
+        VECTORND_PROFILE_COUNT(T, N, Cast, 0, sizeof(T) + sizeof(U));
         Vector<U, N> result;
         for (size_t i = 0; i < N; ++i) {
             result[i] = static_cast<U>(data[i]);
@@ -65,7 +93,7 @@ public:
      * 
      * @param i the index of the element
      */
-    inline T& operator[](size_t i) {
+    constexpr T& operator[](size_t i) {
         return data[i];
     }
 
@@ -74,7 +102,7 @@ public:
      * 
      * @param i the index of the element
      */
-    inline T operator[](size_t i) const {
+    constexpr T operator[](size_t i) const {
         return data[i];
     }
 
@@ -83,40 +111,17 @@ public:
      * 
      * @param i the index of the element
      */
-    inline T at(size_t i) const {
+    constexpr T at(size_t i) const {
         return data.at(i);
     }
 
-    /**
-     * @brief sum of 2 vectors and returns a new vector
-     * 
-     * @param otherVector 
-     * @return Vector
-     */
-    Vector operator+(const Vector& otherVector) const;
-
-    /**
-     * @brief substraction
-     * 
-     * @param otherVector 
-     * @return Vector 
-     */
-    Vector operator-(const Vector& otherVector) const;
-
-    /**
-     * @brief unary minus operator
-     * 
-     * @return Vector 
-     */
-    Vector operator-() const;
-
     /**
      * @brief add a vector to the current vector
      * 
      * @param otherVector 
      * @return Vector& 
      */ 
-    Vector& operator+=(const Vector& otherVector);
+    constexpr Vector& operator+=(const Vector& otherVector);
 
     /**
      * @brief -= operator overloading
@@ -124,54 +129,54 @@ public:
      * @param otherVector 
      * @return Vector& 
      */
-    Vector& operator-=(const Vector& otherVector);
+    constexpr Vector& operator-=(const Vector& otherVector);
 
     /**
-     * @brief return dot product
+     * @brief add an expression to the current vector (single loop, no temporary)
      * 
-     * @param otherVector 
-     * @return Vector 
+     * @param expr 
+     * @return Vector& 
      */
-    T dot(const Vector& otherVector) const;
+    template <typename E>
+    constexpr Vector& operator+=(const VectorExpr<E, T, N>& expr);
 
     /**
-     * @brief return result of multiplying a vector by a scalar
+     * @brief substract an expression from the current vector (single loop, no temporary)
      * 
-     * @param scalar 
-     * @return Vector 
+     * @param expr 
+     * @return Vector& 
      */
-    Vector operator*(T scalar) const;
+    template <typename E>
+    constexpr Vector& operator-=(const VectorExpr<E, T, N>& expr);
 
     /**
-     * @brief return result of multiplying a scalar by a vecor
+     * @brief return dot product
      * 
-     * @param vector 
-     * @param scalar 
+     * @param otherVector 
      * @return Vector 
      */
-    friend Vector operator*(T scalar, const Vector& vector) {
-        Vector<T, N> result;
-        for (size_t i = 0; i < N; i++) {
-            result.data[i] = scalar * vector.data[i];
-        }
-        return result;
-    }
+    constexpr T dot(const Vector& otherVector) const;
 
     /**
-     * @brief element by element product
+     * @brief return dot product accumulated in Acc with a summation mode:
+     * v.dot<int32_t>(w) for int8_t elements, v.dot<double, summation::Kahan>(w)...
      * 
+     * @tparam Acc the accumulator (and result) type
+     * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
      * @param otherVector 
-     * @return Vector
+     * @return Acc 
      */
-    Vector operator*(const Vector& otherVector) const;
+    template <typename Acc, typename Mode = summation::Naive>
+    constexpr Acc dot(const Vector& otherVector) const;
 
     /**
-     * @brief element by element division
+     * @brief return dot product with an expression or a view (VectorView...), not copied
      * 
-     * @param otherVector 
-     * @return Vector
+     * @param other 
+     * @return T 
      */
-    Vector operator/(const Vector& otherVector) const;
+    template <typename O, typename = std::enable_if_t<detail::isNode<O> && detail::areCompatible<Vector, O>>>
+    constexpr T dot(const O& other) const;
 
     /**
      * @brief *= operator overlading. multiply by scalar
@@ -179,7 +184,7 @@ public:
      * @param scalar
      * @return Vector& 
      */
-    Vector& operator*=(T scalar);
+    constexpr Vector& operator*=(T scalar);
 
     /**
      * @brief *= operator overlading. multiply by vector
@@ -187,30 +192,16 @@ public:
      * @param vector
      * @return Vector& 
      */
-    Vector& operator*=(const Vector& vector);
+    constexpr Vector& operator*=(const Vector& vector);
 
     /**
-     * @brief return result of dividing a vector by a scalar
+     * @brief *= operator overlading. multiply by an expression
      * 
-     * @param scalar 
-     * @return Vector 
+     * @param expr
+     * @return Vector& 
      */
-    Vector operator/(T scalar) const;
-
-    /**
-     * @brief return result of dividing a scalar by a vecor
-     * 
-     * @param vector 
-     * @param scalar 
-     * @return Vector 
-     */
-    friend Vector operator/(T scalar, const Vector& vector) {
-            Vector<T, N> result;
-        for (size_t i = 0; i < N; i++) {
-            result.data[i] = scalar / vector.data[i];
-        }
-        return result;
-    }
+    template <typename E>
+    constexpr Vector& operator*=(const VectorExpr<E, T, N>& expr);
 
     /**
      * @brief /= operator overlading. divide by scalar
@@ -218,7 +209,7 @@ public:
      * @param scalar
      * @return Vector& 
      */
-    Vector& operator/=(T scalar);
+    constexpr Vector& operator/=(T scalar);
 
     /**
      * @brief /= operator overlading. divide by vector
@@ -226,7 +217,16 @@ public:
      * @param vector
      * @return Vector& 
      */
-    Vector& operator/=(const Vector& vector);
+    constexpr Vector& operator/=(const Vector& vector);
+
+    /**
+     * @brief /= operator overlading. divide by an expression
+     * 
+     * @param expr
+     * @return Vector& 
+     */
+    template <typename E>
+    constexpr Vector& operator/=(const VectorExpr<E, T, N>& expr);
 
     /**
      * @brief element by element remainder operation on each element
@@ -234,7 +234,16 @@ public:
      * @param otherVector
      * @return Vector 
      */
-    Vector mod(const Vector& otherVector) const;
+    constexpr Vector mod(const Vector& otherVector) const;
+
+    /**
+     * @brief element by element true modulo by an expression or a view
+     * 
+     * @param other
+     * @return Vector 
+     */
+    template <typename O, typename = std::enable_if_t<detail::isNode<O> && detail::areCompatible<Vector, O>>>
+    constexpr Vector mod(const O& other) const;
 
     //***
     /**
@@ -243,14 +252,14 @@ public:
      * @param scalar 
      * @return Vector 
      */
-    Vector mod(T scalar) const;
+    constexpr Vector mod(T scalar) const;
 
     /**
      * @brief return the euclidean norm of a vector (static function)
      * 
      * @return double 
      */
-    static double norm(const Vector& vector);
+    static constexpr double norm(const Vector& vector);
 
     /**
      * @brief return the euclidean norm of a vector
@@ -258,7 +267,17 @@ public:
      * @param vector 
      * @return double 
      */
-    double norm() const;
+    constexpr double norm() const;
+
+    /**
+     * @brief return the euclidean norm, the squares accumulated in Acc with a summation mode
+     * 
+     * @tparam Acc the accumulator type
+     * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+     * @return double 
+     */
+    template <typename Acc, typename Mode = summation::Naive>
+    constexpr double norm() const;
 
     /**
      * @brief return the absolute squared norm of a vector (static function)
@@ -266,14 +285,24 @@ public:
      * @param vector 
      * @return double
      */
-    static double squaredNorm(const Vector& vector);
+    static constexpr double squaredNorm(const Vector& vector);
 
     /**
      * @brief return the absolute squared norm of a vector
      * 
      * @return double 
      */
-    double squaredNorm() const;
+    constexpr double squaredNorm() const;
+
+    /**
+     * @brief return the absolute squared norm accumulated in Acc with a summation mode
+     * 
+     * @tparam Acc the accumulator (and result) type
+     * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+     * @return Acc 
+     */
+    template <typename Acc, typename Mode = summation::Naive>
+    constexpr Acc squaredNorm() const;
 
     /**
      * @brief return the euclidean distance between 2 vectors a and b (static function)
@@ -282,7 +311,7 @@ public:
      * @param b 
      * @return double 
      */
-    static double dist(const Vector& a, const Vector& b);
+    static constexpr double dist(const Vector& a, const Vector& b);
 
     /**
      * @brief return the euclidean distance between 2 vectors
@@ -290,7 +319,16 @@ public:
      * @param otherVector
      * @return double 
      */
-    double dist(const Vector& otherVector) const;
+    constexpr double dist(const Vector& otherVector) const;
+
+    /**
+     * @brief return the euclidean distance to an expression or a view
+     * 
+     * @param other
+     * @return double 
+     */
+    template <typename O, typename = std::enable_if_t<detail::isNode<O> && detail::areCompatible<Vector, O>>>
+    constexpr double dist(const O& other) const;
 
     /**
      * @brief return the squared distance between 2 vectors a and b (static function)
@@ -299,7 +337,7 @@ public:
      * @param b 
      * @return double 
      */
-    static double squaredDist(const Vector& a, const Vector& b);
+    static constexpr double squaredDist(const Vector& a, const Vector& b);
 
     /**
      * @brief return the squared distance between 2 vectors
@@ -307,14 +345,112 @@ public:
      * @param otherVector
      * @return double 
      */
-    double squaredDist(const Vector& otherVector) const;
+    constexpr double squaredDist(const Vector& otherVector) const;
+
+    /**
+     * @brief return the squared distance to an expression or a view
+     * 
+     * @param other
+     * @return double 
+     */
+    template <typename O, typename = std::enable_if_t<detail::isNode<O> && detail::areCompatible<Vector, O>>>
+    constexpr double squaredDist(const O& other) const;
 
     /**
      * @brief reverse the order of the elements: {x,y} => {y,x}
      * 
      * @return Vector 
      */
-    Vector reverse() const;
+    constexpr Vector reverse() const;
+
+    /**
+     * @brief this += alpha * x in a single pass (BLAS axpy)
+     * 
+     * @param alpha 
+     * @param x a vector or an expression
+     * @return Vector& 
+     */
+    template <typename X, typename = std::enable_if_t<detail::areCompatible<Vector, X>>>
+    constexpr Vector& axpy(T alpha, const X& x);
+
+    /**
+     * @brief this = this * b + c in a single pass (fused multiply-add)
+     * 
+     * @param b a vector or an expression
+     * @param c a vector or an expression
+     * @return Vector& 
+     */
+    template <typename B, typename C,
+              typename = std::enable_if_t<detail::areCompatible<Vector, B> && detail::areCompatible<Vector, C>>>
+    constexpr Vector& fma(const B& b, const C& c);
+
+    /**
+     * @brief this = this * scalar + c in a single pass (fused multiply-add)
+     * 
+     * @param scalar 
+     * @param c a vector or an expression
+     * @return Vector& 
+     */
+    template <typename C, typename = std::enable_if_t<detail::areCompatible<Vector, C>>>
+    constexpr Vector& fma(T scalar, const C& c);
+
+    /**
+     * @brief move towards target: this = this + t * (target - this), in a single pass
+     * 
+     * @param target a vector or an expression
+     * @param t 0 keeps the vector, 1 gives target
+     * @return Vector& 
+     */
+    template <typename O, typename = std::enable_if_t<detail::areCompatible<Vector, O>>>
+    constexpr Vector& lerp(const O& target, T t);
+
+    /**
+     * @brief scale the vector to a norm of 1 (a null vector is left unchanged),
+     * for floating-point elements only
+     * 
+     * @return Vector& 
+     */
+    constexpr Vector& normalize();
+
+    /**
+     * @brief the vector scaled to a norm of 1 (a null vector stays null)
+     * 
+     * @return Vector 
+     */
+    constexpr Vector normalized() const;
+
+    /**
+     * @brief approximate 1 / norm() (floating-point T): for float, the rsqrt estimate refined
+     * by one Newton-Raphson step, relative error below 5e-7. Exact for double and in a
+     * constant expression. inf for a null vector.
+     * 
+     * @return T 
+     */
+    constexpr T invNorm() const;
+
+    /**
+     * @brief normalize() with invNorm(): no division nor square root for float, the norm of
+     * the result is 1 within 1e-6 (a null vector is left unchanged)
+     * 
+     * @return Vector& 
+     */
+    constexpr Vector& fastNormalize();
+
+    /**
+     * @brief the vector scaled by invNorm() (a null vector stays null)
+     * 
+     * @return Vector 
+     */
+    constexpr Vector fastNormalized() const;
+
+    /**
+     * @brief euclidean distance to a vector or an expression, the difference is never stored
+     * 
+     * @param other
+     * @return double 
+     */
+    template <typename O, typename = std::enable_if_t<detail::areCompatible<Vector, O>>>
+    constexpr double distanceTo(const O& other) const;
 
     /**
      * @brief equality operator
@@ -323,7 +459,7 @@ public:
      * @return true if the vectors are equal
      * @return false if the vectors are not equal
      */
-    inline bool operator==(const Vector& otherVector) const;
+    constexpr bool operator==(const Vector& otherVector) const;
 
     /**
      * @brief inequality operator
@@ -332,7 +468,7 @@ public:
      * @return true if the vectors are not equal
      * @return false if the vectors are equal
     */
-    inline bool operator!=(const Vector& otherVector) const;
+    constexpr bool operator!=(const Vector& otherVector) const;
 
 
     /**
@@ -356,224 +492,251 @@ public:
 
 };
 
+/**
+ * @brief true if Vector<T, N> has the layout of T[N]: standard layout, trivially copyable,
+ * no padding. An array of such vectors can then be read from (or written to) raw memory.
+ * (The counting copy constructor of the profiling builds copies the same bytes.)
+ */
+template <typename T, size_t N>
+constexpr bool hasArrayLayout = std::is_standard_layout_v<Vector<T, N>> &&
+                                (std::is_trivially_copyable_v<Vector<T, N>> || profile::enabled) &&
+                                sizeof(Vector<T, N>) == N * sizeof(T) &&
+                                alignof(Vector<T, N>) == alignof(T);
+
 
 //* ------------------ Implementation ------------------ *//
 
-//sum of 2 vectors and returns a new vector
+// evaluation of an expression (data{} only because a C++17 constexpr constructor must
+// initialize every member, the stores are removed by the optimizer)
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator+(const Vector<T, N>& otherVector) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = data[i] + otherVector.data[i];
-    }
-    return result;
+template <typename E>
+constexpr Vector<T, N>::Vector(const VectorExpr<E, T, N>& expr): data{} {
+    detail::evaluate<T, N>(data.data(), expr.self());
 }
 
-// substraction:
-
-template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator-(const Vector<T, N>& otherVector) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = data[i] - otherVector.data[i];
-    }
-    return result;
-}
+// expressions are element-wise, so assigning an expression that reads *this is safe
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator-() const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result[i] = -data[i];
-    }
-    return result;
+template <typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator=(const VectorExpr<E, T, N>& expr) {
+    detail::evaluate<T, N>(data.data(), expr.self());
+    return *this;
 }
 
 // add a vector to the current vector
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator+=(const Vector<T, N>& otherVector) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] += otherVector.data[i];
-    }
+constexpr Vector<T, N>& Vector<T, N>::operator+=(const Vector<T, N>& otherVector) {
+    VECTORND_PROFILE_COUNT(T, N, AddAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Add>(*this, otherVector));
     return *this;
 }
 
 // -= operator overloading
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator-=(const Vector<T, N>& otherVector) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] -= otherVector.data[i];
-    }
+constexpr Vector<T, N>& Vector<T, N>::operator-=(const Vector<T, N>& otherVector) {
+    VECTORND_PROFILE_COUNT(T, N, SubAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Sub>(*this, otherVector));
     return *this; 
 }
 
-//element by element product of 2 vectors and returns a new vector
+template <typename T, size_t N>
+template <typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator+=(const VectorExpr<E, T, N>& expr) {
+    VECTORND_PROFILE_COUNT(T, N, AddAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Add>(*this, expr.self()));
+    return *this;
+}
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator*(const Vector<T, N>& otherVector) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = data[i] * otherVector.data[i];
-    }
-    return result;
+template <typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator-=(const VectorExpr<E, T, N>& expr) {
+    VECTORND_PROFILE_COUNT(T, N, SubAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Sub>(*this, expr.self()));
+    return *this;
 }
 
 // return the dot product
 
 template <typename T, size_t N>
-T Vector<T, N>::dot(const Vector<T, N>& otherVector) const {
-    T result{0};
-    for (size_t i = 0; i < N; i++) {
-        result += data[i] * otherVector.data[i];
-    }
-    return result;
+constexpr T Vector<T, N>::dot(const Vector<T, N>& otherVector) const {
+    VECTORND_PROFILE_COUNT(T, N, Dot, 2, 2 * sizeof(T));
+    return detail::dotKernel<T, N>(*this, otherVector);
 }
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator*(T scalar) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = scalar * data[i];
-    }
-    return result;
+template <typename Acc, typename Mode>
+constexpr Acc Vector<T, N>::dot(const Vector<T, N>& otherVector) const {
+    VECTORND_PROFILE_COUNT(T, N, Dot, 2, 2 * sizeof(T));
+    return detail::reduceKernel<Acc, Mode, N>(*this, otherVector);
+}
+
+template <typename T, size_t N>
+template <typename O, typename>
+constexpr T Vector<T, N>::dot(const O& other) const {
+    VECTORND_PROFILE_COUNT(T, N, Dot, 2, 2 * sizeof(T));
+    return detail::dotKernel<T, N>(*this, other);
 }
 
 //. *= operator overlading. multiply by scalar
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator*=(T scalar) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] *= scalar;
-    }
+constexpr Vector<T, N>& Vector<T, N>::operator*=(T scalar) {
+    VECTORND_PROFILE_COUNT(T, N, MulAssign, 1, 2 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinaryScalar<detail::Mul>(*this, scalar));
     return *this; 
 }
 
 //. *= operator overloading. multiply by a vector
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator*=(const Vector<T, N>& otherVector) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] *= otherVector.data[i];
-    }
+constexpr Vector<T, N>& Vector<T, N>::operator*=(const Vector<T, N>& otherVector) {
+    VECTORND_PROFILE_COUNT(T, N, MulAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Mul>(*this, otherVector));
     return *this; 
 }
 
-// division
-
-//element by element division of 2 vectors and returns a new vector
-
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator/(const Vector<T, N>& otherVector) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = data[i] / otherVector.data[i];
-    }
-    return result;
+template <typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator*=(const VectorExpr<E, T, N>& expr) {
+    VECTORND_PROFILE_COUNT(T, N, MulAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Mul>(*this, expr.self()));
+    return *this;
 }
 
+// division
+
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::operator/(T scalar) const {
-    Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = data[i] / scalar;
-    }
-    return result;
+constexpr Vector<T, N>& Vector<T, N>::operator/=(T scalar) {
+    VECTORND_PROFILE_COUNT(T, N, DivAssign, 1, 2 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinaryScalar<detail::Div>(*this, scalar));
+    return *this; 
 }
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator/=(T scalar) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] /= scalar;
-    }
+constexpr Vector<T, N>& Vector<T, N>::operator/=(const Vector<T, N>& otherVector) {
+    VECTORND_PROFILE_COUNT(T, N, DivAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Div>(*this, otherVector));
     return *this; 
 }
 
 template <typename T, size_t N>
-Vector<T, N>& Vector<T, N>::operator/=(const Vector<T, N>& otherVector) {
-    for (size_t i = 0; i < N; i++) {
-        data[i] /= otherVector.data[i];
-    }
-    return *this; 
+template <typename E>
+constexpr Vector<T, N>& Vector<T, N>::operator/=(const VectorExpr<E, T, N>& expr) {
+    VECTORND_PROFILE_COUNT(T, N, DivAssign, 1, 3 * sizeof(T));
+    detail::evaluate<T, N>(data.data(), detail::makeBinary<detail::Div>(*this, expr.self()));
+    return *this;
 }
 
 // true modulo operation
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::mod(const Vector<T, N>& otherVector) const {
+constexpr Vector<T, N> Vector<T, N>::mod(const Vector<T, N>& otherVector) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 3 * sizeof(T));
     Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        // cast the to T
-        result.data[i] = static_cast<T>(std::fmod(std::fmod(data[i], otherVector[i]) + otherVector[i], otherVector[i]));
-    }
+    detail::modKernel<T, N>(result.data.data(), *this, otherVector);
     return result;
 }
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::mod(T scalar) const {
+template <typename O, typename>
+constexpr Vector<T, N> Vector<T, N>::mod(const O& other) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 3 * sizeof(T));
     Vector<T, N> result;
-    for (size_t i = 0; i < N; i++) {
-        result.data[i] = static_cast<T>(std::fmod(std::fmod(data[i], scalar) + scalar, scalar));
-    }
+    detail::modKernel<T, N>(result.data.data(), *this, other);
+    return result;
+}
+
+template <typename T, size_t N>
+constexpr Vector<T, N> Vector<T, N>::mod(T scalar) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 2 * sizeof(T));
+    Vector<T, N> result;
+    detail::modKernel<T, N>(result.data.data(), *this, ScalarExpr<T, N>(scalar));
     return result;
 }
 
 // return the euclidean norm of a vector 
 
 template <typename T, size_t N>
-double Vector<T, N>::norm() const {
-    return std::sqrt(dot(*this));
+constexpr double Vector<T, N>::norm() const {
+    return detail::sqrt(squaredNorm());
 }
 
 // return the euclidean norm of a vector (static function)
 
 template <typename T, size_t N>
-double Vector<T, N>::norm(const Vector<T, N>& vector) {
+constexpr double Vector<T, N>::norm(const Vector<T, N>& vector) {
     return vector.norm();
 }
 
 // return the absolute squared norm of a vector
 
 template <typename T, size_t N>
-double Vector<T, N>::squaredNorm() const {
-    return dot(*this);
+constexpr double Vector<T, N>::squaredNorm() const {
+    return VectorND::squaredNorm(*this);
+}
+
+template <typename T, size_t N>
+template <typename Acc, typename Mode>
+constexpr Acc Vector<T, N>::squaredNorm() const {
+    VECTORND_PROFILE_COUNT(T, N, Norm, 2, sizeof(T));
+    return detail::reduceKernel<Acc, Mode, N>(*this, *this);
+}
+
+template <typename T, size_t N>
+template <typename Acc, typename Mode>
+constexpr double Vector<T, N>::norm() const {
+    return detail::sqrt(static_cast<double>(squaredNorm<Acc, Mode>()));
 }
 
 // return the absolute squared norm of a vector (static function)
 
 template <typename T, size_t N>
-double Vector<T, N>::squaredNorm(const Vector<T, N>& vector) {
+constexpr double Vector<T, N>::squaredNorm(const Vector<T, N>& vector) {
     return vector.squaredNorm();
 }
 
 // return the euclidean distance between 2 vectors a and b (static function)
+// the differences go straight into the accumulator: no temporary vector is built
+
+template <typename T, size_t N>
+constexpr double Vector<T, N>::dist(const Vector<T, N>& a, const Vector<T, N>& b) {
+    return VectorND::dist(a, b);
+}
 
 template <typename T, size_t N>
-double Vector<T, N>::dist(const Vector<T, N>& a, const Vector<T, N>& b) {
-    return Vector<T, N>::norm(a - b);
+constexpr double Vector<T, N>::dist(const Vector<T, N>& otherVector) const {
+    return VectorND::dist(*this, otherVector);
 }
 
 template <typename T, size_t N>
-double Vector<T, N>::dist(const Vector<T, N>& otherVector) const {
-    return Vector<T, N>::norm(*this - otherVector);
+template <typename O, typename>
+constexpr double Vector<T, N>::dist(const O& other) const {
+    return VectorND::dist(*this, other);
 }
 
 // return the squared distance between 2 vectors a and b (static function)
 
 template <typename T, size_t N>
-double Vector<T, N>::squaredDist(const Vector<T, N>& a, const Vector<T, N>& b) {
-    return Vector<T, N>::squaredNorm(a - b);
+constexpr double Vector<T, N>::squaredDist(const Vector<T, N>& a, const Vector<T, N>& b) {
+    return VectorND::squaredDist(a, b);
 }
 
 template <typename T, size_t N>
-double Vector<T, N>::squaredDist(const Vector<T, N>& otherVector) const {
-    return Vector<T, N>::squaredNorm(*this - otherVector);
+constexpr double Vector<T, N>::squaredDist(const Vector<T, N>& otherVector) const {
+    return VectorND::squaredDist(*this, otherVector);
 }
 
 template <typename T, size_t N>
-Vector<T, N> Vector<T, N>::reverse() const {
+template <typename O, typename>
+constexpr double Vector<T, N>::squaredDist(const O& other) const {
+    return VectorND::squaredDist(*this, other);
+}
+
+template <typename T, size_t N>
+constexpr Vector<T, N> Vector<T, N>::reverse() const {
     Vector<T, N> result;
     for (size_t i = 0; i < N; i++) {
         result.data[i] = data[N - i - 1];
@@ -581,17 +744,95 @@ Vector<T, N> Vector<T, N>::reverse() const {
     return result;
 }
 
+// fused in-place operations: a single evaluate() of an fma node
+
+template <typename T, size_t N>
+template <typename X, typename>
+constexpr Vector<T, N>& Vector<T, N>::axpy(T alpha, const X& x) {
+    detail::evaluate<T, N>(data.data(), VectorND::fma(x, alpha, *this));
+    return *this;
+}
+
+template <typename T, size_t N>
+template <typename B, typename C, typename>
+constexpr Vector<T, N>& Vector<T, N>::fma(const B& b, const C& c) {
+    detail::evaluate<T, N>(data.data(), VectorND::fma(*this, b, c));
+    return *this;
+}
+
+template <typename T, size_t N>
+template <typename C, typename>
+constexpr Vector<T, N>& Vector<T, N>::fma(T scalar, const C& c) {
+    detail::evaluate<T, N>(data.data(), VectorND::fma(*this, scalar, c));
+    return *this;
+}
+
+template <typename T, size_t N>
+template <typename O, typename>
+constexpr Vector<T, N>& Vector<T, N>::lerp(const O& target, T t) {
+    detail::evaluate<T, N>(data.data(), VectorND::lerp(*this, target, t));
+    return *this;
+}
+
+// normalization: one reduction, then a multiplication by the inverse norm
+
+template <typename T, size_t N>
+constexpr Vector<T, N>& Vector<T, N>::normalize() {
+    static_assert(!std::is_integral_v<T>, "normalize needs floating-point elements");
+    const auto squared = squaredNorm<simd::ComputeType<T>>();
+    if (squared > 0) {
+        *this *= static_cast<T>(1 / detail::sqrt(squared));
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vector<T, N> Vector<T, N>::normalized() const {
+    Vector<T, N> result(*this);
+    return result.normalize();
+}
+
+// fast normalization: the inverse norm comes from the rsqrt estimate (see detail::fastInvSqrt)
+
+template <typename T, size_t N>
+constexpr T Vector<T, N>::invNorm() const {
+    static_assert(std::is_floating_point_v<T>, "invNorm needs floating-point elements");
+    return detail::fastInvSqrt(static_cast<T>(dot(*this)));
+}
+
+template <typename T, size_t N>
+constexpr Vector<T, N>& Vector<T, N>::fastNormalize() {
+    static_assert(std::is_floating_point_v<T>, "fastNormalize needs floating-point elements");
+    const T squared = dot(*this);
+    if (squared > 0) {
+        *this *= detail::fastInvSqrt(squared);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+constexpr Vector<T, N> Vector<T, N>::fastNormalized() const {
+    Vector<T, N> result(*this);
+    return result.fastNormalize();
+}
+
+template <typename T, size_t N>
+template <typename O, typename>
+constexpr double Vector<T, N>::distanceTo(const O& other) const {
+    return VectorND::dist(*this, other);
+}
+
 // equality operator
 
 template <typename T, size_t N>
-bool Vector<T, N>::operator==(const Vector<T, N>& otherVector) const {
-    return data == otherVector.data;
+constexpr bool Vector<T, N>::operator==(const Vector<T, N>& otherVector) const {
+    return detail::equalKernel<T, N>(*this, otherVector);
 }
 
 // inequality operator
 
 template <typename T, size_t N>
-bool Vector<T, N>::operator!=(const Vector<T, N>& otherVector) const {
+constexpr bool Vector<T, N>::operator!=(const Vector<T, N>& otherVector) const {
     return !(*this == otherVector);
 }
 
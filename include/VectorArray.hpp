@@ -0,0 +1,739 @@
+#pragma once
+
+#include <cmath> // sqrt
+#include <vector>
+#include <algorithm> // std::max, std::min, std::copy
+
+#include "Vector.hpp"
+#include "AlignedAllocator.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+//* ------------------ kernels on contiguous arrays ------------------ *//
+
+/**
+ * @brief out[i] = Op(a[i], b[i]) for i in [0, n)
+ */
+template <typename Op, typename T>
+inline void spanBinary(const T* a, const T* b, T* out, size_t n) {
+    size_t i = 0;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        for (; i + P::width <= n; i += P::width) {
+            P::store(out + i, Op::template applyPacket<P>(P::load(a + i), P::load(b + i)));
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = Op::apply(a[i], b[i]);
+    }
+}
+
+/**
+ * @brief out[i] = Op(a[i], scalar) for i in [0, n)
+ */
+template <typename Op, typename T>
+inline void spanScalar(const T* a, T scalar, T* out, size_t n) {
+    size_t i = 0;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        const auto s = P::set1(scalar);
+        for (; i + P::width <= n; i += P::width) {
+            P::store(out + i, Op::template applyPacket<P>(P::load(a + i), s));
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = Op::apply(a[i], scalar);
+    }
+}
+
+/**
+ * @brief out[i] = true modulo of a[i] by m (see Vector::mod)
+ */
+template <typename T>
+inline void spanMod(const T* a, T m, T* out, size_t n) {
+    size_t i = 0;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        if constexpr (P::hasMod) {
+            const auto s = P::set1(m);
+            for (; i + P::width <= n; i += P::width) {
+                P::store(out + i, P::mod(P::load(a + i), s));
+            }
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = simd::mod(a[i], m);
+    }
+}
+
+/**
+ * @brief out[i] = true modulo of a[i] by m[i] for i in [0, n) (see Vector::mod)
+ */
+template <typename T>
+inline void spanModElements(const T* a, const T* m, T* out, size_t n) {
+    size_t i = 0;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        if constexpr (P::hasMod) {
+            for (; i + P::width <= n; i += P::width) {
+                P::store(out + i, P::mod(P::load(a + i), P::load(m + i)));
+            }
+        }
+    }
+    for (; i < n; i++) {
+        out[i] = simd::mod(a[i], m[i]);
+    }
+}
+
+/// n contiguous elements as an operand of sumProducts (a size known at run time)
+template <typename T>
+struct SpanOperand {
+    const T* data;
+
+    constexpr T operator[](size_t i) const { return data[i]; }
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        return n == P::width ? P::load(data + i) : simd::loadPartial<P>(data + i, n);
+    }
+};
+
+/// a[i] - b[i] of 2 runs as an operand of sumProducts (each element cast before the difference)
+template <typename T>
+struct SpanDifference {
+    const T* a;
+    const T* b;
+
+    constexpr SquareAccumulator<T> operator[](size_t i) const {
+        return static_cast<SquareAccumulator<T>>(a[i]) - static_cast<SquareAccumulator<T>>(b[i]);
+    }
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        return P::sub(SpanOperand<T>{a}.template packet<P>(i, n), SpanOperand<T>{b}.template packet<P>(i, n));
+    }
+};
+
+template <typename T>
+struct ExprTraits<SpanOperand<T>> {
+    static constexpr bool isExpr = false;
+    static constexpr bool isVector = false;
+    using value_type = T;
+};
+
+template <typename T>
+struct ExprTraits<SpanDifference<T>> : ExprTraits<SpanOperand<T>> {};
+
+/**
+ * @brief sum of a[i] * b[i] for i in [0, n) accumulated in Acc with a summation mode,
+ * n known at run time (the runtime bounds of reduceKernel, on the widest packets)
+ */
+template <typename Acc, typename Mode, typename A, typename B>
+inline Acc spanReduce(const A& a, const B& b, size_t n) {
+    if constexpr (std::is_same_v<Mode, summation::Pairwise> && std::is_floating_point_v<Acc>) {
+        return pairwiseSumProducts<Acc, 64>(a, b, 0, n);
+    } else {
+        using M = std::conditional_t<std::is_floating_point_v<Acc>, Mode, summation::Naive>;
+        return sumProducts<Acc, M, 64>(a, b, 0, n).value();
+    }
+}
+
+/// sum of a[i] * b[i] for i in [0, n) in the compute type of T (see Vector::dot)
+template <typename T>
+inline simd::ComputeType<T> spanDot(const T* a, const T* b, size_t n) {
+    return spanReduce<simd::ComputeType<T>, summation::Naive>(SpanOperand<T>{a}, SpanOperand<T>{b}, n);
+}
+
+/// sum of a[i]^2 for i in [0, n) (int64_t for the integers, like Vector::squaredNorm)
+template <typename T>
+inline SquareAccumulator<T> spanSquaredNorm(const T* a, size_t n) {
+    return spanReduce<SquareAccumulator<T>, summation::Naive>(SpanOperand<T>{a}, SpanOperand<T>{a}, n);
+}
+
+/// sum of (a[i] - b[i])^2 for i in [0, n) (int64_t for the integers, like Vector::squaredDist)
+template <typename T>
+inline SquareAccumulator<T> spanSquaredDist(const T* a, const T* b, size_t n) {
+    const SpanDifference<T> difference{a, b};
+    return spanReduce<SquareAccumulator<T>, summation::Naive>(difference, difference, n);
+}
+
+} // namespace detail
+
+/**
+ * @brief structure of arrays container of Vector<T, N>: the component d of every vector
+ * is stored in its own contiguous lane, aligned on 64 bytes.
+ *
+ * The bulk kernels mirror the Vector API and process each lane in SIMD-wide chunks.
+ * The conversion from and to arrays of Vector (array of structures) is lossless.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of components of each vector
+ */
+template <typename T, size_t N>
+class VectorArray
+{
+private:
+    // number of elements of a lane between 2 aligned addresses
+    static constexpr size_t laneAlignment = std::max<size_t>(1, 64 / sizeof(T));
+
+    std::vector<T, AlignedAllocator<T>> storage;
+    size_t count{0};
+    // capacity of each lane (multiple of laneAlignment), lane d starts at d * stride
+    size_t stride{0};
+
+    // number of vectors processed at once by norm and dist
+    static constexpr size_t reductionBlock = 256;
+
+    void reallocate(size_t newStride);
+
+    // out[i - begin] = (*this)[i].dot(other[i]) for i in [begin, end), accumulated in Acc
+    template <typename Acc>
+    void dotRange(const VectorArray& other, size_t begin, size_t end, Acc* out) const;
+
+    // out[i - begin] = (*this)[i].squaredDist(query) for i in [begin, end), accumulated in Acc
+    template <typename Acc>
+    void squaredDistRange(const Vector<T, N>& query, size_t begin, size_t end, Acc* out) const;
+public:
+    using value_type = Vector<T, N>;
+
+    /**
+     * @brief writable access to one vector of the array
+     */
+    class Reference
+    {
+    private:
+        VectorArray& array;
+        size_t index;
+    public:
+        Reference(VectorArray& array, size_t index): array{array}, index{index} {}
+
+        inline operator Vector<T, N>() const { return static_cast<const VectorArray&>(array)[index]; }
+
+        inline Reference& operator=(const Vector<T, N>& vector) {
+            array.set(index, vector);
+            return *this;
+        }
+
+        /// component d of the vector
+        inline T& operator[](size_t d) { return array.lane(d)[index]; }
+        inline T operator[](size_t d) const { return array.lane(d)[index]; }
+
+        inline bool operator==(const Vector<T, N>& vector) const { return Vector<T, N>(*this) == vector; }
+        inline bool operator!=(const Vector<T, N>& vector) const { return !(*this == vector); }
+
+        friend std::ostream& operator<<(std::ostream& os, const Reference& reference) {
+            return os << Vector<T, N>(reference);
+        }
+    };
+
+    // size of each vector (for convenience)
+    static constexpr size_t dimension = N;
+    //**----------
+    VectorArray() = default;
+
+    /**
+     * @brief array of count null vectors
+     *
+     * @param count
+     */
+    explicit VectorArray(size_t count);
+
+    /**
+     * @brief copy an array of structures (lossless)
+     *
+     * @param vectors
+     * @param count
+     */
+    VectorArray(const Vector<T, N>* vectors, size_t count);
+
+    explicit VectorArray(const std::vector<Vector<T, N>>& vectors): VectorArray(vectors.data(), vectors.size()) {}
+    //**----------
+
+    /// number of vectors
+    inline size_t size() const noexcept { return count; }
+    inline bool empty() const noexcept { return count == 0; }
+    inline size_t capacity() const noexcept { return stride; }
+
+    /// lane of the component d (count contiguous values, aligned on 64 bytes)
+    inline T* lane(size_t d) noexcept { return storage.data() + d * stride; }
+    inline const T* lane(size_t d) const noexcept { return storage.data() + d * stride; }
+
+    void reserve(size_t newCapacity);
+
+    /// resize the array, the new vectors are null
+    void resize(size_t newSize);
+
+    inline void clear() noexcept { count = 0; }
+
+    /**
+     * @brief append a vector
+     *
+     * @param vector
+     */
+    void push_back(const Vector<T, N>& vector);
+
+    /**
+     * @brief vector at index i (read, returns a copy)
+     *
+     * @param i
+     * @return Vector
+     */
+    Vector<T, N> operator[](size_t i) const;
+
+    /**
+     * @brief vector at index i (write, returns a proxy)
+     *
+     * @param i
+     * @return Reference
+     */
+    inline Reference operator[](size_t i) { return Reference(*this, i); }
+
+    /**
+     * @brief replace the vector at index i
+     *
+     * @param i
+     * @param vector
+     */
+    void set(size_t i, const Vector<T, N>& vector);
+
+    /**
+     * @brief copy the array into an array of structures of size() vectors (lossless)
+     *
+     * @param out
+     */
+    void copyTo(Vector<T, N>* out) const;
+
+    /**
+     * @brief convert to an array of structures
+     *
+     * @return std::vector<Vector<T, N>>
+     */
+    std::vector<Vector<T, N>> toVectors() const;
+
+    //* ------------------ bulk kernels ------------------ *//
+
+    /// element by element sum of 2 arrays of the same size
+    VectorArray operator+(const VectorArray& other) const;
+    /// element by element substraction
+    VectorArray operator-(const VectorArray& other) const;
+    /// element by element product
+    VectorArray operator*(const VectorArray& other) const;
+    /// element by element division
+    VectorArray operator/(const VectorArray& other) const;
+    /// multiply every vector by a scalar
+    VectorArray operator*(T scalar) const;
+    /// divide every vector by a scalar
+    VectorArray operator/(T scalar) const;
+
+    VectorArray& operator+=(const VectorArray& other);
+    VectorArray& operator-=(const VectorArray& other);
+    VectorArray& operator*=(const VectorArray& other);
+    VectorArray& operator/=(const VectorArray& other);
+    VectorArray& operator*=(T scalar);
+    VectorArray& operator/=(T scalar);
+
+    /**
+     * @brief add the same vector to every vector of the array
+     *
+     * @param vector
+     * @return VectorArray&
+     */
+    VectorArray& operator+=(const Vector<T, N>& vector);
+
+    /**
+     * @brief out[i] = (*this)[i].dot(other[i])
+     *
+     * @param other an array of the same size
+     * @param out size() values
+     */
+    void dot(const VectorArray& other, T* out) const;
+
+    /**
+     * @brief out[i] = (*this)[i].dot(vector)
+     *
+     * @param vector
+     * @param out size() values
+     */
+    void dot(const Vector<T, N>& vector, T* out) const;
+
+    /**
+     * @brief out[i] = (*this)[i].dot((*this)[i]), computed in T: the squares of the integers can
+     * overflow T, unlike Vector::squaredNorm and norm() that accumulate them in int64_t
+     *
+     * @param out size() values
+     */
+    void squaredNorm(T* out) const;
+
+    /**
+     * @brief out[i] = (*this)[i].norm() (accumulated in int64_t for the integers)
+     *
+     * @param out size() values
+     */
+    void norm(double* out) const;
+
+    /**
+     * @brief out[i] = squared distance between (*this)[i] and query, computed in T: the squares of
+     * the integers can overflow T, unlike Vector::squaredDist and dist() that accumulate them in int64_t
+     *
+     * @param query
+     * @param out size() values
+     */
+    void squaredDist(const Vector<T, N>& query, T* out) const;
+
+    /**
+     * @brief squaredDist(query, out) for the vectors i in [begin, end): out[i - begin]
+     *
+     * @param query
+     * @param begin
+     * @param end
+     * @param out end - begin values
+     */
+    void squaredDist(const Vector<T, N>& query, size_t begin, size_t end, T* out) const;
+
+    /**
+     * @brief out[i] = (*this)[i].dist(query) (accumulated in int64_t for the integers)
+     *
+     * @param query
+     * @param out size() values
+     */
+    void dist(const Vector<T, N>& query, double* out) const;
+
+    /**
+     * @brief true modulo of every vector by another vector (periodic box)
+     *
+     * @param vector
+     * @return VectorArray
+     */
+    VectorArray mod(const Vector<T, N>& vector) const;
+
+    /**
+     * @brief true modulo of every element by a scalar
+     *
+     * @param scalar
+     * @return VectorArray
+     */
+    VectorArray mod(T scalar) const;
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+VectorArray<T, N>::VectorArray(size_t count) {
+    resize(count);
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>::VectorArray(const Vector<T, N>* vectors, size_t count) {
+    reserve(count);
+    this->count = count;
+    for (size_t d = 0; d < N; d++) {
+        T* dst = lane(d);
+        for (size_t i = 0; i < count; i++) {
+            dst[i] = vectors[i][d];
+        }
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::reallocate(size_t newStride) {
+    std::vector<T, AlignedAllocator<T>> newStorage(N * newStride);
+    for (size_t d = 0; d < N; d++) {
+        std::copy(lane(d), lane(d) + count, newStorage.data() + d * newStride);
+    }
+    storage.swap(newStorage);
+    stride = newStride;
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::reserve(size_t newCapacity) {
+    if (newCapacity > stride) {
+        reallocate((newCapacity + laneAlignment - 1) / laneAlignment * laneAlignment);
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::resize(size_t newSize) {
+    reserve(newSize);
+    for (size_t d = 0; d < N; d++) {
+        std::fill(lane(d) + std::min(count, newSize), lane(d) + newSize, T{});
+    }
+    count = newSize;
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::push_back(const Vector<T, N>& vector) {
+    if (count == stride) {
+        reserve(std::max(2 * stride, laneAlignment));
+    }
+    set(count++, vector);
+}
+
+template <typename T, size_t N>
+Vector<T, N> VectorArray<T, N>::operator[](size_t i) const {
+    Vector<T, N> result;
+    for (size_t d = 0; d < N; d++) {
+        result[d] = lane(d)[i];
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::set(size_t i, const Vector<T, N>& vector) {
+    for (size_t d = 0; d < N; d++) {
+        lane(d)[i] = vector[d];
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::copyTo(Vector<T, N>* out) const {
+    for (size_t d = 0; d < N; d++) {
+        const T* src = lane(d);
+        for (size_t i = 0; i < count; i++) {
+            out[i][d] = src[i];
+        }
+    }
+}
+
+template <typename T, size_t N>
+std::vector<Vector<T, N>> VectorArray<T, N>::toVectors() const {
+    std::vector<Vector<T, N>> result(count);
+    copyTo(result.data());
+    return result;
+}
+
+// element by element operations: one pass per lane
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator+(const VectorArray& other) const {
+    VectorArray result(*this);
+    return result += other;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator-(const VectorArray& other) const {
+    VectorArray result(*this);
+    return result -= other;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator*(const VectorArray& other) const {
+    VectorArray result(*this);
+    return result *= other;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator/(const VectorArray& other) const {
+    VectorArray result(*this);
+    return result /= other;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator*(T scalar) const {
+    VectorArray result(*this);
+    return result *= scalar;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::operator/(T scalar) const {
+    VectorArray result(*this);
+    return result /= scalar;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator+=(const VectorArray& other) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanBinary<detail::Add>(lane(d), other.lane(d), lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator-=(const VectorArray& other) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanBinary<detail::Sub>(lane(d), other.lane(d), lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator*=(const VectorArray& other) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanBinary<detail::Mul>(lane(d), other.lane(d), lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator/=(const VectorArray& other) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanBinary<detail::Div>(lane(d), other.lane(d), lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator*=(T scalar) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanScalar<detail::Mul>(lane(d), scalar, lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator/=(T scalar) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanScalar<detail::Div>(lane(d), scalar, lane(d), count);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N>& VectorArray<T, N>::operator+=(const Vector<T, N>& vector) {
+    for (size_t d = 0; d < N; d++) {
+        detail::spanScalar<detail::Add>(lane(d), vector[d], lane(d), count);
+    }
+    return *this;
+}
+
+// reductions over the components: the packets run along the vectors, so there is
+// no horizontal sum and out[i] gets the same value as the scalar loop.
+// Acc is T, or detail::SquareAccumulator<T> for the norms and distances returned as double
+
+template <typename T, size_t N>
+template <typename Acc>
+void VectorArray<T, N>::dotRange(const VectorArray& other, size_t begin, size_t end, Acc* out) const {
+    size_t i = begin;
+    if constexpr (simd::hasPacket<T, 64> && std::is_same_v<Acc, T>) {
+        using P = simd::WidestPacket<T>;
+        for (; i + P::width <= end; i += P::width) {
+            auto acc = P::zero();
+            for (size_t d = 0; d < N; d++) {
+                acc = P::add(acc, P::mul(P::load(lane(d) + i), P::load(other.lane(d) + i)));
+            }
+            P::store(out + i - begin, acc);
+        }
+    }
+    for (; i < end; i++) {
+        Acc acc{0};
+        for (size_t d = 0; d < N; d++) {
+            acc += static_cast<Acc>(lane(d)[i]) * static_cast<Acc>(other.lane(d)[i]);
+        }
+        out[i - begin] = acc;
+    }
+}
+
+template <typename T, size_t N>
+template <typename Acc>
+void VectorArray<T, N>::squaredDistRange(const Vector<T, N>& query, size_t begin, size_t end, Acc* out) const {
+    size_t i = begin;
+    if constexpr (simd::hasPacket<T, 64> && std::is_same_v<Acc, T>) {
+        using P = simd::WidestPacket<T>;
+        for (; i + P::width <= end; i += P::width) {
+            auto acc = P::zero();
+            for (size_t d = 0; d < N; d++) {
+                const auto diff = P::sub(P::load(lane(d) + i), P::set1(query[d]));
+                acc = P::add(acc, P::mul(diff, diff));
+            }
+            P::store(out + i - begin, acc);
+        }
+    }
+    for (; i < end; i++) {
+        Acc acc{0};
+        for (size_t d = 0; d < N; d++) {
+            const Acc diff = static_cast<Acc>(lane(d)[i]) - static_cast<Acc>(query[d]);
+            acc += diff * diff;
+        }
+        out[i - begin] = acc;
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::squaredDist(const Vector<T, N>& query, size_t begin, size_t end, T* out) const {
+    squaredDistRange(query, begin, end, out);
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::dot(const VectorArray& other, T* out) const {
+    dotRange(other, 0, count, out);
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::dot(const Vector<T, N>& vector, T* out) const {
+    size_t i = 0;
+    if constexpr (simd::hasPacket<T, 64>) {
+        using P = simd::WidestPacket<T>;
+        for (; i + P::width <= count; i += P::width) {
+            auto acc = P::zero();
+            for (size_t d = 0; d < N; d++) {
+                acc = P::add(acc, P::mul(P::load(lane(d) + i), P::set1(vector[d])));
+            }
+            P::store(out + i, acc);
+        }
+    }
+    for (; i < count; i++) {
+        T acc{0};
+        for (size_t d = 0; d < N; d++) {
+            acc += lane(d)[i] * vector[d];
+        }
+        out[i] = acc;
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::squaredNorm(T* out) const {
+    dotRange(*this, 0, count, out);
+}
+
+// the square roots are taken by blocks, to keep the SIMD kernels without a full size temporary
+
+template <typename T, size_t N>
+void VectorArray<T, N>::norm(double* out) const {
+    detail::SquareAccumulator<T> squared[reductionBlock];
+    for (size_t begin = 0; begin < count; begin += reductionBlock) {
+        const size_t end = std::min(count, begin + reductionBlock);
+        dotRange(*this, begin, end, squared);
+        for (size_t i = begin; i < end; i++) {
+            out[i] = std::sqrt(static_cast<double>(squared[i - begin]));
+        }
+    }
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::squaredDist(const Vector<T, N>& query, T* out) const {
+    squaredDist(query, 0, count, out);
+}
+
+template <typename T, size_t N>
+void VectorArray<T, N>::dist(const Vector<T, N>& query, double* out) const {
+    detail::SquareAccumulator<T> squared[reductionBlock];
+    for (size_t begin = 0; begin < count; begin += reductionBlock) {
+        const size_t end = std::min(count, begin + reductionBlock);
+        squaredDistRange(query, begin, end, squared);
+        for (size_t i = begin; i < end; i++) {
+            out[i] = std::sqrt(static_cast<double>(squared[i - begin]));
+        }
+    }
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::mod(const Vector<T, N>& vector) const {
+    VectorArray result(*this);
+    for (size_t d = 0; d < N; d++) {
+        detail::spanMod(lane(d), vector[d], result.lane(d), count);
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+VectorArray<T, N> VectorArray<T, N>::mod(T scalar) const {
+    VectorArray result(*this);
+    for (size_t d = 0; d < N; d++) {
+        detail::spanMod(lane(d), scalar, result.lane(d), count);
+    }
+    return result;
+}
+
+}
@@ -0,0 +1,1331 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cmath> // sqrt
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "VectorSimd.hpp"
+#include "Profile.hpp"
+
+namespace VectorND {
+
+template <typename T, size_t N>
+class Vector;
+
+/**
+ * @brief summation modes of the reductions with a chosen accumulator (dot<Acc, Mode>, ...).
+ * Every mode runs on SIMD lanes with several independent accumulators.
+ */
+namespace summation {
+
+/// left to right sum: the error grows with N
+struct Naive {};
+
+/// pairwise (tree) sum of naive blocks: the error grows with log(N)
+struct Pairwise {};
+
+/// compensated sum (Kahan-Babuska / Neumaier, with the branch free TwoSum): the error does not grow with N
+struct Kahan {};
+
+} // namespace summation
+
+/**
+ * @brief base class of every lazy vector expression (CRTP)
+ *
+ * The arithmetic operators (+, -, *, /, unary -) do not compute anything: they return
+ * small expression nodes that are evaluated element by element, in a single loop,
+ * when assigned to a Vector or passed to dot / squaredNorm / norm / squaredDist / dist.
+ *
+ * For float and double the loop runs on SIMD packets (see VectorSimd.hpp): every node
+ * also provides packet(i, n), the lanes [i, i + n) of the expression.
+ *
+ * Expressions keep a reference to the lvalue vectors they are built from, so an
+ * expression stored with auto must not outlive its operands (rvalue operands are moved
+ * into the expression and are safe).
+ *
+ * @tparam E the derived expression type
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename E, typename T, size_t N>
+class VectorExpr
+{
+public:
+    using value_type = T;
+
+    // size of the vector (for convenience)
+    static constexpr size_t size = N;
+
+    /// the derived expression
+    constexpr const E& self() const noexcept { return static_cast<const E&>(*this); }
+
+    /**
+     * @brief evaluate the expression into a new vector
+     *
+     * @return Vector
+     */
+    constexpr Vector<T, N> eval() const { return Vector<T, N>(*this); }
+
+    /**
+     * @brief return dot product with another vector or expression
+     *
+     * @param other
+     * @return T
+     */
+    template <typename O>
+    constexpr T dot(const O& other) const;
+
+    /**
+     * @brief return the absolute squared norm of the expression
+     *
+     * @return double
+     */
+    constexpr double squaredNorm() const;
+
+    /**
+     * @brief return the euclidean norm of the expression
+     *
+     * @return double
+     */
+    constexpr double norm() const;
+
+    /**
+     * @brief return the squared distance to another vector or expression
+     *
+     * @param other
+     * @return double
+     */
+    template <typename O>
+    constexpr double squaredDist(const O& other) const;
+
+    /**
+     * @brief return the euclidean distance to another vector or expression
+     *
+     * @param other
+     * @return double
+     */
+    template <typename O>
+    constexpr double dist(const O& other) const;
+
+    /**
+     * @brief element by element true modulo, in a single loop
+     *
+     * @param other
+     * @return Vector
+     */
+    constexpr Vector<T, N> mod(const Vector<T, N>& other) const;
+
+    /**
+     * @brief element by element true modulo by another expression, in a single loop
+     *
+     * @param other
+     * @return Vector
+     */
+    template <typename O>
+    constexpr Vector<T, N> mod(const VectorExpr<O, T, N>& other) const;
+
+    /**
+     * @brief true modulo by a scalar, in a single loop
+     *
+     * @param scalar
+     * @return Vector
+     */
+    constexpr Vector<T, N> mod(T scalar) const;
+
+    /**
+     * @brief reverse the order of the elements
+     *
+     * @return Vector
+     */
+    constexpr Vector<T, N> reverse() const;
+
+    /**
+     * @brief the expression scaled to a norm of 1 (evaluates the expression)
+     *
+     * @return Vector
+     */
+    constexpr Vector<T, N> normalized() const { return eval().normalize(); }
+
+    /**
+     * @brief euclidean distance to another vector or expression, without temporary
+     *
+     * @param other
+     * @return double
+     */
+    template <typename O>
+    constexpr double distanceTo(const O& other) const;
+};
+
+namespace detail {
+
+//* ------------------ expression traits ------------------ *//
+
+template <typename X>
+struct ExprTraits {
+    static constexpr bool isExpr = false;
+    static constexpr bool isVector = false;
+};
+
+template <typename T, size_t N>
+struct ExprTraits<Vector<T, N>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = true;
+    using value_type = T;
+    static constexpr size_t size = N;
+};
+
+template <typename X>
+using Decay = std::remove_cv_t<std::remove_reference_t<X>>;
+
+/// true for Vector and for every expression node
+template <typename X>
+constexpr bool isExpr = ExprTraits<Decay<X>>::isExpr;
+
+/// true if the two operands can be combined (same element type and size)
+template <typename L, typename R, bool = isExpr<L> && isExpr<R>>
+constexpr bool areCompatible = false;
+
+template <typename L, typename R>
+constexpr bool areCompatible<L, R, true> =
+    std::is_same_v<typename ExprTraits<Decay<L>>::value_type, typename ExprTraits<Decay<R>>::value_type>
+    && ExprTraits<Decay<L>>::size == ExprTraits<Decay<R>>::size;
+
+/// element type of an expression (non deduced context, allows implicit scalar conversions)
+template <typename X>
+using ExprValue = typename ExprTraits<Decay<X>>::value_type;
+
+/// number of elements of an expression
+template <typename X>
+constexpr size_t exprSize = ExprTraits<Decay<X>>::size;
+
+/// true if E is a vector or an expression of N elements of type T
+template <typename E, typename T, size_t N, bool = isExpr<E>>
+constexpr bool isExprOf = false;
+
+template <typename E, typename T, size_t N>
+constexpr bool isExprOf<E, T, N, true> = std::is_same_v<ExprValue<E>, T> && exprSize<E> == N;
+
+/// true if E is a vector or an expression of N elements of a type other than U
+template <typename E, typename U, size_t N, bool = isExpr<E>>
+constexpr bool isExprOfOther = false;
+
+template <typename E, typename U, size_t N>
+constexpr bool isExprOfOther<E, U, N, true> = !std::is_same_v<ExprValue<E>, U> && exprSize<E> == N;
+
+/**
+ * @brief how an operand is stored inside an expression node:
+ * lvalue vectors by reference, rvalue vectors and expression nodes by value
+ */
+template <typename X>
+using ExprOperand = std::conditional_t<
+    std::is_lvalue_reference_v<X> && ExprTraits<Decay<X>>::isVector,
+    const Decay<X>&,
+    Decay<X>>;
+
+//* ------------------ constant evaluation ------------------ *//
+
+/**
+ * @brief true inside a constant expression (C++20 std::is_constant_evaluated, or the builtin
+ * the compilers also provide in C++17). The kernels then take their scalar path: the SIMD
+ * intrinsics and std::sqrt / std::fmod are not constexpr.
+ */
+constexpr bool isConstantEvaluated() noexcept {
+#if defined(__cpp_lib_is_constant_evaluated)
+    return std::is_constant_evaluated();
+#elif defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+//* ------------------ element-wise operations ------------------ *//
+
+struct Add {
+    template <typename T>
+    static constexpr T apply(T a, T b) { return static_cast<T>(a + b); }
+    template <typename P>
+    static inline typename P::type applyPacket(typename P::type a, typename P::type b) { return P::add(a, b); }
+};
+
+struct Sub {
+    template <typename T>
+    static constexpr T apply(T a, T b) { return static_cast<T>(a - b); }
+    template <typename P>
+    static inline typename P::type applyPacket(typename P::type a, typename P::type b) { return P::sub(a, b); }
+};
+
+struct Mul {
+    template <typename T>
+    static constexpr T apply(T a, T b) { return static_cast<T>(a * b); }
+    template <typename P>
+    static inline typename P::type applyPacket(typename P::type a, typename P::type b) { return P::mul(a, b); }
+};
+
+struct Div {
+    template <typename T>
+    static constexpr T apply(T a, T b) { return static_cast<T>(a / b); }
+    template <typename P>
+    static inline typename P::type applyPacket(typename P::type a, typename P::type b) { return P::div(a, b); }
+};
+
+//* ------------------ packet access ------------------ *//
+
+/// lanes [i, i + n) of an expression node
+template <typename P, typename E, std::enable_if_t<!ExprTraits<E>::isVector, int> = 0>
+inline typename P::type packetOf(const E& e, size_t i, size_t n) {
+    return e.template packet<P>(i, n);
+}
+
+/**
+ * lanes [i, i + n) of a vector, the lanes after n are 0. When the storage of the vector
+ * holds the whole last packet (the padding of AlignedVector), it is loaded in full and masked.
+ */
+template <typename P, typename V, std::enable_if_t<ExprTraits<V>::isVector, int> = 0>
+inline typename P::type packetOf(const V& v, size_t i, size_t n) {
+    constexpr size_t N = ExprTraits<V>::size;
+    constexpr size_t paddedSize = (N + P::width - 1) / P::width * P::width;
+    if (n == P::width) {
+        return P::load(v.cbegin() + i);
+    }
+    if constexpr (sizeof(V) >= paddedSize * sizeof(typename P::value_type)) {
+        return simd::keepFirst<P>(P::load(v.cbegin() + i), n);
+    } else {
+        return simd::loadPartial<P>(v.cbegin() + i, n);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief a scalar broadcast to the N elements of a vector expression
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class ScalarExpr : public VectorExpr<ScalarExpr<T, N>, T, N>
+{
+private:
+    T value;
+public:
+    constexpr explicit ScalarExpr(T value): value{value} {}
+
+    constexpr T operator[](size_t) const { return value; }
+
+    template <typename P>
+    inline typename P::type packet(size_t, size_t) const { return P::set1(value); }
+};
+
+/**
+ * @brief element by element binary operation between two expressions
+ *
+ * @tparam Op the operation (detail::Add, detail::Sub, detail::Mul, detail::Div)
+ * @tparam L the stored left operand
+ * @tparam R the stored right operand
+ */
+template <typename Op, typename L, typename R>
+class BinaryExpr : public VectorExpr<BinaryExpr<Op, L, R>,
+                                     typename detail::ExprTraits<detail::Decay<L>>::value_type,
+                                     detail::ExprTraits<detail::Decay<L>>::size>
+{
+private:
+    L lhs;
+    R rhs;
+public:
+    template <typename A, typename B>
+    constexpr BinaryExpr(A&& lhs, B&& rhs): lhs{std::forward<A>(lhs)}, rhs{std::forward<B>(rhs)} {}
+
+    constexpr auto operator[](size_t i) const { return Op::apply(lhs[i], rhs[i]); }
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        return Op::template applyPacket<P>(detail::packetOf<P>(lhs, i, n), detail::packetOf<P>(rhs, i, n));
+    }
+};
+
+/**
+ * @brief element by element negation of an expression
+ *
+ * @tparam E the stored operand
+ */
+template <typename E>
+class NegateExpr : public VectorExpr<NegateExpr<E>,
+                                     typename detail::ExprTraits<detail::Decay<E>>::value_type,
+                                     detail::ExprTraits<detail::Decay<E>>::size>
+{
+private:
+    using T = typename detail::ExprTraits<detail::Decay<E>>::value_type;
+    E operand;
+public:
+    template <typename A>
+    constexpr explicit NegateExpr(A&& operand): operand{std::forward<A>(operand)} {}
+
+    constexpr T operator[](size_t i) const { return static_cast<T>(-operand[i]); }
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const { return P::neg(detail::packetOf<P>(operand, i, n)); }
+};
+
+/**
+ * @brief element by element fused multiply-add: a * b + c (see VectorND::fma)
+ *
+ * @tparam A the stored first factor
+ * @tparam B the stored second factor
+ * @tparam C the stored addend
+ */
+template <typename A, typename B, typename C>
+class FmaExpr : public VectorExpr<FmaExpr<A, B, C>,
+                                  typename detail::ExprTraits<detail::Decay<A>>::value_type,
+                                  detail::ExprTraits<detail::Decay<A>>::size>
+{
+private:
+    using T = typename detail::ExprTraits<detail::Decay<A>>::value_type;
+    A a;
+    B b;
+    C c;
+public:
+    template <typename X, typename Y, typename Z>
+    constexpr FmaExpr(X&& a, Y&& b, Z&& c): a{std::forward<X>(a)}, b{std::forward<Y>(b)}, c{std::forward<Z>(c)} {}
+
+    constexpr T operator[](size_t i) const {
+#if defined(__FMA__)
+        // rounded once, as the packets
+        if constexpr (std::is_floating_point_v<T>) {
+            if (!detail::isConstantEvaluated()) {
+                return std::fma(static_cast<T>(a[i]), static_cast<T>(b[i]), static_cast<T>(c[i]));
+            }
+        }
+#endif
+        return static_cast<T>(a[i] * b[i] + c[i]);
+    }
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        return P::fmadd(detail::packetOf<P>(a, i, n), detail::packetOf<P>(b, i, n), detail::packetOf<P>(c, i, n));
+    }
+};
+
+namespace detail {
+
+template <typename T, size_t N>
+struct ExprTraits<ScalarExpr<T, N>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = false;
+    using value_type = T;
+    static constexpr size_t size = N;
+};
+
+template <typename Op, typename L, typename R>
+struct ExprTraits<BinaryExpr<Op, L, R>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = false;
+    using value_type = typename ExprTraits<Decay<L>>::value_type;
+    static constexpr size_t size = ExprTraits<Decay<L>>::size;
+};
+
+template <typename E>
+struct ExprTraits<NegateExpr<E>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = false;
+    using value_type = typename ExprTraits<Decay<E>>::value_type;
+    static constexpr size_t size = ExprTraits<Decay<E>>::size;
+};
+
+template <typename A, typename B, typename C>
+struct ExprTraits<FmaExpr<A, B, C>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = false;
+    using value_type = typename ExprTraits<Decay<A>>::value_type;
+    static constexpr size_t size = ExprTraits<Decay<A>>::size;
+};
+
+/// true only for expression nodes (not for Vector)
+template <typename X>
+constexpr bool isNode = isExpr<X> && !ExprTraits<Decay<X>>::isVector;
+
+template <typename Op, typename L, typename R>
+constexpr auto makeBinary(L&& lhs, R&& rhs) {
+    return BinaryExpr<Op, ExprOperand<L&&>, ExprOperand<R&&>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename Op, typename L>
+constexpr auto makeBinaryScalar(L&& lhs, ExprValue<L> scalar) {
+    using S = ScalarExpr<ExprValue<L>, ExprTraits<Decay<L>>::size>;
+    return BinaryExpr<Op, ExprOperand<L&&>, S>(std::forward<L>(lhs), S{scalar});
+}
+
+template <typename Op, typename R>
+constexpr auto makeScalarBinary(ExprValue<R> scalar, R&& rhs) {
+    using S = ScalarExpr<ExprValue<R>, ExprTraits<Decay<R>>::size>;
+    return BinaryExpr<Op, S, ExprOperand<R&&>>(S{scalar}, std::forward<R>(rhs));
+}
+
+template <typename A, typename B, typename C>
+constexpr auto makeFma(A&& a, B&& b, C&& c) {
+    return FmaExpr<ExprOperand<A&&>, ExprOperand<B&&>, ExprOperand<C&&>>(
+        std::forward<A>(a), std::forward<B>(b), std::forward<C>(c));
+}
+
+/// square root by Newton iterations (constant expressions only, within 1 ulp of std::sqrt)
+constexpr double constexprSqrt(double x) {
+    if (!(x > 0) || x == std::numeric_limits<double>::infinity()) {
+        // 0, inf, and nan for a negative value or nan
+        return x == 0 || x == std::numeric_limits<double>::infinity() ? x : std::numeric_limits<double>::quiet_NaN();
+    }
+    // scale x to [1, 4) so the iteration starts close and does not overflow
+    double scale = 1;
+    while (x >= 4) {
+        x /= 4;
+        scale *= 2;
+    }
+    while (x < 1) {
+        x *= 4;
+        scale /= 2;
+    }
+    // from r >= sqrt(x) the iterations decrease until they reach sqrt(x) (up to the rounding)
+    double r = x;
+    while (true) {
+        const double next = (r + x / r) / 2;
+        if (next >= r) {
+            break;
+        }
+        r = next;
+    }
+    return r * scale;
+}
+
+/// std::sqrt, usable in a constant expression
+constexpr double sqrt(double x) {
+    if (isConstantEvaluated()) {
+        return constexprSqrt(x);
+    }
+    return std::sqrt(x);
+}
+
+/**
+ * 1 / sqrt(x) of a floating-point scalar: simd::fastInvSqrt for a float at runtime (relative
+ * error below 5e-7), the exact value otherwise. x outside the normal floats (0, a subnormal,
+ * inf) takes the exact path, the estimate is meaningless there.
+ */
+template <typename T>
+constexpr T fastInvSqrt(T x) {
+    if constexpr (std::is_same_v<T, float>) {
+        if (!isConstantEvaluated() && x >= std::numeric_limits<float>::min() && x <= std::numeric_limits<float>::max()) {
+            return simd::fastInvSqrt(x);
+        }
+    }
+    return static_cast<T>(1 / sqrt(static_cast<double>(x)));
+}
+
+/// true modulo of a scalar in a constant expression, same sign rule as simd::mod: in [0, b) (or (b, 0] for a negative b)
+template <typename T>
+constexpr T constexprMod(T a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>((a % b + b) % b);
+    } else {
+        const T q = a / b;
+        // truncation of q, q is already an integer when it does not fit in an int64_t
+        T t = q;
+        if (q > -9.2e18 && q < 9.2e18) {
+            t = static_cast<T>(static_cast<int64_t>(q));
+        }
+        T r = a - b * t;
+        if (r != 0 && (r < 0) != (b < 0)) {
+            r += b;
+        }
+        // the rounding of a / b or of r + b can leave r on b
+        if (b > 0 ? r >= b : r <= b) {
+            r -= b;
+        }
+        return r;
+    }
+}
+
+//* ------------------ kernels ------------------ *//
+
+// each kernel takes its SIMD path at runtime and its scalar loop in a constant expression
+
+/**
+ * @brief evaluate an expression into dst[0..N). The packet loop reads the lanes
+ * [i, i + width) before writing them, so dst may be one of the operands.
+ */
+template <typename T, size_t N, typename E>
+constexpr void evaluate(T* dst, const E& e) {
+    if constexpr (simd::hasPacket<T, N>) {
+        if (!isConstantEvaluated()) {
+            using P = simd::PacketFor<T, N>;
+            size_t i = 0;
+            for (; i + P::width <= N; i += P::width) {
+                P::store(dst + i, packetOf<P>(e, i, P::width));
+            }
+            if constexpr (N % P::width != 0) {
+                simd::storePartial<P>(dst + i, packetOf<P>(e, i, N % P::width), N % P::width);
+            }
+            return;
+        }
+    }
+    for (size_t i = 0; i < N; i++) {
+        dst[i] = e[i];
+    }
+}
+
+//* ------------------ summation ------------------ *//
+
+/// independent accumulators of a reduction loop: the adds do not wait for each other
+constexpr size_t reductionAccumulators = 4;
+
+/**
+ * @brief f(k) for k = 0 .. K - 1, unrolled at compile time: an array of packet accumulators
+ * indexed by constants stays in registers even when the loop bounds are known at run time
+ */
+template <typename F, size_t... K>
+inline void forEachAccumulator(F&& f, std::index_sequence<K...>) {
+    (f(K), ...);
+}
+
+/// elements of a block summed naively by the pairwise summation
+constexpr size_t pairwiseBlock = 128;
+
+/// accumulator of the reductions returned as double (norms, distances): int64_t for the
+/// integers (the squares of Vector<int8_t, N> overflow int8_t), the compute type otherwise
+template <typename T>
+using SquareAccumulator = std::conditional_t<std::is_integral_v<T>, int64_t, simd::ComputeType<T>>;
+
+/**
+ * @brief error free sum (Knuth's TwoSum): sum + error == a + b exactly. No branch, so it
+ * also runs on packets (Add / Sub are the scalar or the packet operations).
+ */
+template <typename T>
+constexpr void twoSum(T a, T b, T& sum, T& error) {
+    sum = a + b;
+    const T z = sum - a;
+    error = (a - (sum - z)) + (b - z);
+}
+
+/// running sum in Acc for a summation mode (Naive and Pairwise blocks: plain sum)
+template <typename Acc, typename Mode>
+struct ScalarAccumulator {
+    Acc sum{0};
+    Acc compensation{0};
+
+    constexpr void add(Acc x) {
+        if constexpr (std::is_same_v<Mode, summation::Kahan> && std::is_floating_point_v<Acc>) {
+            Acc error{0};
+            twoSum(sum, x, sum, error);
+            compensation += error;
+        } else {
+            sum += x;
+        }
+    }
+
+    constexpr void add(const ScalarAccumulator& other) {
+        add(other.sum);
+        compensation += other.compensation;
+    }
+
+    constexpr Acc value() const { return sum + compensation; }
+};
+
+/// running sum of the lanes of a packet
+template <typename P, typename Mode>
+struct PacketAccumulator {
+    using T = simd::ComputeType<typename P::value_type>;
+    typename P::type sum;
+    typename P::type compensation;
+
+    inline void reset() {
+        sum = P::zero();
+        compensation = P::zero();
+    }
+
+    inline void addProduct(typename P::type a, typename P::type b) {
+        if constexpr (std::is_same_v<Mode, summation::Kahan>) {
+            const auto x = P::mul(a, b);
+            const auto s = P::add(sum, x);
+            const auto z = P::sub(s, sum);
+            compensation = P::add(compensation, P::add(P::sub(sum, P::sub(s, z)), P::sub(x, z)));
+            sum = s;
+        } else {
+            sum = P::fmadd(a, b, sum);
+        }
+    }
+
+    /// add another packet accumulator, lane by lane
+    inline void merge(const PacketAccumulator& other) {
+        if constexpr (std::is_same_v<Mode, summation::Kahan>) {
+            const auto s = P::add(sum, other.sum);
+            const auto z = P::sub(s, sum);
+            const auto error = P::add(P::sub(sum, P::sub(s, z)), P::sub(other.sum, z));
+            compensation = P::add(P::add(compensation, other.compensation), error);
+            sum = s;
+        } else {
+            sum = P::add(sum, other.sum);
+        }
+    }
+
+    /// add the lanes to a scalar accumulator
+    inline void flush(ScalarAccumulator<T, Mode>& total) const {
+        if constexpr (std::is_same_v<Mode, summation::Kahan>) {
+            using C = simd::ComputePacket<P>;
+            alignas(sizeof(typename P::type)) T lanes[P::width];
+            alignas(sizeof(typename P::type)) T errors[P::width];
+            C::store(lanes, sum);
+            C::store(errors, compensation);
+            for (size_t i = 0; i < P::width; i++) {
+                total.add(lanes[i]);
+                total.compensation += errors[i];
+            }
+        } else {
+            total.add(P::hsum(sum));
+        }
+    }
+};
+
+/// packet path of sumProducts (Acc is the compute type of the elements)
+template <typename Mode, size_t N, typename A, typename B>
+inline ScalarAccumulator<simd::ComputeType<ExprValue<A>>, Mode> sumProductsPacket(const A& a, const B& b,
+                                                                                  size_t begin, size_t end) {
+    using P = simd::PacketFor<ExprValue<A>, N>;
+    constexpr size_t W = P::width;
+    constexpr auto accumulators = std::make_index_sequence<reductionAccumulators>();
+    PacketAccumulator<P, Mode> acc[reductionAccumulators];
+    forEachAccumulator([&](size_t k) { acc[k].reset(); }, accumulators);
+    size_t i = begin;
+    for (; i + reductionAccumulators * W <= end; i += reductionAccumulators * W) {
+        forEachAccumulator([&](size_t k) {
+            acc[k].addProduct(packetOf<P>(a, i + k * W, W), packetOf<P>(b, i + k * W, W));
+        }, accumulators);
+    }
+    for (; i + W <= end; i += W) {
+        acc[0].addProduct(packetOf<P>(a, i, W), packetOf<P>(b, i, W));
+    }
+    // (rest < W is always true, it tells the compiler the partial loads stay in bounds)
+    const size_t rest = end - i;
+    if (rest > 0 && rest < W) {
+        // the padding lanes of an expression are not always 0 (s / v), drop them
+        const auto x = simd::keepFirst<P>(packetOf<P>(a, i, rest), rest);
+        const auto y = simd::keepFirst<P>(packetOf<P>(b, i, rest), rest);
+        acc[1].addProduct(x, y);
+    }
+    // a single horizontal sum
+    forEachAccumulator([&](size_t k) {
+        if (k > 0) {
+            acc[0].merge(acc[k]);
+        }
+    }, accumulators);
+    ScalarAccumulator<simd::ComputeType<ExprValue<A>>, Mode> total;
+    acc[0].flush(total);
+    return total;
+}
+
+/**
+ * @brief naive sum of a[i] * b[i] over the whole vectors, on packets of the element type.
+ * The bounds are known at compile time: no runtime tail, and only as many accumulators
+ * as there are full packets (a single horizontal sum).
+ */
+template <size_t N, typename A, typename B>
+inline simd::ComputeType<ExprValue<A>> dotPacket(const A& a, const B& b) {
+    using P = simd::PacketFor<ExprValue<A>, N>;
+    constexpr size_t W = P::width;
+    constexpr size_t K = N / W < 1 ? 1 : (N / W > reductionAccumulators ? reductionAccumulators : N / W);
+    typename P::type acc[K];
+    for (auto& partial : acc) {
+        partial = P::zero();
+    }
+    size_t i = 0;
+    for (; i + K * W <= N; i += K * W) {
+        for (size_t k = 0; k < K; k++) {
+            acc[k] = P::fmadd(packetOf<P>(a, i + k * W, W), packetOf<P>(b, i + k * W, W), acc[k]);
+        }
+    }
+    for (; i + W <= N; i += W) {
+        acc[0] = P::fmadd(packetOf<P>(a, i, W), packetOf<P>(b, i, W), acc[0]);
+    }
+    if constexpr (N % W != 0) {
+        // the padding lanes of an expression are not always 0 (s / v), drop them
+        const auto last = P::mul(packetOf<P>(a, i, N % W), packetOf<P>(b, i, N % W));
+        acc[0] = P::add(acc[0], simd::keepFirst<P>(last, N % W));
+    }
+    for (size_t k = 1; k < K; k++) {
+        acc[0] = P::add(acc[0], acc[k]);
+    }
+    return P::hsum(acc[0]);
+}
+
+/**
+ * @brief sum of a[i] * b[i] for i in [begin, end), accumulated in Acc (Naive or Kahan).
+ * Runs on SIMD packets when Acc is the compute type of the elements, with
+ * reductionAccumulators accumulators in both paths.
+ */
+template <typename Acc, typename Mode, size_t N, typename A, typename B>
+constexpr ScalarAccumulator<Acc, Mode> sumProducts(const A& a, const B& b, size_t begin, size_t end) {
+    if constexpr (std::is_same_v<Acc, simd::ComputeType<ExprValue<A>>> && simd::hasPacket<ExprValue<A>, N>) {
+        if (!isConstantEvaluated()) {
+            return sumProductsPacket<Mode, N>(a, b, begin, end);
+        }
+    }
+    ScalarAccumulator<Acc, Mode> acc[reductionAccumulators];
+    const size_t unrolledEnd = begin + (end - begin) / reductionAccumulators * reductionAccumulators;
+    for (size_t i = begin; i < unrolledEnd; i += reductionAccumulators) {
+        for (size_t k = 0; k < reductionAccumulators; k++) {
+            acc[k].add(static_cast<Acc>(a[i + k]) * static_cast<Acc>(b[i + k]));
+        }
+    }
+    for (size_t i = unrolledEnd; i < end; i++) {
+        acc[0].add(static_cast<Acc>(a[i]) * static_cast<Acc>(b[i]));
+    }
+    ScalarAccumulator<Acc, Mode> total;
+    for (size_t k = 0; k < reductionAccumulators; k++) {
+        total.add(acc[k]);
+    }
+    return total;
+}
+
+/// pairwise sum: naive blocks of pairwiseBlock elements, added as a binary tree
+template <typename Acc, size_t N, typename A, typename B>
+constexpr Acc pairwiseSumProducts(const A& a, const B& b, size_t begin, size_t end) {
+    if (end - begin <= pairwiseBlock) {
+        return sumProducts<Acc, summation::Naive, N>(a, b, begin, end).value();
+    }
+    // split on a multiple of the block, so the packets stay full
+    const size_t blocks = (end - begin + pairwiseBlock - 1) / pairwiseBlock;
+    const size_t middle = begin + blocks / 2 * pairwiseBlock;
+    return pairwiseSumProducts<Acc, N>(a, b, begin, middle) + pairwiseSumProducts<Acc, N>(a, b, middle, end);
+}
+
+/**
+ * @brief sum of a[i] * b[i] accumulated in Acc with a summation mode
+ * (the modes are equivalent for an integer Acc)
+ */
+template <typename Acc, typename Mode, size_t N, typename A, typename B>
+constexpr Acc reduceKernel(const A& a, const B& b) {
+    // a pairwise sum of a single block is the naive sum
+    constexpr bool naive = std::is_same_v<Mode, summation::Naive> ||
+                           (std::is_same_v<Mode, summation::Pairwise> && N <= pairwiseBlock);
+    if constexpr (naive && std::is_same_v<Acc, simd::ComputeType<ExprValue<A>>> && simd::hasPacket<ExprValue<A>, N>) {
+        if (!isConstantEvaluated()) {
+            return dotPacket<N>(a, b);
+        }
+    }
+    if constexpr (std::is_same_v<Mode, summation::Pairwise> && std::is_floating_point_v<Acc>) {
+        return pairwiseSumProducts<Acc, N>(a, b, 0, N);
+    } else {
+        using M = std::conditional_t<std::is_floating_point_v<Acc>, Mode, summation::Naive>;
+        return sumProducts<Acc, M, N>(a, b, 0, N).value();
+    }
+}
+
+/**
+ * @brief sum of a[i] * b[i] in T (in float, rounded at the end, for the 16 bits floats).
+ * The SIMD version accumulates per lane, in several accumulators, so float results can
+ * differ from the serial sum by a few ulps.
+ */
+template <typename T, size_t N, typename A, typename B>
+constexpr T dotKernel(const A& a, const B& b) {
+    return static_cast<T>(reduceKernel<simd::ComputeType<T>, summation::Naive, N>(a, b));
+}
+
+/**
+ * @brief sum of (a[i] - b[i])^2 in T: each difference goes straight into the accumulator
+ * (computed once per packet, not stored). The packets are used when T is the compute type
+ * of the elements.
+ */
+template <typename T, size_t N, typename A, typename B>
+constexpr T squaredDistKernel(const A& a, const B& b) {
+    if constexpr (std::is_same_v<T, simd::ComputeType<ExprValue<A>>> && simd::hasPacket<ExprValue<A>, N>) {
+        if (!isConstantEvaluated()) {
+            using P = simd::PacketFor<ExprValue<A>, N>;
+            auto acc = P::zero();
+            size_t i = 0;
+            for (; i + P::width <= N; i += P::width) {
+                const auto d = P::sub(packetOf<P>(a, i, P::width), packetOf<P>(b, i, P::width));
+                acc = P::fmadd(d, d, acc);
+            }
+            if constexpr (N % P::width != 0) {
+                const auto d = P::sub(packetOf<P>(a, i, N % P::width), packetOf<P>(b, i, N % P::width));
+                acc = P::add(acc, simd::keepFirst<P>(P::mul(d, d), N % P::width));
+            }
+            return P::hsum(acc);
+        }
+    }
+    T result{0};
+    for (size_t i = 0; i < N; i++) {
+        const T d = static_cast<T>(a[i]) - static_cast<T>(b[i]);
+        result += d * d;
+    }
+    return result;
+}
+
+/**
+ * @brief element by element equality
+ */
+template <typename T, size_t N, typename A, typename B>
+constexpr bool equalKernel(const A& a, const B& b) {
+    if constexpr (simd::hasPacket<T, N>) {
+        if (!isConstantEvaluated()) {
+            using P = simd::PacketFor<T, N>;
+            size_t i = 0;
+            for (; i + P::width <= N; i += P::width) {
+                if (!P::allEqual(packetOf<P>(a, i, P::width), packetOf<P>(b, i, P::width))) {
+                    return false;
+                }
+            }
+            if constexpr (N % P::width != 0) {
+                const auto last = simd::keepFirst<P>(packetOf<P>(a, i, N % P::width), N % P::width);
+                return P::allEqual(last, simd::keepFirst<P>(packetOf<P>(b, i, N % P::width), N % P::width));
+            }
+            return true;
+        }
+    }
+    for (size_t i = 0; i < N; i++) {
+        if (!(a[i] == b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// true if the true modulo of Vector<T, N> has a SIMD version
+template <typename T, size_t N, typename = void>
+constexpr bool hasPacketMod = false;
+
+template <typename T, size_t N>
+constexpr bool hasPacketMod<T, N, std::enable_if_t<simd::hasPacket<T, N>>> = simd::PacketFor<T, N>::hasMod;
+
+/**
+ * @brief true modulo of each element (simd::mod).
+ * The SIMD version computes a - b * floor(a / b) with FMA, with the same results.
+ */
+template <typename T, size_t N, typename A, typename B>
+constexpr void modKernel(T* dst, const A& a, const B& b) {
+    if (isConstantEvaluated()) {
+        for (size_t i = 0; i < N; i++) {
+            dst[i] = constexprMod<T>(a[i], b[i]);
+        }
+        return;
+    }
+    if constexpr (hasPacketMod<T, N>) {
+        using P = simd::PacketFor<T, N>;
+        size_t i = 0;
+        for (; i + P::width <= N; i += P::width) {
+            P::store(dst + i, P::mod(packetOf<P>(a, i, P::width), packetOf<P>(b, i, P::width)));
+        }
+        if constexpr (N % P::width != 0) {
+            const auto last = P::mod(packetOf<P>(a, i, N % P::width), packetOf<P>(b, i, N % P::width), N % P::width);
+            simd::storePartial<P>(dst + i, last, N % P::width);
+        }
+    } else {
+        for (size_t i = 0; i < N; i++) {
+            dst[i] = simd::mod<T>(a[i], b[i]);
+        }
+    }
+}
+
+} // namespace detail
+
+//* ------------------ operators ------------------ *//
+
+/**
+ * @brief lazy sum of 2 vectors or expressions
+ */
+template <typename L, typename R, typename = std::enable_if_t<detail::areCompatible<L, R>>>
+constexpr auto operator+(L&& lhs, R&& rhs) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<L>, detail::exprSize<L>, Add, 1, 3 * sizeof(detail::ExprValue<L>));
+    return detail::makeBinary<detail::Add>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * @brief lazy substraction of 2 vectors or expressions
+ */
+template <typename L, typename R, typename = std::enable_if_t<detail::areCompatible<L, R>>>
+constexpr auto operator-(L&& lhs, R&& rhs) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<L>, detail::exprSize<L>, Sub, 1, 3 * sizeof(detail::ExprValue<L>));
+    return detail::makeBinary<detail::Sub>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * @brief lazy element by element product
+ */
+template <typename L, typename R, typename = std::enable_if_t<detail::areCompatible<L, R>>>
+constexpr auto operator*(L&& lhs, R&& rhs) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<L>, detail::exprSize<L>, Mul, 1, 3 * sizeof(detail::ExprValue<L>));
+    return detail::makeBinary<detail::Mul>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * @brief lazy element by element division
+ */
+template <typename L, typename R, typename = std::enable_if_t<detail::areCompatible<L, R>>>
+constexpr auto operator/(L&& lhs, R&& rhs) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<L>, detail::exprSize<L>, Div, 1, 3 * sizeof(detail::ExprValue<L>));
+    return detail::makeBinary<detail::Div>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+/**
+ * @brief lazy product of a vector or expression by a scalar
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr auto operator*(E&& expr, detail::ExprValue<E> scalar) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Mul, 1, 2 * sizeof(detail::ExprValue<E>));
+    return detail::makeScalarBinary<detail::Mul>(scalar, std::forward<E>(expr));
+}
+
+/**
+ * @brief lazy product of a scalar by a vector or expression
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr auto operator*(detail::ExprValue<E> scalar, E&& expr) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Mul, 1, 2 * sizeof(detail::ExprValue<E>));
+    return detail::makeScalarBinary<detail::Mul>(scalar, std::forward<E>(expr));
+}
+
+/**
+ * @brief lazy division of a vector or expression by a scalar
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr auto operator/(E&& expr, detail::ExprValue<E> scalar) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Div, 1, 2 * sizeof(detail::ExprValue<E>));
+    return detail::makeBinaryScalar<detail::Div>(std::forward<E>(expr), scalar);
+}
+
+/**
+ * @brief lazy division of a scalar by a vector or expression
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr auto operator/(detail::ExprValue<E> scalar, E&& expr) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Div, 1, 2 * sizeof(detail::ExprValue<E>));
+    return detail::makeScalarBinary<detail::Div>(scalar, std::forward<E>(expr));
+}
+
+/**
+ * @brief lazy unary minus
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr auto operator-(E&& expr) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Negate, 1, 2 * sizeof(detail::ExprValue<E>));
+    return NegateExpr<detail::ExprOperand<E&&>>(std::forward<E>(expr));
+}
+
+// a std::array<T, N> operand is converted to a Vector<T, N> leaf (as by the implicit constructor)
+
+template <typename L, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<L, T, N>>>
+constexpr auto operator+(L&& lhs, const std::array<T, N>& rhs) {
+    return std::forward<L>(lhs) + Vector<T, N>(rhs);
+}
+
+template <typename R, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<R, T, N>>>
+constexpr auto operator+(const std::array<T, N>& lhs, R&& rhs) {
+    return Vector<T, N>(lhs) + std::forward<R>(rhs);
+}
+
+template <typename L, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<L, T, N>>>
+constexpr auto operator-(L&& lhs, const std::array<T, N>& rhs) {
+    return std::forward<L>(lhs) - Vector<T, N>(rhs);
+}
+
+template <typename R, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<R, T, N>>>
+constexpr auto operator-(const std::array<T, N>& lhs, R&& rhs) {
+    return Vector<T, N>(lhs) - std::forward<R>(rhs);
+}
+
+template <typename L, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<L, T, N>>>
+constexpr auto operator*(L&& lhs, const std::array<T, N>& rhs) {
+    return std::forward<L>(lhs) * Vector<T, N>(rhs);
+}
+
+template <typename R, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<R, T, N>>>
+constexpr auto operator*(const std::array<T, N>& lhs, R&& rhs) {
+    return Vector<T, N>(lhs) * std::forward<R>(rhs);
+}
+
+template <typename L, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<L, T, N>>>
+constexpr auto operator/(L&& lhs, const std::array<T, N>& rhs) {
+    return std::forward<L>(lhs) / Vector<T, N>(rhs);
+}
+
+template <typename R, typename T, size_t N, typename = std::enable_if_t<detail::isExprOf<R, T, N>>>
+constexpr auto operator/(const std::array<T, N>& lhs, R&& rhs) {
+    return Vector<T, N>(lhs) / std::forward<R>(rhs);
+}
+
+// a Vector<U, N> right operand of another element type is converted to the element type of the
+// left operand (as by the cast operator), as in the operators before expressions
+
+template <typename L, typename U, size_t N, typename = std::enable_if_t<detail::isExprOfOther<L, U, N>>>
+constexpr auto operator+(L&& lhs, const Vector<U, N>& rhs) {
+    return std::forward<L>(lhs) + static_cast<Vector<detail::ExprValue<L>, N>>(rhs);
+}
+
+template <typename L, typename U, size_t N, typename = std::enable_if_t<detail::isExprOfOther<L, U, N>>>
+constexpr auto operator-(L&& lhs, const Vector<U, N>& rhs) {
+    return std::forward<L>(lhs) - static_cast<Vector<detail::ExprValue<L>, N>>(rhs);
+}
+
+template <typename L, typename U, size_t N, typename = std::enable_if_t<detail::isExprOfOther<L, U, N>>>
+constexpr auto operator*(L&& lhs, const Vector<U, N>& rhs) {
+    return std::forward<L>(lhs) * static_cast<Vector<detail::ExprValue<L>, N>>(rhs);
+}
+
+template <typename L, typename U, size_t N, typename = std::enable_if_t<detail::isExprOfOther<L, U, N>>>
+constexpr auto operator/(L&& lhs, const Vector<U, N>& rhs) {
+    return std::forward<L>(lhs) / static_cast<Vector<detail::ExprValue<L>, N>>(rhs);
+}
+
+//* ------------------ fused expressions ------------------ *//
+
+/**
+ * @brief lazy fused multiply-add a * b + c, element by element. Floating-point elements are
+ * rounded once when the target has FMA, on the SIMD and scalar paths alike; without FMA, and in
+ * a constant expression, a * b and the sum are rounded separately, so the contraction is not
+ * guaranteed across targets.
+ */
+template <typename A, typename B, typename C,
+          typename = std::enable_if_t<detail::areCompatible<A, B> && detail::areCompatible<A, C>>>
+constexpr auto fma(A&& a, B&& b, C&& c) {
+    return detail::makeFma(std::forward<A>(a), std::forward<B>(b), std::forward<C>(c));
+}
+
+/**
+ * @brief lazy fused multiply-add by a scalar: a * scalar + c
+ */
+template <typename A, typename C, typename = std::enable_if_t<detail::areCompatible<A, C>>>
+constexpr auto fma(A&& a, detail::ExprValue<A> scalar, C&& c) {
+    using S = ScalarExpr<detail::ExprValue<A>, detail::ExprTraits<detail::Decay<A>>::size>;
+    return detail::makeFma(std::forward<A>(a), S{scalar}, std::forward<C>(c));
+}
+
+/**
+ * @brief lazy alpha * x + y (BLAS axpy), in a single pass (rounded as VectorND::fma)
+ */
+template <typename X, typename Y, typename = std::enable_if_t<detail::areCompatible<X, Y>>>
+constexpr auto axpy(detail::ExprValue<X> alpha, X&& x, Y&& y) {
+    return VectorND::fma(std::forward<X>(x), alpha, std::forward<Y>(y));
+}
+
+/**
+ * @brief lazy linear interpolation a + t * (b - a), in a single pass
+ */
+template <typename A, typename B, typename = std::enable_if_t<detail::areCompatible<A, B>>>
+constexpr auto lerp(A&& a, B&& b, detail::ExprValue<A> t) {
+    if constexpr (std::is_lvalue_reference_v<A>) {
+        return VectorND::fma(std::forward<B>(b) - a, t, a);
+    } else {
+        // a is used twice: the difference gets its own copy of an rvalue, the fma the original
+        return VectorND::fma(std::forward<B>(b) - detail::Decay<A>(a), t, std::move(a));
+    }
+}
+
+//* ------------------ fused reductions ------------------ *//
+
+/**
+ * @brief dot product of 2 vectors or expressions, evaluated in a single loop
+ *
+ * @param a
+ * @param b
+ * @return T
+ */
+template <typename A, typename B, typename = std::enable_if_t<detail::areCompatible<A, B>>>
+constexpr detail::ExprValue<A> dot(const A& a, const B& b) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<A>, detail::exprSize<A>, Dot, 2, 2 * sizeof(detail::ExprValue<A>));
+    return detail::dotKernel<detail::ExprValue<A>, detail::ExprTraits<A>::size>(a, b);
+}
+
+/**
+ * @brief dot product accumulated in Acc with a summation mode: dot<int32_t>(a, b) for
+ * Vector<int8_t, N>, dot<double, summation::Kahan>(a, b) for a long float vector...
+ *
+ * @tparam Acc the accumulator (and result) type
+ * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+ * @param a
+ * @param b
+ * @return Acc
+ */
+template <typename Acc, typename Mode = summation::Naive, typename A, typename B,
+          typename = std::enable_if_t<detail::areCompatible<A, B>>>
+constexpr Acc dot(const A& a, const B& b) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<A>, detail::exprSize<A>, Dot, 2, 2 * sizeof(detail::ExprValue<A>));
+    return detail::reduceKernel<Acc, Mode, detail::ExprTraits<A>::size>(a, b);
+}
+
+/**
+ * @brief absolute squared norm of a vector or expression, evaluated in a single loop
+ *
+ * @param e
+ * @return double
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr double squaredNorm(const E& e) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Norm, 2, sizeof(detail::ExprValue<E>));
+    using Acc = detail::SquareAccumulator<detail::ExprValue<E>>;
+    return static_cast<double>(detail::reduceKernel<Acc, summation::Naive, detail::ExprTraits<E>::size>(e, e));
+}
+
+/**
+ * @brief absolute squared norm accumulated in Acc with a summation mode
+ *
+ * @tparam Acc the accumulator (and result) type
+ * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+ * @param e
+ * @return Acc
+ */
+template <typename Acc, typename Mode = summation::Naive, typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr Acc squaredNorm(const E& e) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<E>, detail::exprSize<E>, Norm, 2, sizeof(detail::ExprValue<E>));
+    return detail::reduceKernel<Acc, Mode, detail::ExprTraits<E>::size>(e, e);
+}
+
+/**
+ * @brief euclidean norm, the squares accumulated in Acc with a summation mode
+ *
+ * @tparam Acc the accumulator type
+ * @tparam Mode summation::Naive, summation::Pairwise or summation::Kahan
+ * @param e
+ * @return double
+ */
+template <typename Acc, typename Mode = summation::Naive, typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr double norm(const E& e) {
+    return detail::sqrt(static_cast<double>(VectorND::squaredNorm<Acc, Mode>(e)));
+}
+
+/**
+ * @brief euclidean norm of a vector or expression
+ *
+ * @param e
+ * @return double
+ */
+template <typename E, typename = std::enable_if_t<detail::isExpr<E>>>
+constexpr double norm(const E& e) {
+    return detail::sqrt(VectorND::squaredNorm(e));
+}
+
+/**
+ * @brief squared distance between 2 vectors or expressions, without temporary
+ *
+ * @param a
+ * @param b
+ * @return double
+ */
+template <typename A, typename B, typename = std::enable_if_t<detail::areCompatible<A, B>>>
+constexpr double squaredDist(const A& a, const B& b) {
+    VECTORND_PROFILE_COUNT(detail::ExprValue<A>, detail::exprSize<A>, Dist, 3, 2 * sizeof(detail::ExprValue<A>));
+    using Acc = detail::SquareAccumulator<detail::ExprValue<A>>;
+    return static_cast<double>(detail::squaredDistKernel<Acc, detail::ExprTraits<A>::size>(a, b));
+}
+
+/**
+ * @brief euclidean distance between 2 vectors or expressions, without temporary
+ *
+ * @param a
+ * @param b
+ * @return double
+ */
+template <typename A, typename B, typename = std::enable_if_t<detail::areCompatible<A, B>>>
+constexpr double dist(const A& a, const B& b) {
+    return detail::sqrt(VectorND::squaredDist(a, b));
+}
+
+//* ------------------ comparison and printing of expressions ------------------ *//
+
+/**
+ * @brief equality between an expression and a vector or another expression
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::areCompatible<L, R> && (detail::isNode<L> || detail::isNode<R>)>>
+constexpr bool operator==(const L& lhs, const R& rhs) {
+    return detail::equalKernel<detail::ExprValue<L>, detail::ExprTraits<L>::size>(lhs, rhs);
+}
+
+/**
+ * @brief inequality between an expression and a vector or another expression
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<detail::areCompatible<L, R> && (detail::isNode<L> || detail::isNode<R>)>>
+constexpr bool operator!=(const L& lhs, const R& rhs) {
+    return !(lhs == rhs);
+}
+
+/**
+ * @brief overload cout to print an expression (evaluates it)
+ */
+template <typename E, typename T, size_t N>
+std::ostream& operator<<(std::ostream& os, const VectorExpr<E, T, N>& expr) {
+    return os << expr.eval();
+}
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename E, typename T, size_t N>
+template <typename O>
+constexpr T VectorExpr<E, T, N>::dot(const O& other) const {
+    return VectorND::dot(self(), other);
+}
+
+template <typename E, typename T, size_t N>
+constexpr double VectorExpr<E, T, N>::squaredNorm() const {
+    return VectorND::squaredNorm(self());
+}
+
+template <typename E, typename T, size_t N>
+constexpr double VectorExpr<E, T, N>::norm() const {
+    return VectorND::norm(self());
+}
+
+template <typename E, typename T, size_t N>
+template <typename O>
+constexpr double VectorExpr<E, T, N>::squaredDist(const O& other) const {
+    return VectorND::squaredDist(self(), other);
+}
+
+template <typename E, typename T, size_t N>
+template <typename O>
+constexpr double VectorExpr<E, T, N>::dist(const O& other) const {
+    return VectorND::dist(self(), other);
+}
+
+template <typename E, typename T, size_t N>
+template <typename O>
+constexpr double VectorExpr<E, T, N>::distanceTo(const O& other) const {
+    return VectorND::dist(self(), other);
+}
+
+template <typename E, typename T, size_t N>
+constexpr Vector<T, N> VectorExpr<E, T, N>::mod(const Vector<T, N>& other) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 3 * sizeof(T));
+    Vector<T, N> result;
+    detail::modKernel<T, N>(result.begin(), self(), other);
+    return result;
+}
+
+template <typename E, typename T, size_t N>
+template <typename O>
+constexpr Vector<T, N> VectorExpr<E, T, N>::mod(const VectorExpr<O, T, N>& other) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 3 * sizeof(T));
+    Vector<T, N> result;
+    detail::modKernel<T, N>(result.begin(), self(), other.self());
+    return result;
+}
+
+template <typename E, typename T, size_t N>
+constexpr Vector<T, N> VectorExpr<E, T, N>::mod(T scalar) const {
+    VECTORND_PROFILE_COUNT(T, N, Mod, 2, 2 * sizeof(T));
+    Vector<T, N> result;
+    detail::modKernel<T, N>(result.begin(), self(), ScalarExpr<T, N>(scalar));
+    return result;
+}
+
+template <typename E, typename T, size_t N>
+constexpr Vector<T, N> VectorExpr<E, T, N>::reverse() const {
+    Vector<T, N> result;
+    for (size_t i = 0; i < N; i++) {
+        result[N - i - 1] = self()[i];
+    }
+    return result;
+}
+
+}
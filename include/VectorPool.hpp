@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm> // std::max
+#include <cstddef>
+#include <memory> // std::unique_ptr
+#include <new> // std::align_val_t
+#include <vector>
+
+#include "Vector.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief arena of Vector<T, N> for short-lived buffers: an allocation moves a pointer in a
+ * block, every allocation is freed at once by reset(). The blocks are kept and reused, so
+ * a pool reset every step stops allocating after the first one.
+ *
+ * Every buffer is aligned on Alignment bytes. A pool is not thread safe: use one per
+ * thread. V is Vector<T, N> by default, any trivially destructible vector type works
+ * (AlignedVector...).
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ * @tparam Alignment of the buffers in bytes (64: a cache line)
+ * @tparam V the vector type
+ */
+template <typename T, size_t N, size_t Alignment = 64, typename V = Vector<T, N>>
+class VectorPool
+{
+    static_assert(std::is_trivially_destructible_v<V>, "reset() does not call the destructors");
+    static_assert((Alignment & (Alignment - 1)) == 0 && Alignment >= alignof(V), "invalid alignment");
+private:
+    struct Deleter {
+        void operator()(std::byte* p) const noexcept { ::operator delete(p, std::align_val_t{Alignment}); }
+    };
+    struct Block {
+        std::unique_ptr<std::byte, Deleter> memory;
+        size_t bytes;
+    };
+
+    std::vector<Block> blocks;
+    // block of the next allocation, and its first free byte
+    size_t current{0};
+    size_t offset{0};
+    size_t blockBytes;
+    size_t usedBytes{0};
+public:
+    using value_type = V;
+
+    /**
+     * @brief a pool allocating blocks of blockSize vectors (or more for a larger buffer),
+     * nothing is allocated before the first buffer
+     *
+     * @param blockSize
+     */
+    explicit VectorPool(size_t blockSize = 4096);
+
+    /**
+     * @brief uninitialized memory, aligned on Alignment bytes
+     *
+     * @param bytes
+     * @return void* valid until reset()
+     */
+    void* allocateBytes(size_t bytes);
+
+    /**
+     * @brief count null vectors
+     *
+     * @param count
+     * @return V* valid until reset()
+     */
+    V* allocate(size_t count);
+
+    /**
+     * @brief count copies of a vector
+     *
+     * @param count
+     * @param value
+     * @return V* valid until reset()
+     */
+    V* allocate(size_t count, const V& value);
+
+    /// free every buffer at once (the memory is kept for the next allocations)
+    void reset() noexcept;
+
+    /// free every buffer and give the memory back
+    void release() noexcept;
+
+    /// bytes handed out since the last reset (with the alignment padding)
+    inline size_t used() const noexcept { return usedBytes + offset; }
+
+    /// bytes held by the pool
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief std allocator drawing from a pool (deallocate does nothing), for the
+     * containers of a step: std::vector<V, VectorPool<T, N>::Allocator<V>>
+     */
+    template <typename U>
+    class Allocator
+    {
+    private:
+        VectorPool* pool;
+
+        template <typename>
+        friend class Allocator;
+    public:
+        using value_type = U;
+
+        explicit Allocator(VectorPool& pool) noexcept: pool{&pool} {}
+
+        template <typename W>
+        Allocator(const Allocator<W>& other) noexcept: pool{other.pool} {}
+
+        U* allocate(size_t n) { return static_cast<U*>(pool->allocateBytes(n * sizeof(U))); }
+        void deallocate(U*, size_t) noexcept {}
+
+        template <typename W>
+        bool operator==(const Allocator<W>& other) const noexcept { return pool == other.pool; }
+
+        template <typename W>
+        bool operator!=(const Allocator<W>& other) const noexcept { return pool != other.pool; }
+    };
+
+    /// an allocator of the pool
+    inline Allocator<V> allocator() noexcept { return Allocator<V>(*this); }
+};
+
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N, size_t Alignment, typename V>
+VectorPool<T, N, Alignment, V>::VectorPool(size_t blockSize)
+    : blockBytes{(std::max<size_t>(1, blockSize) * sizeof(V) + Alignment - 1) / Alignment * Alignment} {}
+
+// bump allocation: the next block that can hold the buffer, a new one at the end if none
+
+template <typename T, size_t N, size_t Alignment, typename V>
+void* VectorPool<T, N, Alignment, V>::allocateBytes(size_t bytes) {
+    bytes = (std::max<size_t>(1, bytes) + Alignment - 1) / Alignment * Alignment;
+    while (current < blocks.size() && offset + bytes > blocks[current].bytes) {
+        usedBytes += offset;
+        current++;
+        offset = 0;
+    }
+    if (current == blocks.size()) {
+        const size_t size = std::max(blockBytes, bytes);
+        blocks.push_back({std::unique_ptr<std::byte, Deleter>(
+                              static_cast<std::byte*>(::operator new(size, std::align_val_t{Alignment}))),
+                          size});
+    }
+    std::byte* p = blocks[current].memory.get() + offset;
+    offset += bytes;
+    return p;
+}
+
+template <typename T, size_t N, size_t Alignment, typename V>
+V* VectorPool<T, N, Alignment, V>::allocate(size_t count) {
+    V* vectors = static_cast<V*>(allocateBytes(count * sizeof(V)));
+    for (size_t i = 0; i < count; i++) {
+        new (vectors + i) V();
+    }
+    return vectors;
+}
+
+template <typename T, size_t N, size_t Alignment, typename V>
+V* VectorPool<T, N, Alignment, V>::allocate(size_t count, const V& value) {
+    V* vectors = static_cast<V*>(allocateBytes(count * sizeof(V)));
+    for (size_t i = 0; i < count; i++) {
+        new (vectors + i) V(value);
+    }
+    return vectors;
+}
+
+template <typename T, size_t N, size_t Alignment, typename V>
+void VectorPool<T, N, Alignment, V>::reset() noexcept {
+    current = 0;
+    offset = 0;
+    usedBytes = 0;
+}
+
+template <typename T, size_t N, size_t Alignment, typename V>
+void VectorPool<T, N, Alignment, V>::release() noexcept {
+    blocks.clear();
+    reset();
+}
+
+template <typename T, size_t N, size_t Alignment, typename V>
+size_t VectorPool<T, N, Alignment, V>::capacity() const noexcept {
+    size_t bytes = 0;
+    for (const auto& block : blocks) {
+        bytes += block.bytes;
+    }
+    return bytes;
+}
+
+}
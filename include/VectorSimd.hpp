@@ -0,0 +1,490 @@
+#pragma once
+
+#include <cmath> // std::sqrt, std::fmod
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define VECTORND_SIMD 1
+#else
+#define VECTORND_SIMD 0
+#endif
+
+namespace VectorND {
+namespace simd {
+
+/**
+ * @brief true modulo of a by b, in [0, b) (or (b, 0] for a negative b): fmod(a, b), plus b
+ * when it has the sign opposite to b. Unlike fmod(fmod(a, b) + b, b), exact for a positive a.
+ */
+template <typename T>
+inline T mod(T a, T b) {
+    auto r = std::fmod(a, b);
+    if (r != 0 && (r < 0) != (b < 0)) {
+        r += b;
+        // the rounding of r + b can give b
+        if (r == b) {
+            r = 0;
+        }
+    }
+    return static_cast<T>(r);
+}
+
+/**
+ * @brief packet backends: thin wrappers over SSE / AVX / AVX-512 registers.
+ *
+ * Every backend exposes the same static interface so the expression templates and
+ * the kernels can be written once:
+ *  - type, value_type, width
+ *  - load / store (unaligned)
+ *  - loadFirst (other lanes 0) / storeFirst / keepFirst (other lanes 0): the first n < width
+ *    lanes, without touching the memory past them
+ *  - set1, zero, add, sub, mul, div, neg, max, sqrt, hsum, allEqual
+ *  - fmadd(a, b, c) = a * b + c, a single rounding when the cpu has FMA
+ *  - rsqrt, the hardware estimate of 1 / sqrt (only if hasRsqrt, see fastInvSqrt)
+ *  - mod, the true modulo of Vector::mod, simd::mod of each lane (only if hasMod, it needs floor
+ *    and FMA instructions)
+ */
+#if VECTORND_SIMD
+
+/// lane masks of the partial operations: n lanes set from lanesMask32 + 16 - n
+alignas(64) inline constexpr int32_t lanesMask32[32] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1};
+alignas(64) inline constexpr int64_t lanesMask64[16] = {-1, -1, -1, -1, -1, -1, -1, -1};
+
+/*
+ * The packet mod(a, b, n) computes q = floor(a / b) and r = a - q * b with one rounding (FMA):
+ * r is exact when q is the true floor, and when the rounding of a / b gives floor + 1, r + b is
+ * the result of mod. The lanes where |a / b| >= 2^mantissa (q * b is not exact, or a / b is not
+ * finite) are computed by modLanes; only the first n lanes are checked.
+ */
+template <typename P>
+inline typename P::type modLanes(typename P::type r, typename P::type a, typename P::type b, unsigned lanes) {
+    using T = typename P::value_type;
+    alignas(64) T ra[P::width];
+    alignas(64) T aa[P::width];
+    alignas(64) T ba[P::width];
+    P::store(ra, r);
+    P::store(aa, a);
+    P::store(ba, b);
+    for (size_t i = 0; i < P::width; i++) {
+        if ((lanes >> i) & 1) {
+            ra[i] = mod(aa[i], ba[i]);
+        }
+    }
+    return P::load(ra);
+}
+
+struct SseFloat {
+    using type = __m128;
+    using value_type = float;
+    static constexpr size_t width = 4;
+#if defined(__SSE4_1__) && defined(__FMA__)
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm_div_ps(a, b);
+        type r = _mm_fnmadd_ps(_mm_floor_ps(x), b, a);
+        // the rounding of a / b can leave r on the wrong side of 0, or equal to b
+        r = _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(_mm_mul_ps(r, b), _mm_setzero_ps()), b));
+        r = _mm_andnot_ps(_mm_cmpeq_ps(r, b), r);
+        const __m128 large = _mm_cmpnlt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), x), _mm_set1_ps(0x1p24f));
+        const unsigned lanes = static_cast<unsigned>(_mm_movemask_ps(large)) & ((1u << n) - 1);
+        return lanes == 0 ? r : modLanes<SseFloat>(r, a, b, lanes);
+    }
+#else
+    static constexpr bool hasMod = false;
+#endif
+    static inline type load(const float* p) { return _mm_loadu_ps(p); }
+    static inline void store(float* p, type x) { _mm_storeu_ps(p, x); }
+    static inline type mask(size_t n) { return _mm_loadu_ps(reinterpret_cast<const float*>(lanesMask32 + 16 - n)); }
+    // movss / movq rather than vmaskmovps (AVX): a masked load is not forwarded from the
+    // stores just before it, and Vector<float, 3> is often loaded right after being written.
+    // movq (not movsd on a double*): its pointer may alias the floats
+    static inline type loadFirst(const float* p, size_t n) {
+        const type low = n == 1 ? _mm_load_ss(p) : _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+        return n == 3 ? _mm_movelh_ps(low, _mm_load_ss(p + 2)) : low;
+    }
+    static inline void storeFirst(float* p, type x, size_t n) {
+        if (n == 1) {
+            _mm_store_ss(p, x);
+            return;
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(x));
+        if (n == 3) {
+            _mm_store_ss(p + 2, _mm_movehl_ps(x, x));
+        }
+    }
+    static inline type keepFirst(type x, size_t n) { return _mm_and_ps(x, mask(n)); }
+    static inline type set1(float x) { return _mm_set1_ps(x); }
+    static inline type zero() { return _mm_setzero_ps(); }
+    static inline type add(type a, type b) { return _mm_add_ps(a, b); }
+    static inline type sub(type a, type b) { return _mm_sub_ps(a, b); }
+    static inline type mul(type a, type b) { return _mm_mul_ps(a, b); }
+#if defined(__FMA__)
+    static inline type fmadd(type a, type b, type c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static inline type fmadd(type a, type b, type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+    static inline type div(type a, type b) { return _mm_div_ps(a, b); }
+    static inline type max(type a, type b) { return _mm_max_ps(a, b); }
+    static inline type sqrt(type a) { return _mm_sqrt_ps(a); }
+    static constexpr bool hasRsqrt = true;
+    static inline type rsqrt(type a) { return _mm_rsqrt_ps(a); }
+    static inline type neg(type a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+    static inline bool allEqual(type a, type b) { return _mm_movemask_ps(_mm_cmpeq_ps(a, b)) == 0xF; }
+    static inline float hsum(type a) {
+        __m128 shuf = _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 sums = _mm_add_ps(a, shuf);
+        shuf = _mm_movehl_ps(shuf, sums);
+        return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+    }
+};
+
+struct SseDouble {
+    using type = __m128d;
+    using value_type = double;
+    static constexpr size_t width = 2;
+#if defined(__SSE4_1__) && defined(__FMA__)
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm_div_pd(a, b);
+        type r = _mm_fnmadd_pd(_mm_floor_pd(x), b, a);
+        r = _mm_add_pd(r, _mm_and_pd(_mm_cmplt_pd(_mm_mul_pd(r, b), _mm_setzero_pd()), b));
+        r = _mm_andnot_pd(_mm_cmpeq_pd(r, b), r);
+        const __m128d large = _mm_cmpnlt_pd(_mm_andnot_pd(_mm_set1_pd(-0.0), x), _mm_set1_pd(0x1p53));
+        const unsigned lanes = static_cast<unsigned>(_mm_movemask_pd(large)) & ((1u << n) - 1);
+        return lanes == 0 ? r : modLanes<SseDouble>(r, a, b, lanes);
+    }
+#else
+    static constexpr bool hasMod = false;
+#endif
+    static inline type load(const double* p) { return _mm_loadu_pd(p); }
+    static inline void store(double* p, type x) { _mm_storeu_pd(p, x); }
+    // n is 1
+    static inline type loadFirst(const double* p, size_t) { return _mm_load_sd(p); }
+    static inline void storeFirst(double* p, type x, size_t) { _mm_store_sd(p, x); }
+    static inline type keepFirst(type x, size_t) { return _mm_move_sd(_mm_setzero_pd(), x); }
+    static inline type set1(double x) { return _mm_set1_pd(x); }
+    static inline type zero() { return _mm_setzero_pd(); }
+    static inline type add(type a, type b) { return _mm_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm_mul_pd(a, b); }
+#if defined(__FMA__)
+    static inline type fmadd(type a, type b, type c) { return _mm_fmadd_pd(a, b, c); }
+#else
+    static inline type fmadd(type a, type b, type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+#endif
+    static inline type div(type a, type b) { return _mm_div_pd(a, b); }
+    static inline type max(type a, type b) { return _mm_max_pd(a, b); }
+    static inline type sqrt(type a) { return _mm_sqrt_pd(a); }
+    static constexpr bool hasRsqrt = false;
+    static inline type neg(type a) { return _mm_xor_pd(a, _mm_set1_pd(-0.0)); }
+    static inline bool allEqual(type a, type b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)) == 0x3; }
+    static inline double hsum(type a) {
+        return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+    }
+};
+
+#if defined(__AVX__)
+struct AvxFloat {
+    using type = __m256;
+    using value_type = float;
+    static constexpr size_t width = 8;
+#if defined(__FMA__)
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm256_div_ps(a, b);
+        type r = _mm256_fnmadd_ps(_mm256_floor_ps(x), b, a);
+        r = _mm256_add_ps(r, _mm256_and_ps(_mm256_cmp_ps(_mm256_mul_ps(r, b), _mm256_setzero_ps(), _CMP_LT_OQ), b));
+        r = _mm256_andnot_ps(_mm256_cmp_ps(r, b, _CMP_EQ_OQ), r);
+        const __m256 large = _mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), x), _mm256_set1_ps(0x1p24f), _CMP_NLT_UQ);
+        const unsigned lanes = static_cast<unsigned>(_mm256_movemask_ps(large)) & ((1u << n) - 1);
+        return lanes == 0 ? r : modLanes<AvxFloat>(r, a, b, lanes);
+    }
+#else
+    static constexpr bool hasMod = false;
+#endif
+    static inline type load(const float* p) { return _mm256_loadu_ps(p); }
+    static inline void store(float* p, type x) { _mm256_storeu_ps(p, x); }
+    static inline __m256i mask(size_t n) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanesMask32 + 16 - n)); }
+    static inline type loadFirst(const float* p, size_t n) { return _mm256_maskload_ps(p, mask(n)); }
+    static inline void storeFirst(float* p, type x, size_t n) { _mm256_maskstore_ps(p, mask(n), x); }
+    static inline type keepFirst(type x, size_t n) { return _mm256_and_ps(x, _mm256_castsi256_ps(mask(n))); }
+    static inline type set1(float x) { return _mm256_set1_ps(x); }
+    static inline type zero() { return _mm256_setzero_ps(); }
+    static inline type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static inline type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+    static inline type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+#if defined(__FMA__)
+    static inline type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+    static inline type fmadd(type a, type b, type c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+#endif
+    static inline type div(type a, type b) { return _mm256_div_ps(a, b); }
+    static inline type max(type a, type b) { return _mm256_max_ps(a, b); }
+    static inline type sqrt(type a) { return _mm256_sqrt_ps(a); }
+    static constexpr bool hasRsqrt = true;
+    static inline type rsqrt(type a) { return _mm256_rsqrt_ps(a); }
+    static inline type neg(type a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+    static inline bool allEqual(type a, type b) { return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)) == 0xFF; }
+    static inline float hsum(type a) {
+        return SseFloat::hsum(_mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1)));
+    }
+};
+
+struct AvxDouble {
+    using type = __m256d;
+    using value_type = double;
+    static constexpr size_t width = 4;
+#if defined(__FMA__)
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm256_div_pd(a, b);
+        type r = _mm256_fnmadd_pd(_mm256_floor_pd(x), b, a);
+        r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(_mm256_mul_pd(r, b), _mm256_setzero_pd(), _CMP_LT_OQ), b));
+        r = _mm256_andnot_pd(_mm256_cmp_pd(r, b, _CMP_EQ_OQ), r);
+        const __m256d large = _mm256_cmp_pd(_mm256_andnot_pd(_mm256_set1_pd(-0.0), x), _mm256_set1_pd(0x1p53), _CMP_NLT_UQ);
+        const unsigned lanes = static_cast<unsigned>(_mm256_movemask_pd(large)) & ((1u << n) - 1);
+        return lanes == 0 ? r : modLanes<AvxDouble>(r, a, b, lanes);
+    }
+#else
+    static constexpr bool hasMod = false;
+#endif
+    static inline type load(const double* p) { return _mm256_loadu_pd(p); }
+    static inline void store(double* p, type x) { _mm256_storeu_pd(p, x); }
+    static inline __m256i mask(size_t n) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanesMask64 + 8 - n)); }
+    static inline type loadFirst(const double* p, size_t n) { return _mm256_maskload_pd(p, mask(n)); }
+    static inline void storeFirst(double* p, type x, size_t n) { _mm256_maskstore_pd(p, mask(n), x); }
+    static inline type keepFirst(type x, size_t n) { return _mm256_and_pd(x, _mm256_castsi256_pd(mask(n))); }
+    static inline type set1(double x) { return _mm256_set1_pd(x); }
+    static inline type zero() { return _mm256_setzero_pd(); }
+    static inline type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+#if defined(__FMA__)
+    static inline type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static inline type fmadd(type a, type b, type c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+    static inline type div(type a, type b) { return _mm256_div_pd(a, b); }
+    static inline type max(type a, type b) { return _mm256_max_pd(a, b); }
+    static inline type sqrt(type a) { return _mm256_sqrt_pd(a); }
+    static constexpr bool hasRsqrt = false;
+    static inline type neg(type a) { return _mm256_xor_pd(a, _mm256_set1_pd(-0.0)); }
+    static inline bool allEqual(type a, type b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)) == 0xF; }
+    static inline double hsum(type a) {
+        return SseDouble::hsum(_mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1)));
+    }
+};
+#endif // __AVX__
+
+#if defined(__AVX512F__)
+// some AVX-512 intrinsics are used in their masked form (all lanes): the plain ones pass an
+// undefined source to the builtins and trip -Wmaybe-uninitialized in the gcc 12 headers
+struct Avx512Float {
+    using type = __m512;
+    using value_type = float;
+    static constexpr size_t width = 16;
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm512_div_ps(a, b);
+        const type q = _mm512_mask_roundscale_ps(x, 0xFFFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        type r = _mm512_fnmadd_ps(q, b, a);
+        r = _mm512_mask_add_ps(r, _mm512_cmp_ps_mask(_mm512_mul_ps(r, b), _mm512_setzero_ps(), _CMP_LT_OQ), r, b);
+        r = _mm512_maskz_mov_ps(_mm512_cmp_ps_mask(r, b, _CMP_NEQ_UQ), r);
+        const type absX = _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(x), _mm512_set1_epi32(INT32_MAX)));
+        const unsigned lanes = _mm512_cmp_ps_mask(absX, _mm512_set1_ps(0x1p24f), _CMP_NLT_UQ) & mask(n);
+        return lanes == 0 ? r : modLanes<Avx512Float>(r, a, b, lanes);
+    }
+    static inline type load(const float* p) { return _mm512_loadu_ps(p); }
+    static inline void store(float* p, type x) { _mm512_storeu_ps(p, x); }
+    static inline __mmask16 mask(size_t n) { return static_cast<__mmask16>((1u << n) - 1); }
+    static inline type loadFirst(const float* p, size_t n) { return _mm512_maskz_loadu_ps(mask(n), p); }
+    static inline void storeFirst(float* p, type x, size_t n) { _mm512_mask_storeu_ps(p, mask(n), x); }
+    static inline type keepFirst(type x, size_t n) { return _mm512_maskz_mov_ps(mask(n), x); }
+    static inline type set1(float x) { return _mm512_set1_ps(x); }
+    static inline type zero() { return _mm512_setzero_ps(); }
+    static inline type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static inline type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+    static inline type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+    static inline type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline type div(type a, type b) { return _mm512_div_ps(a, b); }
+    static inline type max(type a, type b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+    static inline type sqrt(type a) { return _mm512_mask_sqrt_ps(a, 0xFFFF, a); }
+    static constexpr bool hasRsqrt = true;
+    static inline type rsqrt(type a) { return _mm512_mask_rsqrt14_ps(a, 0xFFFF, a); }
+    static inline type neg(type a) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_set1_epi32(INT32_MIN))); }
+    static inline bool allEqual(type a, type b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ) == 0xFFFF; }
+    static inline float hsum(type a) {
+        const __m256d low = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, _mm512_castps_pd(a), 0);
+        const __m256d high = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, _mm512_castps_pd(a), 1);
+        return AvxFloat::hsum(_mm256_add_ps(_mm256_castpd_ps(low), _mm256_castpd_ps(high)));
+    }
+};
+
+struct Avx512Double {
+    using type = __m512d;
+    using value_type = double;
+    static constexpr size_t width = 8;
+    static constexpr bool hasMod = true;
+    static inline type mod(type a, type b, size_t n = width) {
+        const type x = _mm512_div_pd(a, b);
+        const type q = _mm512_mask_roundscale_pd(x, 0xFF, x, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+        type r = _mm512_fnmadd_pd(q, b, a);
+        r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(_mm512_mul_pd(r, b), _mm512_setzero_pd(), _CMP_LT_OQ), r, b);
+        r = _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(r, b, _CMP_NEQ_UQ), r);
+        const type absX = _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(x), _mm512_set1_epi64(INT64_MAX)));
+        const unsigned lanes = _mm512_cmp_pd_mask(absX, _mm512_set1_pd(0x1p53), _CMP_NLT_UQ) & mask(n);
+        return lanes == 0 ? r : modLanes<Avx512Double>(r, a, b, lanes);
+    }
+    static inline type load(const double* p) { return _mm512_loadu_pd(p); }
+    static inline void store(double* p, type x) { _mm512_storeu_pd(p, x); }
+    static inline __mmask8 mask(size_t n) { return static_cast<__mmask8>((1u << n) - 1); }
+    static inline type loadFirst(const double* p, size_t n) { return _mm512_maskz_loadu_pd(mask(n), p); }
+    static inline void storeFirst(double* p, type x, size_t n) { _mm512_mask_storeu_pd(p, mask(n), x); }
+    static inline type keepFirst(type x, size_t n) { return _mm512_maskz_mov_pd(mask(n), x); }
+    static inline type set1(double x) { return _mm512_set1_pd(x); }
+    static inline type zero() { return _mm512_setzero_pd(); }
+    static inline type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static inline type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+    static inline type div(type a, type b) { return _mm512_div_pd(a, b); }
+    static inline type max(type a, type b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+    static inline type sqrt(type a) { return _mm512_mask_sqrt_pd(a, 0xFF, a); }
+    static constexpr bool hasRsqrt = true;
+    static inline type rsqrt(type a) { return _mm512_mask_rsqrt14_pd(a, 0xFF, a); }
+    static inline type neg(type a) { return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_set1_epi64(INT64_MIN))); }
+    static inline bool allEqual(type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ) == 0xFF; }
+    static inline double hsum(type a) {
+        const __m256d low = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, a, 0);
+        const __m256d high = _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xF, a, 1);
+        return AvxDouble::hsum(_mm256_add_pd(low, high));
+    }
+};
+#endif // __AVX512F__
+
+#endif // VECTORND_SIMD
+
+/**
+ * @brief the packet backend used for Vector<T, N>, void if T has no SIMD backend.
+ *
+ * The widest register that is not wider than N is used, or the narrowest one if N
+ * is smaller than every register (Vector<float, 3> is processed as 4 lanes).
+ */
+template <typename T, size_t N, typename = void>
+struct PacketSelector {
+    using type = void;
+};
+
+#if VECTORND_SIMD
+#if defined(__AVX512F__)
+template <size_t N>
+using FloatPacket = std::conditional_t<(N >= 16), Avx512Float, std::conditional_t<(N >= 8), AvxFloat, SseFloat>>;
+template <size_t N>
+using DoublePacket = std::conditional_t<(N >= 8), Avx512Double, std::conditional_t<(N >= 4), AvxDouble, SseDouble>>;
+#elif defined(__AVX__)
+template <size_t N>
+using FloatPacket = std::conditional_t<(N >= 8), AvxFloat, SseFloat>;
+template <size_t N>
+using DoublePacket = std::conditional_t<(N >= 4), AvxDouble, SseDouble>;
+#else
+template <size_t N>
+using FloatPacket = SseFloat;
+template <size_t N>
+using DoublePacket = SseDouble;
+#endif
+
+template <size_t N>
+struct PacketSelector<float, N> {
+    using type = FloatPacket<N>;
+};
+
+template <size_t N>
+struct PacketSelector<double, N> {
+    using type = DoublePacket<N>;
+};
+#endif // VECTORND_SIMD
+
+/// load the first n < width lanes, the other lanes are set to 0
+template <typename P>
+inline typename P::type loadPartial(const typename P::value_type* p, size_t n) {
+    return P::loadFirst(p, n);
+}
+
+/// store the first n < width lanes
+template <typename P>
+inline void storePartial(typename P::value_type* p, typename P::type x, size_t n) {
+    P::storeFirst(p, x, n);
+}
+
+/// keep the first n < width lanes, set the other lanes to 0
+template <typename P>
+inline typename P::type keepFirst(typename P::type x, size_t n) {
+    return P::keepFirst(x, n);
+}
+
+template <typename T, size_t N>
+using PacketFor = typename PacketSelector<T, N>::type;
+
+/**
+ * @brief approximate 1 / sqrt(x) of each lane: the hardware estimate (relative error below
+ * 1.5 * 2^-12, 2^-14 with AVX-512) refined by one Newton-Raphson step
+ * y * (1.5 - 0.5 * x * y * y). The relative error is then below 5e-7 (about 4 float ulps)
+ * for a positive normal x (0 gives nan, the callers test it).
+ */
+template <typename P>
+inline typename P::type fastInvSqrt(typename P::type x) {
+    static_assert(P::hasRsqrt, "the packet has no rsqrt estimate");
+    const auto y = P::rsqrt(x);
+    const auto halfXYY = P::mul(P::mul(P::set1(0.5), x), P::mul(y, y));
+    return P::mul(y, P::sub(P::set1(1.5), halfXYY));
+}
+
+/// fastInvSqrt of a float (1 / std::sqrt without SIMD)
+inline float fastInvSqrt(float x) {
+#if VECTORND_SIMD
+    return _mm_cvtss_f32(fastInvSqrt<SseFloat>(_mm_set_ss(x)));
+#else
+    return 1 / std::sqrt(x);
+#endif
+}
+
+/// true if Vector<T, N> uses the SIMD kernels
+template <typename T, size_t N>
+constexpr bool hasPacket = !std::is_void_v<PacketFor<T, N>>;
+
+/**
+ * @brief type in which the elements of type T are computed: T, or float for the 16 bits
+ * floating-point types of Float16.hpp (their packets load and store T, compute in float)
+ */
+template <typename T>
+struct ComputeTypeOf {
+    using type = T;
+};
+
+template <typename T>
+using ComputeType = typename ComputeTypeOf<T>::type;
+
+/// backend with the memory operations on ComputeType (P itself, or the float backend of a 16 bits packet)
+template <typename P, typename = void>
+struct ComputePacketOf {
+    using type = P;
+};
+
+template <typename P>
+struct ComputePacketOf<P, std::void_t<typename P::ComputePacket>> {
+    using type = typename P::ComputePacket;
+};
+
+template <typename P>
+using ComputePacket = typename ComputePacketOf<P>::type;
+
+/// the widest packet available for T, used by the kernels working on long arrays
+template <typename T>
+using WidestPacket = PacketFor<T, 64>;
+
+} // namespace simd
+} // namespace VectorND
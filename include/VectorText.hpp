@@ -0,0 +1,438 @@
+#pragma once
+
+#include <algorithm> // std::max, std::min, std::copy
+#include <charconv> // std::to_chars, std::from_chars
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error> // std::errc
+#include <type_traits>
+#include <vector>
+
+#include "Vector.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+/**
+ * @brief text format of a vector: "[1, 2.5, 3]" by default.
+ *
+ * When parsing, whitespace is allowed around every token, and the delimiters are matched
+ * without their spaces: a separator made only of spaces means "at least one space".
+ */
+struct TextFormat {
+    std::string_view open = "[";
+    std::string_view separator = ", ";
+    std::string_view close = "]";
+    /// significant digits of the floating-point elements, -1 for the shortest text that
+    /// reads back to the same value
+    int precision = -1;
+
+    /// comma separated values, one vector per line: "1,2.5,3"
+    static constexpr TextFormat csv() { return {"", ",", "", -1}; }
+
+    /// space separated values, one vector per line: "1 2.5 3"
+    static constexpr TextFormat whitespace() { return {"", " ", "", -1}; }
+};
+
+/**
+ * @brief maximum number of characters written by formatTo for a Vector<T, N>
+ *
+ * @param format
+ * @return size_t
+ */
+template <typename T, size_t N>
+constexpr size_t maxFormattedSize(const TextFormat& format = {});
+
+/**
+ * @brief write a vector as text with std::to_chars (no locale, no allocation)
+ *
+ * @param first
+ * @param last end of the buffer
+ * @param vector
+ * @param format
+ * @return std::to_chars_result past the text, or ec == std::errc::value_too_large (and
+ * ptr == last) if the buffer is too small
+ */
+template <typename T, size_t N>
+std::to_chars_result formatTo(char* first, char* last, const Vector<T, N>& vector, const TextFormat& format = {});
+
+/**
+ * @brief write a vector as text into a buffer of at least maxFormattedSize<T, N>(format) chars
+ *
+ * @param out
+ * @param vector
+ * @param format
+ * @return char* past the text
+ */
+template <typename T, size_t N>
+char* formatTo(char* out, const Vector<T, N>& vector, const TextFormat& format = {}) {
+    return formatTo(out, out + maxFormattedSize<T, N>(format), vector, format).ptr;
+}
+
+/// the vector as text
+template <typename T, size_t N>
+std::string toString(const Vector<T, N>& vector, const TextFormat& format = {});
+
+/**
+ * @brief read a vector with std::from_chars, the text may continue after it
+ *
+ * @param first
+ * @param last
+ * @param vector the result (unspecified on error)
+ * @param format
+ * @return std::from_chars_result past the vector, or ec == std::errc::invalid_argument
+ * (ptr at the error) or std::errc::result_out_of_range
+ */
+template <typename T, size_t N>
+std::from_chars_result parse(const char* first, const char* last, Vector<T, N>& vector, const TextFormat& format = {});
+
+/**
+ * @brief read a vector, the text must hold nothing else (but spaces)
+ *
+ * @param text
+ * @param format
+ * @return Vector<T, N>, std::invalid_argument if the text is not a vector
+ */
+template <typename T, size_t N>
+Vector<T, N> parse(std::string_view text, const TextFormat& format = {});
+
+/**
+ * @brief read one vector per line, in parallel: the text is split into chunks on line
+ * boundaries, each chunk is parsed by a thread. Empty lines and lines starting with '#'
+ * are skipped.
+ *
+ * @param text
+ * @param format of a line, TextFormat::csv() by default
+ * @param headerLines number of lines skipped at the start
+ * @return std::vector<Vector<T, N>> in the order of the lines, std::invalid_argument
+ * (with the line number) for a line that is not a vector
+ */
+template <typename T, size_t N>
+std::vector<Vector<T, N>> parseVectors(std::string_view text, const TextFormat& format = TextFormat::csv(),
+                                       size_t headerLines = 0);
+
+/**
+ * @brief parseVectors of a file
+ *
+ * @param path
+ * @param format of a line, TextFormat::csv() by default
+ * @param headerLines number of lines skipped at the start
+ * @return std::vector<Vector<T, N>>, std::runtime_error if the file cannot be read
+ */
+template <typename T, size_t N>
+std::vector<Vector<T, N>> readVectors(const std::string& path, const TextFormat& format = TextFormat::csv(),
+                                      size_t headerLines = 0);
+
+/**
+ * @brief one vector per line as text, formatted in parallel
+ *
+ * @param vectors
+ * @param count
+ * @param format of a line, TextFormat::csv() by default
+ * @return std::string
+ */
+template <typename T, size_t N>
+std::string formatVectors(const Vector<T, N>* vectors, size_t count, const TextFormat& format = TextFormat::csv());
+
+/**
+ * @brief write formatVectors to a file (replaced if it exists)
+ *
+ * @param path
+ * @param vectors
+ * @param count
+ * @param format of a line, TextFormat::csv() by default
+ */
+template <typename T, size_t N>
+void writeVectors(const std::string& path, const Vector<T, N>* vectors, size_t count,
+                  const TextFormat& format = TextFormat::csv());
+
+template <typename T, size_t N>
+void writeVectors(const std::string& path, const std::vector<Vector<T, N>>& vectors,
+                  const TextFormat& format = TextFormat::csv()) {
+    writeVectors(path, vectors.data(), vectors.size(), format);
+}
+
+
+//* ------------------ Implementation ------------------ *//
+
+namespace detail {
+
+// upper bound of the characters of one element
+template <typename T>
+constexpr size_t maxElementChars(int precision) {
+    if constexpr (std::is_floating_point_v<T>) {
+        // sign, digits, point, exponent ("e-4951" for a long double)
+        const size_t digits = static_cast<size_t>(std::max(precision, std::numeric_limits<T>::max_digits10));
+        return digits + 9;
+    } else {
+        // digits10 + 1 digits and a sign
+        return static_cast<size_t>(std::numeric_limits<T>::digits10) + 2;
+    }
+}
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// spaces and tabs of a line (not the end of line)
+inline const char* skipBlanks(const char* first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\t' || *first == '\r')) {
+        first++;
+    }
+    return first;
+}
+
+inline std::string_view trimSpaces(std::string_view s) {
+    while (!s.empty() && isSpace(s.front())) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && isSpace(s.back())) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// match a delimiter without its spaces, after blanks
+inline const char* matchToken(const char* first, const char* last, std::string_view token) {
+    first = skipBlanks(first, last);
+    if (static_cast<size_t>(last - first) < token.size() || std::string_view(first, token.size()) != token) {
+        return nullptr;
+    }
+    return first + token.size();
+}
+
+template <typename T>
+inline std::to_chars_result formatElement(char* first, char* last, T value, int precision) {
+    if constexpr (std::is_floating_point_v<T>) {
+        if (precision >= 0) {
+            return std::to_chars(first, last, value, std::chars_format::general, precision);
+        }
+    }
+    return std::to_chars(first, last, value);
+}
+
+inline std::to_chars_result appendText(char* first, char* last, std::string_view text) {
+    if (static_cast<size_t>(last - first) < text.size()) {
+        return {last, std::errc::value_too_large};
+    }
+    return {std::copy(text.begin(), text.end(), first), std::errc{}};
+}
+
+// the lines of a chunk of text, parsed into out. On error: the index of the bad line
+// in the chunk (from 0) and false
+template <typename T, size_t N>
+bool parseLines(const char* first, const char* last, const TextFormat& format, std::vector<Vector<T, N>>& out,
+                size_t& badLine) {
+    size_t line = 0;
+    while (first != last) {
+        const char* end = std::find(first, last, '\n');
+        const char* content = skipBlanks(first, end);
+        if (content != end && *content != '#') {
+            Vector<T, N> vector;
+            const auto result = parse(content, end, vector, format);
+            if (result.ec != std::errc{} || skipBlanks(result.ptr, end) != end) {
+                badLine = line;
+                return false;
+            }
+            out.push_back(vector);
+        }
+        first = end == last ? last : end + 1;
+        line++;
+    }
+    return true;
+}
+
+} // namespace detail
+
+template <typename T, size_t N>
+constexpr size_t maxFormattedSize(const TextFormat& format) {
+    return format.open.size() + format.close.size() + (N > 0 ? (N - 1) * format.separator.size() : 0) +
+           N * detail::maxElementChars<T>(format.precision);
+}
+
+template <typename T, size_t N>
+std::to_chars_result formatTo(char* first, char* last, const Vector<T, N>& vector, const TextFormat& format) {
+    auto result = detail::appendText(first, last, format.open);
+    for (size_t i = 0; i < N && result.ec == std::errc{}; i++) {
+        if (i > 0) {
+            result = detail::appendText(result.ptr, last, format.separator);
+            if (result.ec != std::errc{}) {
+                break;
+            }
+        }
+        result = detail::formatElement(result.ptr, last, vector[i], format.precision);
+    }
+    if (result.ec == std::errc{}) {
+        result = detail::appendText(result.ptr, last, format.close);
+    }
+    return result;
+}
+
+template <typename T, size_t N>
+std::string toString(const Vector<T, N>& vector, const TextFormat& format) {
+    std::string text(maxFormattedSize<T, N>(format), '\0');
+    text.resize(static_cast<size_t>(formatTo(&text[0], vector, format) - &text[0]));
+    return text;
+}
+
+template <typename T, size_t N>
+std::from_chars_result parse(const char* first, const char* last, Vector<T, N>& vector, const TextFormat& format) {
+    const std::string_view open = detail::trimSpaces(format.open);
+    const std::string_view separator = detail::trimSpaces(format.separator);
+    const std::string_view close = detail::trimSpaces(format.close);
+    // leading spaces
+    while (first != last && detail::isSpace(*first)) {
+        first++;
+    }
+    const char* p = detail::matchToken(first, last, open);
+    if (p == nullptr) {
+        return {first, std::errc::invalid_argument};
+    }
+    for (size_t i = 0; i < N; i++) {
+        if (i > 0) {
+            const char* next = detail::matchToken(p, last, separator);
+            // a separator of spaces: the blanks skipped by matchToken
+            if (next == nullptr || (separator.empty() && next == p)) {
+                return {p, std::errc::invalid_argument};
+            }
+            p = next;
+        }
+        p = detail::skipBlanks(p, last);
+        // from_chars does not take the + of a positive value
+        if (p != last && *p == '+') {
+            p++;
+        }
+        const auto result = std::from_chars(p, last, vector[i]);
+        if (result.ec != std::errc{}) {
+            return result;
+        }
+        p = result.ptr;
+    }
+    const char* end = detail::matchToken(p, last, close);
+    if (end == nullptr) {
+        return {p, std::errc::invalid_argument};
+    }
+    return {end, std::errc{}};
+}
+
+template <typename T, size_t N>
+Vector<T, N> parse(std::string_view text, const TextFormat& format) {
+    Vector<T, N> vector;
+    const char* last = text.data() + text.size();
+    const auto result = parse(text.data(), last, vector, format);
+    const char* rest = result.ptr;
+    while (rest != last && detail::isSpace(*rest)) {
+        rest++;
+    }
+    if (result.ec != std::errc{} || rest != last) {
+        throw std::invalid_argument("VectorND: not a vector of " + std::to_string(N) + " elements: \"" +
+                                    std::string(text) + "\"");
+    }
+    return vector;
+}
+
+template <typename T, size_t N>
+std::vector<Vector<T, N>> parseVectors(std::string_view text, const TextFormat& format, size_t headerLines) {
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    for (size_t line = 0; line < headerLines && first != last; line++) {
+        const char* end = std::find(first, last, '\n');
+        first = end == last ? last : end + 1;
+    }
+
+    // chunks of at least minChunk bytes, a few per thread, cut after a '\n'
+    constexpr size_t minChunk = 1 << 16;
+    const size_t bytes = static_cast<size_t>(last - first);
+    const size_t chunks = std::max<size_t>(1, std::min(4 * parallel::threadCount(), bytes / minChunk));
+    std::vector<const char*> bounds(chunks + 1, last);
+    bounds[0] = first;
+    for (size_t k = 1; k < chunks; k++) {
+        const char* cut = std::max(bounds[k - 1], first + k * (bytes / chunks));
+        const char* end = std::find(cut, last, '\n');
+        bounds[k] = end == last ? last : end + 1;
+    }
+
+    std::vector<std::vector<Vector<T, N>>> parts(chunks);
+    std::vector<size_t> badLines(chunks, 0);
+    std::vector<char> failed(chunks, 0);
+    VECTORND_OMP(parallel for schedule(dynamic))
+    for (size_t k = 0; k < chunks; k++) {
+        failed[k] = !detail::parseLines(bounds[k], bounds[k + 1], format, parts[k], badLines[k]);
+    }
+
+    size_t total = 0;
+    for (size_t k = 0; k < chunks; k++) {
+        if (failed[k]) {
+            // line number in the text (from 1), the count before the chunk includes the header
+            const size_t line = static_cast<size_t>(std::count(text.data(), bounds[k], '\n')) + badLines[k] + 1;
+            throw std::invalid_argument("VectorND: line " + std::to_string(line) + " is not a vector of " +
+                                        std::to_string(N) + " elements");
+        }
+        total += parts[k].size();
+    }
+    std::vector<Vector<T, N>> vectors;
+    vectors.reserve(total);
+    for (const auto& part : parts) {
+        vectors.insert(vectors.end(), part.begin(), part.end());
+    }
+    return vectors;
+}
+
+template <typename T, size_t N>
+std::vector<Vector<T, N>> readVectors(const std::string& path, const TextFormat& format, size_t headerLines) {
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+        throw std::runtime_error("VectorND: " + path + ": cannot be opened");
+    }
+    std::string text(static_cast<size_t>(stream.tellg()), '\0');
+    stream.seekg(0);
+    if (!stream.read(&text[0], static_cast<std::streamsize>(text.size()))) {
+        throw std::runtime_error("VectorND: " + path + ": read failed");
+    }
+    return parseVectors<T, N>(text, format, headerLines);
+}
+
+template <typename T, size_t N>
+std::string formatVectors(const Vector<T, N>* vectors, size_t count, const TextFormat& format) {
+    // each block is formatted into its own string, then they are joined
+    constexpr size_t block = 4096;
+    const size_t blocks = (count + block - 1) / block;
+    const size_t lineSize = maxFormattedSize<T, N>(format) + 1;
+    std::vector<std::string> parts(blocks);
+    VECTORND_OMP(parallel for schedule(dynamic))
+    for (size_t b = 0; b < blocks; b++) {
+        const size_t n = std::min(block, count - b * block);
+        std::string& part = parts[b];
+        part.resize(n * lineSize);
+        char* out = &part[0];
+        for (size_t i = b * block; i < b * block + n; i++) {
+            out = formatTo(out, vectors[i], format);
+            *out++ = '\n';
+        }
+        part.resize(static_cast<size_t>(out - &part[0]));
+    }
+    size_t total = 0;
+    for (const auto& part : parts) {
+        total += part.size();
+    }
+    std::string text;
+    text.reserve(total);
+    for (const auto& part : parts) {
+        text += part;
+    }
+    return text;
+}
+
+template <typename T, size_t N>
+void writeVectors(const std::string& path, const Vector<T, N>* vectors, size_t count, const TextFormat& format) {
+    const std::string text = formatVectors(vectors, count, format);
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream.write(text.data(), static_cast<std::streamsize>(text.size())) || !stream.flush()) {
+        throw std::runtime_error("VectorND: " + path + ": write failed");
+    }
+}
+
+}
@@ -0,0 +1,395 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "Vector.hpp"
+
+namespace VectorND {
+
+namespace detail {
+
+/// print the N elements of a view as [a, b, ...] (like Vector)
+template <typename V>
+std::ostream& printElements(std::ostream& os, const V& view) {
+    constexpr size_t N = ExprTraits<V>::size;
+    os << "[";
+    for (size_t i = 0; i < N; i++) {
+        os << view[i];
+        if (i < N - 1) {
+            os << ", ";
+        }
+    }
+    os << "]";
+    return os;
+}
+
+[[noreturn]] inline void viewIndexError(size_t i, size_t n) {
+    throw std::out_of_range("VectorND: index " + std::to_string(i) + " out of a view of size " + std::to_string(n));
+}
+
+} // namespace detail
+
+/**
+ * @brief read-only Vector<T, N> over N contiguous elements it does not own (a row of an
+ * external buffer, an mmap'd file, a struct field...)
+ *
+ * A view is an operand of the expressions like a Vector: v + view, view.dot(w),
+ * squaredDist(view, w)... read the elements in place, on SIMD packets, without copying
+ * them. Only the results (Vector, scalars) are new values. The memory must outlive the view.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class VectorView : public VectorExpr<VectorView<T, N>, T, N>
+{
+protected:
+    const T* ptr;
+public:
+    // aliases
+    using const_iterator = const T*;
+
+    constexpr explicit VectorView(const T* data) noexcept: ptr{data} {}
+
+    constexpr VectorView(const Vector<T, N>& vector) noexcept: ptr{vector.cbegin()} {}
+    // a view of a temporary would dangle
+    VectorView(const Vector<T, N>&&) = delete;
+
+    constexpr const T* data() const noexcept { return ptr; }
+    constexpr const_iterator begin() const noexcept { return ptr; }
+    constexpr const_iterator cbegin() const noexcept { return ptr; }
+    constexpr const_iterator end() const noexcept { return ptr + N; }
+    constexpr const_iterator cend() const noexcept { return ptr + N; }
+
+    /**
+     * @brief element access operator (read)
+     *
+     * @param i the index of the element
+     */
+    constexpr T operator[](size_t i) const { return ptr[i]; }
+
+    /**
+     * @brief element access (read) with bounds checking
+     *
+     * @param i the index of the element
+     * @throw std::out_of_range if i >= N
+     */
+    T at(size_t i) const;
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        return n == P::width ? P::load(ptr + i) : simd::loadPartial<P>(ptr + i, n);
+    }
+
+    /**
+     * @brief overload cout to print the viewed elements as [a, b, ...]
+     */
+    friend std::ostream& operator<<(std::ostream& os, const VectorView& view) {
+        return detail::printElements(os, view);
+    }
+};
+
+/**
+ * @brief read-only Vector<T, N> over N elements stride elements apart (a column of a
+ * row-major matrix, one component of interleaved records...). The packets are gathered
+ * lane by lane. A negative stride walks the memory backwards.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class StridedVectorView : public VectorExpr<StridedVectorView<T, N>, T, N>
+{
+protected:
+    const T* ptr;
+    ptrdiff_t step;
+public:
+    /**
+     * @brief view of data[0], data[stride], ..., data[(N - 1) * stride]
+     *
+     * @param data
+     * @param stride distance between 2 elements, in elements
+     */
+    constexpr StridedVectorView(const T* data, ptrdiff_t stride) noexcept: ptr{data}, step{stride} {}
+
+    constexpr const T* data() const noexcept { return ptr; }
+    constexpr ptrdiff_t stride() const noexcept { return step; }
+
+    /**
+     * @brief element access operator (read)
+     *
+     * @param i the index of the element
+     */
+    constexpr T operator[](size_t i) const { return ptr[static_cast<ptrdiff_t>(i) * step]; }
+
+    /**
+     * @brief element access (read) with bounds checking
+     *
+     * @param i the index of the element
+     * @throw std::out_of_range if i >= N
+     */
+    T at(size_t i) const;
+
+    template <typename P>
+    inline typename P::type packet(size_t i, size_t n) const {
+        alignas(64) T lanes[P::width]{};
+        for (size_t k = 0; k < n; k++) {
+            lanes[k] = (*this)[i + k];
+        }
+        return P::load(lanes);
+    }
+
+    /**
+     * @brief overload cout to print the viewed elements as [a, b, ...]
+     */
+    friend std::ostream& operator<<(std::ostream& os, const StridedVectorView& view) {
+        return detail::printElements(os, view);
+    }
+};
+
+namespace detail {
+
+/// element by element writes of a VectorRef or StridedVectorRef (R, CRTP): compound
+/// assignments with a Vector, a view, an expression or a scalar, each in a single loop
+template <typename R, typename T, size_t N>
+class ViewAssignment
+{
+private:
+    constexpr R& self() noexcept { return static_cast<R&>(*this); }
+public:
+    template <typename E>
+    constexpr R& operator+=(const VectorExpr<E, T, N>& expr) { return self().assign(self() + expr.self()); }
+    constexpr R& operator+=(const Vector<T, N>& vector) { return self().assign(self() + vector); }
+
+    template <typename E>
+    constexpr R& operator-=(const VectorExpr<E, T, N>& expr) { return self().assign(self() - expr.self()); }
+    constexpr R& operator-=(const Vector<T, N>& vector) { return self().assign(self() - vector); }
+
+    template <typename E>
+    constexpr R& operator*=(const VectorExpr<E, T, N>& expr) { return self().assign(self() * expr.self()); }
+    constexpr R& operator*=(const Vector<T, N>& vector) { return self().assign(self() * vector); }
+    constexpr R& operator*=(T scalar) { return self().assign(self() * scalar); }
+
+    template <typename E>
+    constexpr R& operator/=(const VectorExpr<E, T, N>& expr) { return self().assign(self() / expr.self()); }
+    constexpr R& operator/=(const Vector<T, N>& vector) { return self().assign(self() / vector); }
+    constexpr R& operator/=(T scalar) { return self().assign(self() / scalar); }
+
+    /**
+     * @brief this += alpha * x in a single pass (BLAS axpy)
+     *
+     * @param alpha
+     * @param x a vector, a view or an expression
+     * @return R&
+     */
+    template <typename X, typename = std::enable_if_t<areCompatible<R, X>>>
+    constexpr R& axpy(T alpha, const X& x) { return self().assign(VectorND::fma(x, alpha, self())); }
+
+    /**
+     * @brief scale the viewed elements to a norm of 1 (a null vector is left unchanged), for
+     * floating-point elements only
+     *
+     * @return R&
+     */
+    constexpr R& normalize() {
+        static_assert(!std::is_integral_v<T>, "normalize needs floating-point elements");
+        const auto squared = VectorND::squaredNorm<simd::ComputeType<T>>(self());
+        if (squared > 0) {
+            *this *= static_cast<T>(1 / detail::sqrt(squared));
+        }
+        return self();
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief writable Vector<T, N> over N contiguous elements it does not own.
+ *
+ * It reads like a VectorView, and writes through: ref = expression, ref += v, ref[i] = x...
+ * evaluate in a single loop straight into the external memory. Copying a VectorRef copies
+ * the reference, assigning one VectorRef to another copies the elements.
+ * The destination may be an operand of the assigned expression element by element
+ * (ref = ref * 2 + w), but must not overlap an operand at another offset.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class VectorRef : public VectorView<T, N>, public detail::ViewAssignment<VectorRef<T, N>, T, N>
+{
+private:
+    friend class detail::ViewAssignment<VectorRef<T, N>, T, N>;
+
+    template <typename E>
+    constexpr VectorRef& assign(const E& expr) {
+        detail::evaluate<T, N>(data(), expr);
+        return *this;
+    }
+public:
+    // aliases
+    using iterator = T*;
+
+    constexpr explicit VectorRef(T* data) noexcept: VectorView<T, N>(data) {}
+
+    constexpr VectorRef(Vector<T, N>& vector) noexcept: VectorView<T, N>(vector.begin()) {}
+
+    constexpr VectorRef(const VectorRef&) = default;
+
+    /// write the elements of other (not a rebinding)
+    constexpr VectorRef& operator=(const VectorRef& other) { return assign(other); }
+    constexpr VectorRef& operator=(const Vector<T, N>& vector) { return assign(vector); }
+
+    /**
+     * @brief evaluate an expression (or a view) into the referenced elements, in a single loop
+     *
+     * @param expr
+     * @return VectorRef&
+     */
+    template <typename E>
+    constexpr VectorRef& operator=(const VectorExpr<E, T, N>& expr) { return assign(expr.self()); }
+
+    // the elements stay writable through a const reference (like a pointer to non-const)
+    constexpr T* data() const noexcept { return const_cast<T*>(this->ptr); }
+    constexpr iterator begin() const noexcept { return data(); }
+    constexpr iterator end() const noexcept { return data() + N; }
+
+    /**
+     * @brief element access operator (write)
+     *
+     * @param i the index of the element
+     */
+    constexpr T& operator[](size_t i) const { return data()[i]; }
+};
+
+/**
+ * @brief writable Vector<T, N> over N elements stride elements apart (see VectorRef and
+ * StridedVectorView): the packets of the assigned expressions are scattered lane by lane.
+ *
+ * @tparam T the type of the elements
+ * @tparam N the number of elements
+ */
+template <typename T, size_t N>
+class StridedVectorRef : public StridedVectorView<T, N>,
+                         public detail::ViewAssignment<StridedVectorRef<T, N>, T, N>
+{
+private:
+    friend class detail::ViewAssignment<StridedVectorRef<T, N>, T, N>;
+
+    template <typename E>
+    constexpr StridedVectorRef& assign(const E& expr);
+public:
+    /**
+     * @brief reference to data[0], data[stride], ..., data[(N - 1) * stride]
+     *
+     * @param data
+     * @param stride distance between 2 elements, in elements
+     */
+    constexpr StridedVectorRef(T* data, ptrdiff_t stride) noexcept: StridedVectorView<T, N>(data, stride) {}
+
+    constexpr StridedVectorRef(const StridedVectorRef&) = default;
+
+    /// write the elements of other (not a rebinding)
+    constexpr StridedVectorRef& operator=(const StridedVectorRef& other) { return assign(other); }
+    constexpr StridedVectorRef& operator=(const Vector<T, N>& vector) { return assign(vector); }
+
+    /**
+     * @brief evaluate an expression (or a view) into the referenced elements, in a single loop
+     *
+     * @param expr
+     * @return StridedVectorRef&
+     */
+    template <typename E>
+    constexpr StridedVectorRef& operator=(const VectorExpr<E, T, N>& expr) { return assign(expr.self()); }
+
+    // the elements stay writable through a const reference (like a pointer to non-const)
+    constexpr T* data() const noexcept { return const_cast<T*>(this->ptr); }
+
+    /**
+     * @brief element access operator (write)
+     *
+     * @param i the index of the element
+     */
+    constexpr T& operator[](size_t i) const { return data()[static_cast<ptrdiff_t>(i) * this->step]; }
+};
+
+namespace detail {
+
+// views are operands of the expressions: stored by value (a pointer), read with packet()
+template <typename T, size_t N>
+struct ExprTraits<VectorView<T, N>> {
+    static constexpr bool isExpr = true;
+    static constexpr bool isVector = false;
+    using value_type = T;
+    static constexpr size_t size = N;
+};
+
+template <typename T, size_t N>
+struct ExprTraits<StridedVectorView<T, N>> : ExprTraits<VectorView<T, N>> {};
+
+template <typename T, size_t N>
+struct ExprTraits<VectorRef<T, N>> : ExprTraits<VectorView<T, N>> {};
+
+template <typename T, size_t N>
+struct ExprTraits<StridedVectorRef<T, N>> : ExprTraits<VectorView<T, N>> {};
+
+/// evaluate an expression into dst[0], dst[stride], ... on packets scattered lane by lane
+template <typename T, size_t N, typename E>
+inline void evaluateStridedPackets(T* dst, ptrdiff_t stride, const E& e) {
+    using P = simd::PacketFor<T, N>;
+    alignas(64) T lanes[P::width];
+    for (size_t i = 0; i < N; i += P::width) {
+        const size_t n = std::min(P::width, N - i);
+        P::store(lanes, packetOf<P>(e, i, n));
+        for (size_t k = 0; k < n; k++) {
+            dst[static_cast<ptrdiff_t>(i + k) * stride] = lanes[k];
+        }
+    }
+}
+
+/// evaluate an expression into dst[0], dst[stride], ..., dst[(N - 1) * stride]
+template <typename T, size_t N, typename E>
+constexpr void evaluateStrided(T* dst, ptrdiff_t stride, const E& e) {
+    if constexpr (simd::hasPacket<T, N>) {
+        if (!isConstantEvaluated()) {
+            evaluateStridedPackets<T, N>(dst, stride, e);
+            return;
+        }
+    }
+    for (size_t i = 0; i < N; i++) {
+        dst[static_cast<ptrdiff_t>(i) * stride] = e[i];
+    }
+}
+
+} // namespace detail
+
+//* ------------------ Implementation ------------------ *//
+
+template <typename T, size_t N>
+T VectorView<T, N>::at(size_t i) const {
+    if (i >= N) {
+        detail::viewIndexError(i, N);
+    }
+    return ptr[i];
+}
+
+template <typename T, size_t N>
+T StridedVectorView<T, N>::at(size_t i) const {
+    if (i >= N) {
+        detail::viewIndexError(i, N);
+    }
+    return (*this)[i];
+}
+
+template <typename T, size_t N>
+template <typename E>
+constexpr StridedVectorRef<T, N>& StridedVectorRef<T, N>::assign(const E& expr) {
+    detail::evaluateStrided<T, N>(data(), this->step, expr);
+    return *this;
+}
+
+}
@@ -0,0 +1,248 @@
+#include "Dispatch.hpp"
+
+#include <algorithm> // std::min
+#include <atomic>
+#include <cmath>   // std::sqrt
+#include <cstdlib> // std::getenv
+#include <cstring> // std::strcmp
+
+#include "DispatchKernels.hpp"
+#include "Parallel.hpp"
+
+namespace VectorND {
+
+namespace dispatch {
+
+namespace {
+
+/// vectors per parallel block of the batch kernels
+constexpr size_t vectorBlock = 1024;
+/// elements per parallel block of scale
+constexpr size_t elementBlock = 16384;
+/// queries per parallel block of the distance matrix
+constexpr size_t queryBlock = 16;
+
+Isa cpuIsa() noexcept {
+#if defined(VECTORND_DISPATCH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl") &&
+        __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Isa::Avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return Isa::Avx2;
+    }
+#endif
+    return Isa::Sse2;
+}
+
+/// the level requested by VECTORND_ISA, the detected one if it is not set or not known
+Isa requestedIsa(Isa detected) noexcept {
+    const char* name = std::getenv("VECTORND_ISA");
+    if (name == nullptr) {
+        return detected;
+    }
+    for (Isa isa : {Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+        if (std::strcmp(name, isaName(isa)) == 0) {
+            return isa;
+        }
+    }
+    return detected;
+}
+
+const detail::KernelTable& kernelsFor(Isa isa) noexcept {
+    switch (isa) {
+#if defined(VECTORND_DISPATCH_X86)
+    case Isa::Avx512:
+        return detail::avx512Kernels;
+    case Isa::Avx2:
+        return detail::avx2Kernels;
+#endif
+    default:
+        return detail::sse2Kernels;
+    }
+}
+
+Isa clamp(Isa isa) noexcept {
+    return std::min(isa, detectedIsa());
+}
+
+struct State {
+    std::atomic<Isa> isa;
+    std::atomic<const detail::KernelTable*> kernels;
+
+    State() noexcept : isa(clamp(requestedIsa(detectedIsa()))), kernels(&kernelsFor(isa.load())) {}
+};
+
+/// chosen on the first call, thread safe
+State& state() noexcept {
+    static State instance;
+    return instance;
+}
+
+template <typename T>
+const detail::SpanKernels<T>& kernels() noexcept {
+    const detail::KernelTable& table = *state().kernels.load(std::memory_order_relaxed);
+    if constexpr (std::is_same_v<T, float>) {
+        return table.f32;
+    } else {
+        return table.f64;
+    }
+}
+
+template <typename T>
+void dotBatch(const T* a, const T* b, size_t dimension, size_t count, T* out) {
+    const auto kernel = kernels<T>().dot;
+    const size_t blocks = (count + vectorBlock - 1) / vectorBlock;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * vectorBlock;
+        const size_t offset = begin * dimension;
+        kernel(a + offset, b + offset, dimension, std::min(vectorBlock, count - begin), out + begin);
+    }
+}
+
+template <typename T>
+void squaredDistBatch(const T* a, const T* b, size_t dimension, size_t count, T* out) {
+    const auto kernel = kernels<T>().squaredDist;
+    const size_t blocks = (count + vectorBlock - 1) / vectorBlock;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * vectorBlock;
+        const size_t offset = begin * dimension;
+        kernel(a + offset, b + offset, dimension, std::min(vectorBlock, count - begin), out + begin);
+    }
+}
+
+template <typename T>
+void squaredNormBatch(const T* a, size_t dimension, size_t count, T* out) {
+    const auto kernel = kernels<T>().squaredNorm;
+    const size_t blocks = (count + vectorBlock - 1) / vectorBlock;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * vectorBlock;
+        kernel(a + begin * dimension, dimension, std::min(vectorBlock, count - begin), out + begin);
+    }
+}
+
+template <typename T>
+void normBatch(const T* a, size_t dimension, size_t count, T* out) {
+    squaredNormBatch(a, dimension, count, out);
+    for (size_t v = 0; v < count; v++) {
+        out[v] = std::sqrt(out[v]);
+    }
+}
+
+template <typename T>
+void scaleBatch(const T* a, T scalar, T* out, size_t n) {
+    const auto kernel = kernels<T>().scale;
+    const size_t blocks = (n + elementBlock - 1) / elementBlock;
+    VECTORND_OMP(parallel for schedule(static))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * elementBlock;
+        kernel(a + begin, scalar, out + begin, std::min(elementBlock, n - begin));
+    }
+}
+
+template <typename T>
+void pairwiseBatch(const T* queries, size_t m, const T* database, size_t k, size_t dimension, T* out) {
+    if (m == 0 || k == 0) {
+        return;
+    }
+    const auto kernel = kernels<T>().pairwiseSquaredDist;
+    const size_t blocks = (m + queryBlock - 1) / queryBlock;
+    VECTORND_OMP(parallel for schedule(dynamic))
+    for (size_t block = 0; block < blocks; block++) {
+        const size_t begin = block * queryBlock;
+        kernel(queries + begin * dimension, std::min(queryBlock, m - begin), database, k, dimension, out + begin * k);
+    }
+}
+
+} // namespace
+
+//* ------------------ instruction set ------------------ *//
+
+Isa detectedIsa() noexcept {
+    static const Isa isa = cpuIsa();
+    return isa;
+}
+
+Isa activeIsa() noexcept {
+    return state().isa.load(std::memory_order_relaxed);
+}
+
+Isa selectIsa(Isa isa) noexcept {
+    State& current = state();
+    isa = clamp(isa);
+    current.kernels.store(&kernelsFor(isa), std::memory_order_relaxed);
+    current.isa.store(isa, std::memory_order_relaxed);
+    return isa;
+}
+
+const char* isaName(Isa isa) noexcept {
+    switch (isa) {
+    case Isa::Avx512:
+        return "avx512";
+    case Isa::Avx2:
+        return "avx2";
+    default:
+        return "sse2";
+    }
+}
+
+//* ------------------ kernels on arrays ------------------ *//
+
+void dot(const float* a, const float* b, size_t dimension, size_t count, float* out) {
+    dotBatch(a, b, dimension, count, out);
+}
+
+void dot(const double* a, const double* b, size_t dimension, size_t count, double* out) {
+    dotBatch(a, b, dimension, count, out);
+}
+
+void squaredDist(const float* a, const float* b, size_t dimension, size_t count, float* out) {
+    squaredDistBatch(a, b, dimension, count, out);
+}
+
+void squaredDist(const double* a, const double* b, size_t dimension, size_t count, double* out) {
+    squaredDistBatch(a, b, dimension, count, out);
+}
+
+void squaredNorm(const float* a, size_t dimension, size_t count, float* out) {
+    squaredNormBatch(a, dimension, count, out);
+}
+
+void squaredNorm(const double* a, size_t dimension, size_t count, double* out) {
+    squaredNormBatch(a, dimension, count, out);
+}
+
+void norm(const float* a, size_t dimension, size_t count, float* out) {
+    normBatch(a, dimension, count, out);
+}
+
+void norm(const double* a, size_t dimension, size_t count, double* out) {
+    normBatch(a, dimension, count, out);
+}
+
+void scale(const float* a, float scalar, float* out, size_t n) {
+    scaleBatch(a, scalar, out, n);
+}
+
+void scale(const double* a, double scalar, double* out, size_t n) {
+    scaleBatch(a, scalar, out, n);
+}
+
+void pairwiseSquaredDist(const float* queries, size_t m, const float* database, size_t k, size_t dimension,
+                         float* out) {
+    pairwiseBatch(queries, m, database, k, dimension, out);
+}
+
+void pairwiseSquaredDist(const double* queries, size_t m, const double* database, size_t k, size_t dimension,
+                         double* out) {
+    pairwiseBatch(queries, m, database, k, dimension, out);
+}
+
+} // namespace dispatch
+
+} // namespace VectorND
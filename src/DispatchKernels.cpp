@@ -0,0 +1,142 @@
+/**
+ * Batch kernels for one instruction set, compiled once per level by src/CMakeLists.txt with
+ * VECTORND_ISA set to sse2, avx2 or avx512 and the matching -m flags.
+ *
+ * The header-only library is included in a namespace renamed after the level (VectorND_avx2, ...):
+ * every copy gets its own symbols, so the linker cannot merge an AVX-512 inline function into
+ * the SSE2 object and run it on a cpu without AVX-512.
+ */
+
+#include <algorithm> // std::min
+#include <type_traits> // std::integral_constant
+
+#include "DispatchKernels.hpp"
+
+#define VECTORND_CONCAT_(a, b) a##b
+#define VECTORND_CONCAT(a, b) VECTORND_CONCAT_(a, b)
+
+#define VectorND VECTORND_CONCAT(VectorND_, VECTORND_ISA)
+#include "VectorArray.hpp"
+#include "VectorView.hpp"
+namespace isa = VectorND;
+#undef VectorND
+
+namespace {
+
+/// bytes of database vectors kept in cache while a block of queries runs over them
+constexpr size_t databaseBlockBytes = 128 * 1024;
+
+/**
+ * @brief f(std::integral_constant<size_t, N>) for the common small dimensions, f(0) otherwise.
+ *
+ * A short vector with a runtime length pays the tail and the merge of all the accumulators on
+ * every vector, more than the products themselves with the wider packets: the fixed sizes go
+ * through VectorView and the compile time kernels.
+ */
+template <typename F>
+void withDimension(size_t dimension, F&& f) {
+    switch (dimension) {
+    case 2:
+        return f(std::integral_constant<size_t, 2>());
+    case 3:
+        return f(std::integral_constant<size_t, 3>());
+    case 4:
+        return f(std::integral_constant<size_t, 4>());
+    case 8:
+        return f(std::integral_constant<size_t, 8>());
+    case 16:
+        return f(std::integral_constant<size_t, 16>());
+    case 32:
+        return f(std::integral_constant<size_t, 32>());
+    case 64:
+        return f(std::integral_constant<size_t, 64>());
+    case 128:
+        return f(std::integral_constant<size_t, 128>());
+    default:
+        return f(std::integral_constant<size_t, 0>());
+    }
+}
+
+template <typename T>
+void dot(const T* a, const T* b, size_t dimension, size_t count, T* out) {
+    withDimension(dimension, [&](auto fixed) {
+        constexpr size_t N = decltype(fixed)::value;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (N == 0) {
+                out[v] = static_cast<T>(isa::detail::spanDot(a + v * dimension, b + v * dimension, dimension));
+            } else {
+                out[v] = isa::VectorView<T, N>(a + v * N).dot(isa::VectorView<T, N>(b + v * N));
+            }
+        }
+    });
+}
+
+template <typename T>
+void squaredDist(const T* a, const T* b, size_t dimension, size_t count, T* out) {
+    withDimension(dimension, [&](auto fixed) {
+        constexpr size_t N = decltype(fixed)::value;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (N == 0) {
+                out[v] = static_cast<T>(
+                    isa::detail::spanSquaredDist(a + v * dimension, b + v * dimension, dimension));
+            } else {
+                out[v] = static_cast<T>(isa::VectorView<T, N>(a + v * N).squaredDist(isa::VectorView<T, N>(b + v * N)));
+            }
+        }
+    });
+}
+
+template <typename T>
+void squaredNorm(const T* a, size_t dimension, size_t count, T* out) {
+    withDimension(dimension, [&](auto fixed) {
+        constexpr size_t N = decltype(fixed)::value;
+        for (size_t v = 0; v < count; v++) {
+            if constexpr (N == 0) {
+                out[v] = static_cast<T>(isa::detail::spanSquaredNorm(a + v * dimension, dimension));
+            } else {
+                out[v] = static_cast<T>(isa::VectorView<T, N>(a + v * N).squaredNorm());
+            }
+        }
+    });
+}
+
+template <typename T>
+void scale(const T* a, T scalar, T* out, size_t n) {
+    isa::detail::spanScalar<isa::detail::Mul>(a, scalar, out, n);
+}
+
+template <typename T>
+void pairwiseSquaredDist(const T* queries, size_t m, const T* database, size_t k, size_t dimension, T* out) {
+    const size_t columnBlock = std::max<size_t>(1, databaseBlockBytes / (sizeof(T) * std::max<size_t>(1, dimension)));
+    for (size_t columnBegin = 0; columnBegin < k; columnBegin += columnBlock) {
+        const size_t columnEnd = std::min(k, columnBegin + columnBlock);
+        for (size_t i = 0; i < m; i++) {
+            const T* query = queries + i * dimension;
+            for (size_t j = columnBegin; j < columnEnd; j++) {
+                out[i * k + j] =
+                    static_cast<T>(isa::detail::spanSquaredDist(query, database + j * dimension, dimension));
+            }
+        }
+    }
+}
+
+template <typename T>
+constexpr VectorND::dispatch::detail::SpanKernels<T> spanKernels() {
+    return {dot<T>, squaredDist<T>, squaredNorm<T>, scale<T>, pairwiseSquaredDist<T>};
+}
+
+} // namespace
+
+namespace VectorND {
+
+namespace dispatch {
+
+namespace detail {
+
+const KernelTable VECTORND_CONCAT(VECTORND_ISA, Kernels) = {spanKernels<float>(), spanKernels<double>()};
+
+} // namespace detail
+
+} // namespace dispatch
+
+} // namespace VectorND
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Table of the batch kernels compiled for one instruction set (see DispatchKernels.cpp).
+ *
+ * This header includes no VectorND header: DispatchKernels.cpp includes it before compiling the
+ * library headers in a namespace of its own.
+ */
+namespace VectorND {
+
+namespace dispatch {
+
+namespace detail {
+
+template <typename T>
+struct SpanKernels {
+    void (*dot)(const T* a, const T* b, size_t dimension, size_t count, T* out);
+    void (*squaredDist)(const T* a, const T* b, size_t dimension, size_t count, T* out);
+    void (*squaredNorm)(const T* a, size_t dimension, size_t count, T* out);
+    void (*scale)(const T* a, T scalar, T* out, size_t n);
+    /// rows [0, m) of the distance matrix, for the queries of one block
+    void (*pairwiseSquaredDist)(const T* queries, size_t m, const T* database, size_t k, size_t dimension, T* out);
+};
+
+struct KernelTable {
+    SpanKernels<float> f32;
+    SpanKernels<double> f64;
+};
+
+extern const KernelTable sse2Kernels;
+#if defined(VECTORND_DISPATCH_X86)
+extern const KernelTable avx2Kernels;
+extern const KernelTable avx512Kernels;
+#endif
+
+} // namespace detail
+
+} // namespace dispatch
+
+} // namespace VectorND
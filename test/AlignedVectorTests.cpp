@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "AlignedVector.hpp"
+#include "AlignedAllocator.hpp"
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T, size_t N>
+Vector<T, N> iota(T start) {
+    Vector<T, N> v;
+    for (size_t i = 0; i < N; i++) {
+        v[i] = start + static_cast<T>(i);
+    }
+    return v;
+}
+
+template <typename T, size_t N, size_t A>
+void checkMatchesVector() {
+    const Vector<T, N> a = iota<T, N>(1);
+    const Vector<T, N> b = iota<T, N>(-3);
+    const AlignedVector<T, N, A> x = a;
+    const AlignedVector<T, N, A> y = b;
+
+    EXPECT_EQ(x.dot(y), a.dot(b));
+    EXPECT_EQ(dot(x, b), a.dot(b));
+    EXPECT_EQ(x.squaredNorm(), a.squaredNorm());
+    EXPECT_TRUE(x + y == a + b);
+    EXPECT_TRUE(x * 2 - y == a * 2 - b);
+
+    AlignedVector<T, N, A> z = x + y;
+    EXPECT_TRUE(z == a + b);
+    z += x;
+    EXPECT_TRUE(z == a + b + a);
+    z = y;
+    EXPECT_TRUE(z == b);
+}
+
+} // namespace
+
+TEST(AlignedVectorTests, layout) {
+    static_assert(alignof(AlignedVector<float, 3, 16>) == 16);
+    static_assert(sizeof(AlignedVector<float, 3, 16>) == 16);
+    static_assert(sizeof(AlignedVector<double, 3, 32>) == 32);
+    static_assert(sizeof(AlignedVector<float, 4, 16>) == 16);
+    static_assert(sizeof(AlignedVector<float, 5, 64>) == 64);
+    static_assert(std::is_base_of_v<Vector<float, 3>, AlignedVector<float, 3>>);
+    // (the copies are counted in profiling builds, see Profile.hpp)
+    static_assert(std::is_trivially_copyable_v<AlignedVector<float, 3, 16>> || profile::enabled);
+    static_assert(simdAlignment<float, 3> >= alignof(float));
+
+    std::vector<AlignedVector<float, 3, 16>, AlignedAllocator<AlignedVector<float, 3, 16>, 16>> vectors(7);
+    for (const auto& v : vectors) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&v) % 16, 0u);
+    }
+}
+
+TEST(AlignedVectorTests, matchesVector) {
+    checkMatchesVector<float, 3, 16>();
+    checkMatchesVector<float, 5, 32>();
+    checkMatchesVector<float, 7, 64>();
+    checkMatchesVector<double, 3, 32>();
+    checkMatchesVector<double, 5, 16>();
+    checkMatchesVector<int, 3, 16>();
+    checkMatchesVector<float, 3, simdAlignment<float, 3>>();
+}
+
+TEST(AlignedVectorTests, paddingIsIgnored) {
+    // garbage in the padding must not leak into the reductions
+    struct alignas(16) Raw {
+        float data[4];
+    } raw{{1, 2, 3, 1e30f}};
+    AlignedVector<float, 3, 16> v;
+    static_assert(sizeof(v) == sizeof(raw));
+    std::memcpy(static_cast<void*>(&v), &raw, sizeof(raw));
+    EXPECT_EQ(v.dot(v), 14.0f);
+    EXPECT_EQ(squaredDist(v, Vector<float, 3>({1, 2, 2})), 1.0);
+    EXPECT_TRUE((v == Vector<float, 3>({1, 2, 3})));
+    EXPECT_TRUE((v * 2 == Vector<float, 3>({2, 4, 6})));
+}
@@ -0,0 +1,137 @@
+#include "Dispatch.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T>
+std::vector<T> randomValues(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<T> dist(-1, 1);
+    std::vector<T> result(count);
+    for (auto& x : result) {
+        x = dist(rng);
+    }
+    return result;
+}
+
+const dispatch::Isa allIsas[] = {dispatch::Isa::Sse2, dispatch::Isa::Avx2, dispatch::Isa::Avx512};
+
+/// restores the level chosen at startup
+struct IsaGuard {
+    dispatch::Isa saved = dispatch::activeIsa();
+    ~IsaGuard() { dispatch::selectIsa(saved); }
+};
+
+}
+
+TEST(DispatchTests, isa) {
+    IsaGuard guard;
+    const auto detected = dispatch::detectedIsa();
+    EXPECT_LE(dispatch::activeIsa(), detected);
+    for (auto isa : allIsas) {
+        // a level the cpu does not support falls back to the detected one
+        const auto selected = dispatch::selectIsa(isa);
+        EXPECT_EQ(selected, std::min(isa, detected));
+        EXPECT_EQ(dispatch::activeIsa(), selected);
+    }
+    EXPECT_EQ(std::string(dispatch::isaName(dispatch::Isa::Sse2)), "sse2");
+    EXPECT_EQ(std::string(dispatch::isaName(dispatch::Isa::Avx2)), "avx2");
+    EXPECT_EQ(std::string(dispatch::isaName(dispatch::Isa::Avx512)), "avx512");
+}
+
+TEST(DispatchTests, batchKernels) {
+    IsaGuard guard;
+    // dimensions with and without tails, more vectors than a parallel block
+    for (size_t dimension : {1, 3, 16, 37}) {
+        const size_t count = 1500;
+        const auto a = randomValues<float>(dimension * count, 1);
+        const auto b = randomValues<float>(dimension * count, 2);
+        for (auto isa : allIsas) {
+            dispatch::selectIsa(isa);
+            std::vector<float> dots(count), distances(count), norms(count);
+            dispatch::dot(a.data(), b.data(), dimension, count, dots.data());
+            dispatch::squaredDist(a.data(), b.data(), dimension, count, distances.data());
+            dispatch::norm(a.data(), dimension, count, norms.data());
+            for (size_t v = 0; v < count; v++) {
+                double dot = 0, distance = 0, norm = 0;
+                for (size_t d = 0; d < dimension; d++) {
+                    const size_t i = v * dimension + d;
+                    dot += double(a[i]) * b[i];
+                    distance += (double(a[i]) - b[i]) * (double(a[i]) - b[i]);
+                    norm += double(a[i]) * a[i];
+                }
+                EXPECT_NEAR(dots[v], dot, 1e-4) << dispatch::isaName(isa);
+                EXPECT_NEAR(distances[v], distance, 1e-4) << dispatch::isaName(isa);
+                EXPECT_NEAR(norms[v], std::sqrt(norm), 1e-4) << dispatch::isaName(isa);
+            }
+        }
+    }
+}
+
+TEST(DispatchTests, scale) {
+    IsaGuard guard;
+    const auto a = randomValues<double>(40000, 3);
+    for (auto isa : allIsas) {
+        dispatch::selectIsa(isa);
+        std::vector<double> out(a.size());
+        dispatch::scale(a.data(), 2.5, out.data(), a.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(out[i], a[i] * 2.5);
+        }
+        // in place
+        out = a;
+        dispatch::scale(out.data(), -1.0, out.data(), out.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(out[i], -a[i]);
+        }
+    }
+}
+
+TEST(DispatchTests, pairwiseSquaredDist) {
+    IsaGuard guard;
+    using V = Vector<double, 5>;
+    std::vector<V> queries(45), database(131);
+    const auto values = randomValues<double>((queries.size() + database.size()) * 5, 4);
+    for (size_t i = 0; i < queries.size() + database.size(); i++) {
+        V& v = i < queries.size() ? queries[i] : database[i - queries.size()];
+        for (size_t d = 0; d < 5; d++) {
+            v[d] = values[i * 5 + d];
+        }
+    }
+    for (auto isa : allIsas) {
+        dispatch::selectIsa(isa);
+        std::vector<double> out(queries.size() * database.size());
+        dispatch::pairwiseSquaredDist(queries.data(), queries.size(), database.data(), database.size(), out.data());
+        for (size_t i = 0; i < queries.size(); i++) {
+            for (size_t j = 0; j < database.size(); j++) {
+                EXPECT_NEAR(out[i * database.size() + j], queries[i].squaredDist(database[j]), 1e-12);
+            }
+        }
+        // a vector is exactly at distance 0 of itself
+        dispatch::pairwiseSquaredDist(queries.data(), queries.size(), queries.data(), queries.size(), out.data());
+        for (size_t i = 0; i < queries.size(); i++) {
+            EXPECT_EQ(out[i * queries.size() + i], 0.0);
+        }
+    }
+}
+
+TEST(DispatchTests, vectorOverloads) {
+    const std::vector<Vector<float, 3>> a = {Vector<float, 3>{{1, 2, 3}}, Vector<float, 3>{{4, 5, 6}}};
+    const std::vector<Vector<float, 3>> b = {Vector<float, 3>{{1, 0, 1}}, Vector<float, 3>{{0, 1, 0}}};
+    std::vector<float> out(2);
+    dispatch::dot(a.data(), b.data(), a.size(), out.data());
+    EXPECT_EQ(out, (std::vector<float>{4, 5}));
+    dispatch::squaredDist(a.data(), b.data(), a.size(), out.data());
+    EXPECT_EQ(out, (std::vector<float>{0 + 4 + 4, 16 + 16 + 36}));
+    dispatch::squaredNorm(a.data(), a.size(), out.data());
+    EXPECT_EQ(out, (std::vector<float>{14, 77}));
+    std::vector<Vector<float, 3>> scaled(2);
+    dispatch::scale(a.data(), 2.0f, scaled.data(), a.size());
+    EXPECT_EQ(scaled[1], (Vector<float, 3>{{8, 10, 12}}));
+}
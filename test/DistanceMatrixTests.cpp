@@ -0,0 +1,55 @@
+#include "DistanceMatrix.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace VectorND;
+using test::randomVectors;
+
+TEST(DistanceMatrixTests, squaredDist) {
+    // sizes that are not multiples of the blocks
+    auto queries = randomVectors<double, 5>(45, 1);
+    auto database = randomVectors<double, 5>(131, 2);
+    std::vector<double> out;
+    pairwiseSquaredDist(queries, database, out);
+    ASSERT_EQ(out.size(), queries.size() * database.size());
+    for (size_t i = 0; i < queries.size(); i++) {
+        for (size_t j = 0; j < database.size(); j++) {
+            EXPECT_NEAR(out[i * database.size() + j], queries[i].squaredDist(database[j]), 1e-12);
+        }
+    }
+    // a vector is at distance 0 of itself (clamped, never negative)
+    pairwiseSquaredDist(queries, queries, out);
+    for (size_t i = 0; i < queries.size(); i++) {
+        EXPECT_GE(out[i * queries.size() + i], 0.0);
+        EXPECT_NEAR(out[i * queries.size() + i], 0.0, 1e-12);
+    }
+}
+
+TEST(DistanceMatrixTests, euclidean) {
+    auto queries = randomVectors<float, 3>(70, 3);
+    auto database = randomVectors<float, 3>(1000, 4);
+    std::vector<float> out;
+    pairwiseDist(queries, database, out);
+    for (size_t i = 0; i < queries.size(); i++) {
+        for (size_t j = 0; j < database.size(); j++) {
+            EXPECT_NEAR(out[i * database.size() + j], queries[i].dist(database[j]), 1e-3);
+        }
+    }
+}
+
+TEST(DistanceMatrixTests, cosine) {
+    auto queries = randomVectors<double, 16>(10, 5);
+    auto database = randomVectors<double, 16>(50, 6);
+    database[7] = Vector<double, 16>();
+    std::vector<double> out;
+    pairwiseCosineDist(queries, database, out);
+    for (size_t i = 0; i < queries.size(); i++) {
+        for (size_t j = 0; j < database.size(); j++) {
+            const double norms = queries[i].norm() * database[j].norm();
+            const double expected = norms > 0 ? 1.0 - queries[i].dot(database[j]) / norms : 1.0;
+            EXPECT_NEAR(out[i * database.size() + j], expected, 1e-12);
+        }
+    }
+}
@@ -0,0 +1,130 @@
+#include "DynVector.hpp"
+#include "Float16.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T>
+DynVector<T> makeVector(size_t n, double offset) {
+    DynVector<T> v(n);
+    for (size_t i = 0; i < n; i++) {
+        v[i] = static_cast<T>(std::sin(0.37 * i + offset) * 4);
+    }
+    return v;
+}
+
+}
+
+TEST(DynVectorTests, storage) {
+    // 16 floats fit inline, larger vectors are aligned on 64 bytes
+    DynVector<float> small(16, 1.5f);
+    EXPECT_EQ(small.size(), 16u);
+    EXPECT_EQ(small.capacity(), DynVector<float>::inlineCapacity);
+    DynVector<float> large(768, 2.0f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large.data()) % 64, 0u);
+    EXPECT_FLOAT_EQ(large[767], 2.0f);
+    EXPECT_THROW(large.at(768), std::out_of_range);
+
+    // a move hands over the heap storage, inline elements are copied
+    const float* storage = large.data();
+    DynVector<float> moved(std::move(large));
+    EXPECT_EQ(moved.data(), storage);
+    EXPECT_TRUE(large.empty());
+    DynVector<float> movedSmall(std::move(small));
+    EXPECT_EQ(movedSmall, DynVector<float>(16, 1.5f));
+
+    // copies are deep, resize keeps the values and appends zeros
+    DynVector<float> copy(moved);
+    copy[0] = -1.0f;
+    EXPECT_FLOAT_EQ(moved[0], 2.0f);
+    movedSmall.resize(20);
+    EXPECT_FLOAT_EQ(movedSmall[15], 1.5f);
+    EXPECT_FLOAT_EQ(movedSmall[19], 0.0f);
+
+    // conversions with Vector
+    const Vector<int, 3> fixed({1, 2, 3});
+    DynVector<int> dynamic(fixed);
+    EXPECT_EQ(dynamic.toVector<3>(), fixed);
+    EXPECT_THROW(dynamic.toVector<4>(), std::invalid_argument);
+    std::ostringstream os;
+    os << dynamic;
+    EXPECT_EQ(os.str(), "[1, 2, 3]");
+}
+
+TEST(DynVectorTests, arithmetic) {
+    for (size_t n : {5, 16, 19, 768}) {
+        const auto a = makeVector<double>(n, 0.0);
+        const auto b = makeVector<double>(n, 1.0);
+        const auto c = makeVector<double>(n, 2.0);
+        const DynVector<double> result = a + b * 2.0 - c / 4.0;
+        const DynVector<double> product = (a * b) / (c + DynVector<double>(n, 10.0));
+        const DynVector<double> negated = -(a - c);
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_DOUBLE_EQ(result[i], a[i] + b[i] * 2.0 - c[i] / 4.0);
+            EXPECT_DOUBLE_EQ(product[i], (a[i] * b[i]) / (c[i] + 10.0));
+            EXPECT_DOUBLE_EQ(negated[i], c[i] - a[i]);
+        }
+        auto d = a;
+        d += b;
+        d -= c;
+        d *= 3.0;
+        EXPECT_EQ(d, (a + b - c) * 3.0);
+    }
+    DynVector<double> a(3), b(4);
+    EXPECT_THROW(a + b, std::invalid_argument);
+    EXPECT_THROW(a += b, std::invalid_argument);
+    EXPECT_THROW(a.dot(b), std::invalid_argument);
+}
+
+TEST(DynVectorTests, rvalueReuse) {
+    const auto a = makeVector<float>(768, 0.0);
+    const auto b = makeVector<float>(768, 1.0);
+    // the result of a + b is the storage of the temporaries
+    auto sum = a + b;
+    const float* storage = sum.data();
+    auto chained = std::move(sum) + a - b;
+    EXPECT_EQ(chained.data(), storage);
+    const auto right = a - (b + a);
+    for (size_t i = 0; i < 768; i++) {
+        EXPECT_EQ(right[i], a[i] - (b[i] + a[i]));
+    }
+    auto scaled = std::move(chained) * 2.0f;
+    EXPECT_EQ(scaled.data(), storage);
+}
+
+TEST(DynVectorTests, sameResultsAsVector) {
+    // the fixed-size and runtime-size kernels are the same
+    const auto a = makeVector<float>(768, 0.0);
+    const auto b = makeVector<float>(768, 0.5);
+    const auto fa = a.toVector<768>();
+    const auto fb = b.toVector<768>();
+    EXPECT_FLOAT_EQ(a.dot(b), fa.dot(fb));
+    EXPECT_DOUBLE_EQ(a.norm(), fa.norm());
+    EXPECT_DOUBLE_EQ(a.squaredNorm(), fa.squaredNorm());
+    EXPECT_NEAR(a.dist(b), fa.dist(fb), 1e-4);
+    EXPECT_NEAR((a.dot<double, summation::Kahan>(b)), (fa.dot<double, summation::Kahan>(fb)), 1e-9);
+    EXPECT_EQ(a.mod(1.5f).toVector<768>(), fa.mod(1.5f));
+    const DynVector<float> m(768, 0.75f);
+    EXPECT_EQ(a.mod(m).toVector<768>(), fa.mod(m.toVector<768>()));
+    EXPECT_NEAR(a.normalized().norm(), 1.0, 1e-6);
+
+    // integers: squares in int64_t, true modulo
+    DynVector<int> i(std::vector<int>{-7, 40000, 3});
+    DynVector<int> j(std::vector<int>{2, -40000, 5});
+    EXPECT_DOUBLE_EQ(i.squaredDist(j), 81.0 + 6400000000.0 + 4.0);
+    EXPECT_EQ(i.dot(j), -14 - 1600000000 + 15);
+    EXPECT_EQ(i.mod(5), DynVector<int>(std::vector<int>{3, 0, 3}));
+    EXPECT_EQ(i.reverse(), DynVector<int>(std::vector<int>{3, 40000, -7}));
+
+    // 16 bits floats are computed in float
+    DynVector<float16_t> h(100, float16_t(0.5f));
+    EXPECT_FLOAT_EQ(static_cast<float>(h.dot(h)), 25.0f);
+    EXPECT_DOUBLE_EQ(h.squaredDist(DynVector<float16_t>(100, float16_t(1.5f))), 100.0);
+}
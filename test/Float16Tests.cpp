@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Float16.hpp"
+#include "TestUtils.hpp"
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+/// half value of the bits, from the definition of binary16
+double halfValue(uint16_t bits) {
+    const int exponent = (bits >> 10) & 0x1F;
+    const int mantissa = bits & 0x3FF;
+    const double sign = (bits & 0x8000) ? -1 : 1;
+    if (exponent == 0x1F) {
+        return mantissa ? std::numeric_limits<double>::quiet_NaN() : sign * std::numeric_limits<double>::infinity();
+    }
+    if (exponent == 0) {
+        return sign * std::ldexp(mantissa, -24);
+    }
+    return sign * std::ldexp(1024 + mantissa, exponent - 25);
+}
+
+template <typename H, size_t N>
+void checkArithmetic() {
+    const auto vectors = randomVectors<float, N>(20, 3, -4.0f, 4.0f);
+    const auto halves = convert<H>(vectors);
+    for (size_t i = 0; i + 1 < halves.size(); i++) {
+        const Vector<H, N>& a = halves[i];
+        const Vector<H, N>& b = halves[i + 1];
+        // the same operations on the float values of the elements
+        const auto fa = convert<float>(std::vector<Vector<H, N>>{a})[0];
+        const auto fb = convert<float>(std::vector<Vector<H, N>>{b})[0];
+        const Vector<H, N> sum = a + b * 2.0f;
+        const Vector<float, N> fsum = fa + fb * 2.0f;
+        for (size_t j = 0; j < N; j++) {
+            EXPECT_EQ(sum[j].bits, H(fsum[j]).bits) << j;
+        }
+        const float dot = a.template dot<float>(b);
+        const float squaredDist = VectorND::squaredDist(a, b);
+        EXPECT_NEAR(dot, fa.dot(fb), 1e-4f * (1 + std::fabs(dot)));
+        EXPECT_NEAR(squaredDist, fa.squaredDist(fb), 1e-4f * (1 + squaredDist));
+        EXPECT_NEAR(a.norm(), fa.norm(), 1e-4f * (1 + fa.norm()));
+        EXPECT_TRUE(a == a);
+        EXPECT_FALSE(a == b);
+    }
+}
+
+template <typename H>
+void checkBatchConversion() {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-100, 100);
+    for (size_t n : {0, 1, 3, 7, 15, 16, 17, 33, 100, 40000}) {
+        std::vector<float> values(n);
+        for (auto& x : values) {
+            x = dist(rng);
+        }
+        std::vector<H> halves(n);
+        std::vector<float> back(n);
+        convert(values.data(), halves.data(), n);
+        convert(halves.data(), back.data(), n);
+        for (size_t i = 0; i < n; i++) {
+            ASSERT_EQ(halves[i].bits, H(values[i]).bits) << n << " " << i;
+            ASSERT_EQ(back[i], float(halves[i])) << n << " " << i;
+        }
+    }
+}
+
+}
+
+TEST(Float16Tests, HalfConversions) {
+    // every half converts to float exactly and back to the same bits
+    for (uint32_t bits = 0; bits <= 0xFFFF; bits++) {
+        const float16_t h = float16_t::fromBits(static_cast<uint16_t>(bits));
+        const float x = h;
+        if (std::isnan(x)) {
+            EXPECT_TRUE(std::isnan(halfValue(h.bits))) << bits;
+            continue;
+        }
+        ASSERT_EQ(static_cast<double>(x), halfValue(h.bits)) << bits;
+        ASSERT_EQ(float16_t(x).bits, bits) << bits;
+    }
+    // rounding to nearest even
+    EXPECT_EQ(float16_t(1.0f + std::ldexp(1.0f, -11)).bits, 0x3C00);     // tie to even (down)
+    EXPECT_EQ(float16_t(1.0f + 3 * std::ldexp(1.0f, -11)).bits, 0x3C02); // tie to even (up)
+    EXPECT_EQ(float16_t(1.0f + std::ldexp(1.0f, -11) + std::ldexp(1.0f, -20)).bits, 0x3C01);
+    EXPECT_EQ(float16_t(2047.0f / 1024 + std::ldexp(1.0f, -11)).bits, 0x4000); // carry into the exponent
+    // subnormals, underflow and overflow
+    EXPECT_EQ(float16_t(std::ldexp(1.0f, -24)).bits, 0x0001);
+    EXPECT_EQ(float16_t(std::ldexp(1.0f, -25)).bits, 0x0000);
+    EXPECT_EQ(float16_t(std::ldexp(1.5f, -25)).bits, 0x0001);
+    EXPECT_EQ(float16_t(3 * std::ldexp(1.0f, -25)).bits, 0x0002);
+    EXPECT_EQ(float16_t(-std::ldexp(1.0f, -30)).bits, 0x8000);
+    EXPECT_EQ(float16_t(65504.0f).bits, 0x7BFF);
+    EXPECT_EQ(float16_t(65519.0f).bits, 0x7BFF);
+    EXPECT_EQ(float16_t(65520.0f).bits, 0x7C00);
+    EXPECT_EQ(float16_t(-1e10f).bits, 0xFC00);
+    EXPECT_EQ(float16_t(std::numeric_limits<float>::infinity()).bits, 0x7C00);
+    EXPECT_TRUE(std::isnan(float(float16_t(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(Float16Tests, Bfloat16Conversions) {
+    for (uint32_t bits = 0; bits <= 0xFFFF; bits++) {
+        const bfloat16_t b = bfloat16_t::fromBits(static_cast<uint16_t>(bits));
+        const float x = b;
+        if (std::isnan(x)) {
+            EXPECT_TRUE(std::isnan(float(bfloat16_t(x))));
+            continue;
+        }
+        ASSERT_EQ(bfloat16_t(x).bits, bits) << bits;
+    }
+    EXPECT_EQ(bfloat16_t(1.0f + std::ldexp(1.0f, -8)).bits, 0x3F80);     // tie to even (down)
+    EXPECT_EQ(bfloat16_t(1.0f + 3 * std::ldexp(1.0f, -8)).bits, 0x3F82); // tie to even (up)
+    EXPECT_EQ(bfloat16_t(1.0f + std::ldexp(1.0f, -8) + std::ldexp(1.0f, -20)).bits, 0x3F81);
+    EXPECT_EQ(bfloat16_t(std::numeric_limits<float>::max()).bits, 0x7F80);
+    EXPECT_TRUE(std::isnan(float(bfloat16_t(std::numeric_limits<float>::quiet_NaN()))));
+    EXPECT_TRUE(std::isnan(float(bfloat16_t(-std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(Float16Tests, VectorArithmetic) {
+    checkArithmetic<float16_t, 3>();
+    checkArithmetic<float16_t, 8>();
+    checkArithmetic<float16_t, 21>();
+    checkArithmetic<float16_t, 64>();
+    checkArithmetic<bfloat16_t, 3>();
+    checkArithmetic<bfloat16_t, 21>();
+    checkArithmetic<bfloat16_t, 64>();
+    static_assert(sizeof(Vector<float16_t, 64>) == 128);
+}
+
+TEST(Float16Tests, BatchConversion) {
+    checkBatchConversion<float16_t>();
+    checkBatchConversion<bfloat16_t>();
+    // nan and inf go through the packets
+    const float special[5] = {std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+                              std::numeric_limits<float>::quiet_NaN(), 65520.0f, -0.0f};
+    bfloat16_t b[5];
+    float16_t h[5];
+    convert(special, b, 5);
+    convert(special, h, 5);
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_EQ(b[i].bits, bfloat16_t(special[i]).bits) << i;
+        EXPECT_EQ(h[i].bits, float16_t(special[i]).bits) << i;
+    }
+}
+
+TEST(Float16Tests, OtherConversions) {
+    // no 16 bits side: converted directly, not through float
+    const double in[2] = {0.1, 1e300};
+    double out[2];
+    convert(in, out, 2);
+    EXPECT_EQ(out[0], 0.1);
+    EXPECT_EQ(out[1], 1e300);
+    const std::vector<Vector<int, 3>> ints{Vector<int, 3>({16777217, -3, 7})};
+    EXPECT_EQ(convert<double>(ints)[0], (Vector<double, 3>({16777217.0, -3.0, 7.0})));
+    // no vector, no access to their data
+    EXPECT_TRUE(convert<float16_t>(std::vector<Vector<float, 4>>{}).empty());
+}
+
+TEST(Float16Tests, Normalize) {
+    // the squared norm 250000 overflows float16_t: it is accumulated in float
+    Vector<float16_t, 2> v({float16_t(300.0f), float16_t(400.0f)});
+    v.normalize();
+    EXPECT_NEAR(float(v[0]), 0.6f, 1e-3f);
+    EXPECT_NEAR(float(v[1]), 0.8f, 1e-3f);
+}
@@ -0,0 +1,157 @@
+#include "IvfIndex.hpp"
+#include "KnnBruteForce.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+// points around `clusters` random centers
+template <size_t N>
+std::vector<Vector<float, N>> clusteredVectors(size_t count, size_t clusters, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> center(-10, 10);
+    std::normal_distribution<float> noise(0, 1);
+    std::vector<Vector<float, N>> centers(clusters);
+    for (auto& c : centers) {
+        for (auto& x : c) {
+            x = center(rng);
+        }
+    }
+    std::vector<Vector<float, N>> result(count);
+    for (size_t i = 0; i < count; i++) {
+        result[i] = centers[rng() % clusters];
+        for (auto& x : result[i]) {
+            x += noise(rng);
+        }
+    }
+    return result;
+}
+
+template <size_t N>
+IvfIndex<float, N> buildIndex(const std::vector<Vector<float, N>>& data, size_t nlist) {
+    IvfIndex<float, N> index(nlist);
+    index.train(data);
+    index.add(data);
+    return index;
+}
+
+}
+
+TEST(IvfIndexTests, allListsIsExact) {
+    const auto data = clusteredVectors<16>(3000, 20, 1);
+    const auto queries = clusteredVectors<16>(40, 20, 2);
+    const auto index = buildIndex(data, 32);
+    EXPECT_EQ(index.size(), data.size());
+    size_t total = 0;
+    for (size_t l = 0; l < index.lists(); l++) {
+        total += index.listSize(l);
+    }
+    EXPECT_EQ(total, data.size());
+
+    const auto exact = KnnBruteForce<float, 16>(data).query(queries, 10);
+    const auto result = index.search(queries, 10, index.lists());
+    ASSERT_EQ(result.k, 10u);
+    for (size_t q = 0; q < queries.size(); q++) {
+        const auto single = index.search(queries[q], 10, index.lists());
+        ASSERT_EQ(single.size(), 10u);
+        for (size_t r = 0; r < 10; r++) {
+            EXPECT_EQ(result.index(q, r), exact.index(q, r));
+            EXPECT_FLOAT_EQ(result.distance(q, r), exact.distance(q, r));
+            EXPECT_EQ(single[r].index, exact.index(q, r));
+        }
+    }
+}
+
+TEST(IvfIndexTests, recall) {
+    const auto data = clusteredVectors<32>(8000, 64, 3);
+    const auto queries = clusteredVectors<32>(100, 64, 4);
+    const auto index = buildIndex(data, 64);
+    const auto exact = KnnBruteForce<float, 32>(data).query(queries, 10);
+    double previous = 0;
+    for (size_t nprobe : {1, 4, 16}) {
+        const auto result = index.search(queries, 10, nprobe);
+        size_t found = 0;
+        for (size_t q = 0; q < queries.size(); q++) {
+            std::set<size_t> truth;
+            for (size_t r = 0; r < 10; r++) {
+                truth.insert(exact.index(q, r));
+            }
+            for (size_t r = 0; r < 10; r++) {
+                found += truth.count(result.index(q, r));
+            }
+        }
+        const double recall = found / (10.0 * queries.size());
+        EXPECT_GE(recall, previous);
+        previous = recall;
+    }
+    EXPECT_GT(previous, 0.95);
+}
+
+TEST(IvfIndexTests, idsAndMissingNeighbors) {
+    const auto data = clusteredVectors<4>(200, 4, 5);
+    IvfIndex<float, 4> index(8);
+    index.train(data);
+    std::vector<size_t> ids(100);
+    for (size_t i = 0; i < ids.size(); i++) {
+        ids[i] = 1000 + i;
+    }
+    index.add(data.data(), 100, ids.data());
+    index.add(data.data() + 100, 100, ids.data());
+    EXPECT_EQ(index.size(), 200u);
+    // the vector itself is its nearest neighbor (the ids of the 2 batches overlap)
+    const auto first = index.search(data[3], 1, 1);
+    ASSERT_EQ(first.size(), 1u);
+    EXPECT_EQ(first[0].index, 1003u);
+    EXPECT_EQ(first[0].distance, 0.0f);
+
+    // a single list cannot hold every neighbor
+    const auto result = index.search(std::vector<Vector<float, 4>>{data[0]}, 200, 1);
+    EXPECT_EQ(result.k, 200u);
+    EXPECT_EQ(result.index(0, 199), (IvfIndex<float, 4>::noNeighbor));
+}
+
+TEST(IvfIndexTests, saveLoad) {
+    const auto data = clusteredVectors<8>(1000, 10, 6);
+    const auto queries = clusteredVectors<8>(20, 10, 7);
+    const auto index = buildIndex(data, 16);
+    const std::string path = testing::TempDir() + "vectornd_index.ivf";
+    index.save(path);
+
+    const auto loaded = IvfIndex<float, 8>::load(path);
+    EXPECT_EQ(loaded.lists(), index.lists());
+    EXPECT_EQ(loaded.size(), index.size());
+    const auto a = index.search(queries, 5, 3);
+    const auto b = loaded.search(queries, 5, 3);
+    EXPECT_EQ(a.indices, b.indices);
+    EXPECT_EQ(a.distances, b.distances);
+
+    EXPECT_THROW((IvfIndex<double, 8>::load(path)), std::runtime_error);
+    EXPECT_THROW((IvfIndex<float, 4>::load(path)), std::runtime_error);
+    // truncated file
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+    }
+    EXPECT_THROW((IvfIndex<float, 8>::load(path)), std::runtime_error);
+    std::remove(path.c_str());
+    EXPECT_THROW((IvfIndex<float, 8>::load(path)), std::runtime_error);
+}
+
+TEST(IvfIndexTests, errors) {
+    EXPECT_THROW((IvfIndex<float, 2>(0)), std::invalid_argument);
+    IvfIndex<float, 2> index(4);
+    std::vector<Vector<float, 2>> points(3);
+    EXPECT_THROW(index.train(points), std::invalid_argument);
+    EXPECT_THROW(index.add(points), std::logic_error);
+    EXPECT_THROW(index.search(points[0], 1, 1), std::logic_error);
+}
@@ -0,0 +1,126 @@
+#include "KMeans.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+// count points around the centers (normal noise of the given deviation)
+template <size_t N>
+std::vector<Vector<float, N>> pointsAround(const std::vector<Vector<float, N>>& centers, size_t count, float deviation, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> noise(0, deviation);
+    std::vector<Vector<float, N>> points(count);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = centers[i % centers.size()];
+        for (auto& x : points[i]) {
+            x += noise(rng);
+        }
+    }
+    return points;
+}
+
+// every center has a centroid closer than tolerance
+template <size_t N>
+void expectCentersFound(const std::vector<Vector<float, N>>& centers, const std::vector<Vector<float, N>>& centroids, double tolerance) {
+    for (const auto& center : centers) {
+        double closest = 1e30;
+        for (const auto& centroid : centroids) {
+            closest = std::min(closest, center.dist(centroid));
+        }
+        EXPECT_LT(closest, tolerance);
+    }
+}
+
+}
+
+TEST(KMeansTests, separatedClusters) {
+    const auto centers = randomVectors<float, 8>(10, 1, -50.0f, 50.0f);
+    const auto points = pointsAround(centers, 5000, 1.0f, 2);
+    KMeans<float, 8> kmeans(10);
+    kmeans.fit(points);
+    ASSERT_EQ(kmeans.centroids().size(), 10u);
+    ASSERT_EQ(kmeans.labels().size(), points.size());
+    expectCentersFound(centers, kmeans.centroids(), 0.2);
+    // the points of a center share a label, and it is their closest centroid
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(kmeans.labels()[i], kmeans.labels()[i % 10]);
+        EXPECT_EQ(kmeans.predict(points[i]), kmeans.labels()[i]);
+    }
+    EXPECT_NEAR(kmeans.inertia() / points.size(), 8.0, 0.5);
+}
+
+TEST(KMeansTests, hamerlyMatchesLloyd) {
+    const auto centers = randomVectors<float, 32>(40, 3, -50.0f, 50.0f);
+    const auto points = pointsAround(centers, 4000, 20.0f, 4);
+    KMeans<float, 32> lloyd(40, KMeansAlgorithm::Lloyd, 7);
+    KMeans<float, 32> hamerly(40, KMeansAlgorithm::Hamerly, 7);
+    lloyd.fit(points);
+    hamerly.fit(points);
+    EXPECT_GT(lloyd.iterations(), 1u);
+    EXPECT_EQ(hamerly.iterations(), lloyd.iterations());
+    EXPECT_EQ(hamerly.labels(), lloyd.labels());
+    for (size_t c = 0; c < 40; c++) {
+        EXPECT_LT(hamerly.centroids()[c].dist(lloyd.centroids()[c]), 1e-4);
+    }
+    EXPECT_NEAR(hamerly.inertia(), lloyd.inertia(), 1e-6 * lloyd.inertia());
+    EXPECT_LT(hamerly.distanceCount(), lloyd.distanceCount());
+
+    // 4 sites, repeated or scattered: a cluster empties after the first iteration and takes
+    // the farthest point, where the upper bounds are loose
+    const std::vector<Vector<float, 2>> sites = {
+        {{8.84873581f, 7.76332855f}}, {{5.90148497f, -4.57078743f}}, {{1.98526382f, 3.1840384f}}, {{-4.13744259f, 5.16273642f}},
+        {{8.84873581f, 7.76332855f}}, {{7.71983147f, -4.97602081f}}, {{1.98526382f, 3.1840384f}}, {{-7.1102643f, 5.15995407f}},
+        {{8.84873581f, 7.76332855f}}, {{4.29401398f, -8.80176258f}}, {{1.98526382f, 3.1840384f}}, {{-3.83011627f, 4.83362961f}},
+        {{8.84873581f, 7.76332855f}}, {{5.19752312f, -8.52260399f}}, {{1.98526382f, 3.1840384f}}, {{-7.67626953f, 3.34024024f}},
+        {{8.84873581f, 7.76332855f}}, {{6.18604517f, -9.45915222f}}, {{1.98526382f, 3.1840384f}}, {{-3.70856667f, 5.67597437f}},
+        {{8.84873581f, 7.76332855f}}, {{6.90544128f, -7.50929546f}}, {{1.98526382f, 3.1840384f}}, {{-6.4804678f, 2.72688842f}},
+        {{8.84873581f, 7.76332855f}}, {{7.38095713f, -9.55587578f}}, {{1.98526382f, 3.1840384f}}, {{-6.07430506f, 4.80173588f}}};
+    KMeans<float, 2> lloydEmpty(8, KMeansAlgorithm::Lloyd, 181658);
+    KMeans<float, 2> hamerlyEmpty(8, KMeansAlgorithm::Hamerly, 181658);
+    lloydEmpty.fit(sites);
+    hamerlyEmpty.fit(sites);
+    EXPECT_EQ(hamerlyEmpty.labels(), lloydEmpty.labels());
+    for (size_t c = 0; c < 8; c++) {
+        EXPECT_EQ(hamerlyEmpty.centroids()[c], lloydEmpty.centroids()[c]);
+    }
+}
+
+TEST(KMeansTests, miniBatch) {
+    const auto centers = randomVectors<float, 4>(5, 5, -50.0f, 50.0f);
+    KMeans<float, 4> kmeans(5);
+    for (unsigned batch = 0; batch < 20; batch++) {
+        kmeans.partialFit(pointsAround(centers, 500, 1.0f, 10 + batch));
+    }
+    expectCentersFound(centers, kmeans.centroids(), 0.2);
+    std::vector<size_t> labels(5);
+    kmeans.predict(centers.data(), 5, labels.data());
+    std::sort(labels.begin(), labels.end());
+    EXPECT_EQ(std::unique(labels.begin(), labels.end()), labels.end());
+}
+
+TEST(KMeansTests, degenerateData) {
+    // less distinct points than clusters: the duplicates become empty clusters, refilled
+    std::vector<Vector<double, 2>> points(6, Vector<double, 2>({1.0, 2.0}));
+    points[5] = Vector<double, 2>({3.0, 4.0});
+    KMeans<double, 2> kmeans(3, KMeansAlgorithm::Lloyd);
+    kmeans.fit(points, 10);
+    EXPECT_EQ(kmeans.inertia(), 0.0);
+    EXPECT_EQ(kmeans.labels()[0], kmeans.labels()[1]);
+    EXPECT_NE(kmeans.labels()[0], kmeans.labels()[5]);
+}
+
+TEST(KMeansTests, errors) {
+    EXPECT_THROW((KMeans<float, 2>(0)), std::invalid_argument);
+    KMeans<float, 2> kmeans(4);
+    std::vector<Vector<float, 2>> points(3);
+    EXPECT_THROW(kmeans.predict(points[0]), std::logic_error);
+    EXPECT_THROW(kmeans.fit(points), std::invalid_argument);
+    EXPECT_THROW(kmeans.partialFit(points), std::invalid_argument);
+}
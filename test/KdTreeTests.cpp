@@ -0,0 +1,108 @@
+#include "KdTree.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+template <typename T, size_t N>
+std::vector<Neighbor<T>> sortedNeighbors(const std::vector<Vector<T, N>>& points, const Vector<T, N>& query) {
+    std::vector<Neighbor<T>> all;
+    for (size_t i = 0; i < points.size(); i++) {
+        all.push_back({i, static_cast<T>(query.squaredDist(points[i]))});
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+}
+
+TEST(KdTreeTests, nearest) {
+    auto points = randomVectors<double, 3>(5000, 1);
+    auto queries = randomVectors<double, 3>(100, 2);
+    KdTree<double, 3> tree(points);
+    EXPECT_EQ(tree.size(), points.size());
+    for (const auto& query : queries) {
+        auto expected = sortedNeighbors(points, query).front();
+        auto found = tree.nearest(query);
+        EXPECT_EQ(found.index, expected.index);
+        EXPECT_DOUBLE_EQ(found.distance, expected.distance);
+    }
+    // empty tree
+    KdTree<double, 3> empty(std::vector<Vector<double, 3>>{});
+    const auto none = empty.nearest(queries[0]);
+    EXPECT_EQ(none.index, (KdTree<double, 3>::noNeighbor));
+    EXPECT_EQ(none.distance, std::numeric_limits<double>::max());
+    EXPECT_TRUE(empty.knn(queries[0], 3).empty());
+}
+
+TEST(KdTreeTests, knn) {
+    auto points = randomVectors<float, 2>(3000, 3);
+    auto queries = randomVectors<float, 2>(50, 4);
+    KdTree<float, 2> tree(points);
+    auto batch = tree.knn(queries.data(), queries.size(), 7);
+    ASSERT_EQ(batch.size(), queries.size());
+    for (size_t q = 0; q < queries.size(); q++) {
+        auto expected = sortedNeighbors(points, queries[q]);
+        auto found = tree.knn(queries[q], 7);
+        ASSERT_EQ(found.size(), 7u);
+        for (size_t r = 0; r < 7; r++) {
+            EXPECT_EQ(found[r].index, expected[r].index);
+            EXPECT_EQ(batch.index(q, r), expected[r].index);
+            EXPECT_FLOAT_EQ(batch.distance(q, r), expected[r].distance);
+        }
+    }
+    // more neighbors than points
+    KdTree<float, 2> small(std::vector<Vector<float, 2>>(points.begin(), points.begin() + 5));
+    EXPECT_EQ(small.knn(queries[0], 10).size(), 5u);
+}
+
+TEST(KdTreeTests, radiusSearch) {
+    auto points = randomVectors<double, 6>(4000, 5);
+    auto queries = randomVectors<double, 6>(30, 6);
+    KdTree<double, 6> tree(points);
+    const double radius = 0.6;
+    auto batch = tree.radiusSearch(queries.data(), queries.size(), radius);
+    for (size_t q = 0; q < queries.size(); q++) {
+        auto expected = sortedNeighbors(points, queries[q]);
+        expected.erase(std::remove_if(expected.begin(), expected.end(),
+                                      [radius](const Neighbor<double>& n) { return n.distance > radius * radius; }),
+                       expected.end());
+        ASSERT_EQ(batch[q].size(), expected.size());
+        for (size_t r = 0; r < expected.size(); r++) {
+            EXPECT_EQ(batch[q][r].index, expected[r].index);
+        }
+    }
+}
+
+TEST(KdTreeTests, duplicates) {
+    // many equal coordinates on the split axis
+    std::vector<Vector<int, 2>> points;
+    for (int i = 0; i < 200; i++) {
+        points.push_back(Vector<int, 2>({i % 3, i / 3}));
+    }
+    KdTree<int, 2> tree(points);
+    for (const auto& p : points) {
+        EXPECT_EQ(tree.nearest(p).distance, 0);
+        EXPECT_EQ(points[tree.nearest(p).index], p);
+    }
+}
+
+TEST(KdTreeTests, parallelBuild) {
+    // large enough for the build tasks
+    auto points = randomVectors<float, 4>(40000, 7);
+    auto queries = randomVectors<float, 4>(20, 8);
+    KdTree<float, 4> tree(points);
+    auto batch = tree.knn(queries, 5);
+    for (size_t q = 0; q < queries.size(); q++) {
+        auto expected = sortedNeighbors(points, queries[q]);
+        for (size_t r = 0; r < 5; r++) {
+            EXPECT_EQ(batch.index(q, r), expected[r].index);
+        }
+    }
+}
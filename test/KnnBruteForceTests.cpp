@@ -0,0 +1,70 @@
+#include "KnnBruteForce.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+// reference: sort every squared distance
+template <typename T, size_t N>
+void expectExact(const std::vector<Vector<T, N>>& data, const std::vector<Vector<T, N>>& queries,
+                 const KnnResult<T>& result, size_t k) {
+    ASSERT_EQ(result.size(), queries.size());
+    ASSERT_EQ(result.k, k);
+    for (size_t q = 0; q < queries.size(); q++) {
+        std::vector<std::pair<T, size_t>> all;
+        for (size_t j = 0; j < data.size(); j++) {
+            all.emplace_back(static_cast<T>(queries[q].squaredDist(data[j])), j);
+        }
+        std::sort(all.begin(), all.end());
+        for (size_t r = 0; r < k; r++) {
+            EXPECT_EQ(result.index(q, r), all[r].second);
+            EXPECT_NEAR(result.distance(q, r), all[r].first, 1e-5);
+        }
+    }
+}
+
+}
+
+TEST(KnnBruteForceTests, query) {
+    auto data = randomVectors<float, 3>(1000, 1);
+    auto queries = randomVectors<float, 3>(40, 2);
+    KnnBruteForce<float, 3> knn(data);
+    EXPECT_EQ(knn.size(), data.size());
+    expectExact(data, queries, knn.query(queries, 10), 10);
+    // a point of the dataset is its own nearest neighbor
+    auto self = knn.query(&data[123], 1, 1);
+    EXPECT_EQ(self.index(0, 0), 123u);
+    EXPECT_FLOAT_EQ(self.distance(0, 0), 0.f);
+}
+
+TEST(KnnBruteForceTests, shards) {
+#if defined(_OPENMP)
+    // few queries and several threads: the dataset is split into shards
+    const int threads = omp_get_max_threads();
+    omp_set_num_threads(4);
+#endif
+    auto data = randomVectors<double, 8>(20000, 3);
+    auto queries = randomVectors<double, 8>(3, 4);
+    KnnBruteForce<double, 8> knn(data);
+    expectExact(data, queries, knn.query(queries, 25), 25);
+#if defined(_OPENMP)
+    omp_set_num_threads(threads);
+#endif
+}
+
+TEST(KnnBruteForceTests, smallDataset) {
+    std::vector<Vector<int, 2>> data{Vector<int, 2>({0, 0}), Vector<int, 2>({3, 4}), Vector<int, 2>({1, 1})};
+    KnnBruteForce<int, 2> knn(data);
+    auto result = knn.query(std::vector<Vector<int, 2>>{Vector<int, 2>({0, 1})}, 5);
+    // k is limited by the size of the dataset
+    ASSERT_EQ(result.k, 3u);
+    EXPECT_EQ(result.index(0, 0), 0u);
+    EXPECT_EQ(result.index(0, 1), 2u);
+    EXPECT_EQ(result.index(0, 2), 1u);
+    EXPECT_EQ(result.distance(0, 2), 18);
+}
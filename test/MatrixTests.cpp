@@ -0,0 +1,144 @@
+#include "Matrix.hpp"
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T, size_t R, size_t C>
+Matrix<T, R, C> randomMatrix(std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-8, 8);
+    Matrix<T, R, C> m;
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            m(r, c) = static_cast<T>(dist(rng)) / 4;
+        }
+    }
+    return m;
+}
+
+// multiples of 1/8, the products and sums of the tests stay exact
+template <typename T, size_t N>
+std::vector<Vector<T, N>> exactVectors(size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(-64, 64);
+    std::vector<Vector<T, N>> vectors(count);
+    for (auto& v : vectors) {
+        for (auto& x : v) {
+            x = static_cast<T>(dist(rng)) / 8;
+        }
+    }
+    return vectors;
+}
+
+// naive row by column product (exact: the values are small multiples of powers of 2)
+template <typename T, size_t R, size_t C>
+Vector<T, R> naiveProduct(const Matrix<T, R, C>& m, const Vector<T, C>& v) {
+    Vector<T, R> result;
+    for (size_t r = 0; r < R; r++) {
+        for (size_t c = 0; c < C; c++) {
+            result[r] += m(r, c) * v[c];
+        }
+    }
+    return result;
+}
+
+template <typename T, size_t R, size_t C>
+void checkProducts() {
+    std::mt19937 rng(R * 31 + C);
+    const auto m = randomMatrix<T, R, C>(rng);
+    for (size_t count : {1, 3, 17, 5000}) {
+        const auto in = exactVectors<T, C>(count, rng);
+        std::vector<Vector<T, R>> out;
+        transform(m, in, out);
+        ASSERT_EQ(out.size(), count);
+        for (size_t i = 0; i < count; i++) {
+            ASSERT_EQ(out[i], naiveProduct(m, in[i])) << i;
+            ASSERT_EQ(m * in[i], out[i]) << i;
+        }
+    }
+    // matrix products, against the product of the columns
+    const auto b = randomMatrix<T, C, 3>(rng);
+    const Matrix<T, R, 3> product = m * b;
+    for (size_t c = 0; c < 3; c++) {
+        EXPECT_EQ(product.column(c), naiveProduct(m, b.column(c)));
+    }
+    EXPECT_EQ((m.transpose().transpose()), m);
+}
+
+template <typename T, size_t R>
+void checkAffine() {
+    std::mt19937 rng(R);
+    const auto m = randomMatrix<T, R, R + 1>(rng);
+    auto points = exactVectors<T, R>(9000, rng);
+    std::vector<Vector<T, R>> out;
+    transformPoints(m, points, out);
+    for (size_t i = 0; i < points.size(); i++) {
+        Vector<T, R + 1> homogeneous;
+        for (size_t d = 0; d < R; d++) {
+            homogeneous[d] = points[i][d];
+        }
+        homogeneous[R] = 1;
+        ASSERT_EQ(out[i], naiveProduct(m, homogeneous)) << i;
+        ASSERT_EQ(m.transformPoint(points[i]), out[i]) << i;
+    }
+    // in place
+    transformPoints(m, points.data(), points.data(), points.size());
+    EXPECT_EQ(points, out);
+}
+
+}
+
+TEST(MatrixTests, construction) {
+    const Matrix<int, 2, 3> m({{{1, 2, 3}, {4, 5, 6}}});
+    EXPECT_EQ(m(0, 2), 3);
+    EXPECT_EQ(m(1, 0), 4);
+    EXPECT_EQ(m.row(1), (Vector<int, 3>({4, 5, 6})));
+    EXPECT_EQ(m.column(1), (Vector<int, 2>({2, 5})));
+    EXPECT_EQ((Matrix<int, 2, 3>::fromRows({Vector<int, 3>({1, 2, 3}), Vector<int, 3>({4, 5, 6})})), m);
+    EXPECT_EQ((Matrix<int, 2, 3>::fromColumns({Vector<int, 2>({1, 4}), Vector<int, 2>({2, 5}), Vector<int, 2>({3, 6})})), m);
+    EXPECT_EQ(m.transpose(), (Matrix<int, 3, 2>({{{1, 4}, {2, 5}, {3, 6}}})));
+    EXPECT_EQ(m + m, m * 2);
+    EXPECT_EQ(2 * m - m, m);
+    EXPECT_NE(m, (Matrix<int, 2, 3>()));
+    std::ostringstream os;
+    os << m;
+    EXPECT_EQ(os.str(), "[[1, 2, 3], [4, 5, 6]]");
+}
+
+TEST(MatrixTests, constexprProducts) {
+    constexpr Matrix<int, 3, 3> identity = Matrix<int, 3, 3>::identity();
+    constexpr Matrix<int, 3, 3> m({{{1, 2, 3}, {4, 5, 6}, {7, 8, 10}}});
+    static_assert(identity * m == m);
+    static_assert(m * Vector<int, 3>({1, 0, -1}) == Vector<int, 3>({-2, -2, -3}));
+    static_assert(Matrix<int, 2, 3>({{{1, 0, 5}, {0, 1, 6}}}).transformPoint(Vector<int, 2>({1, 2})) == Vector<int, 2>({6, 8}));
+    const Matrix<float, 4, 4> identity4 = Matrix<float, 4, 4>::identity();
+    const Vector<float, 4> v({1.5f, -2.0f, 3.0f, 4.25f});
+    EXPECT_EQ(identity4 * v, v);
+}
+
+TEST(MatrixTests, smallKernels) {
+    checkProducts<float, 2, 2>();
+    checkProducts<float, 3, 3>();
+    checkProducts<float, 4, 4>();
+    checkProducts<double, 2, 2>();
+    checkProducts<double, 3, 3>();
+    checkProducts<double, 4, 4>();
+    checkProducts<int, 3, 3>();
+}
+
+TEST(MatrixTests, otherSizes) {
+    checkProducts<float, 3, 2>();
+    checkProducts<float, 8, 5>();
+    checkProducts<float, 17, 4>();
+    checkProducts<double, 6, 6>();
+}
+
+TEST(MatrixTests, affineTransforms) {
+    checkAffine<float, 2>();
+    checkAffine<float, 3>();
+    checkAffine<double, 3>();
+    checkAffine<int, 3>();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "FastNormalize.hpp"
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T, size_t N>
+std::vector<Vector<T, N>> wideRangeVectors(size_t count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-1, 1);
+    std::uniform_int_distribution<int> exponent(-18, 18);
+    std::vector<Vector<T, N>> vectors(count);
+    for (auto& v : vectors) {
+        // magnitudes from 1e-18 to 1e18
+        const double scale = std::pow(10.0, exponent(rng));
+        for (auto& x : v) {
+            x = static_cast<T>(dist(rng) * scale);
+        }
+    }
+    return vectors;
+}
+
+template <typename T, size_t N>
+double exactNorm(const Vector<T, N>& v) {
+    long double sum = 0;
+    for (size_t i = 0; i < N; i++) {
+        sum += static_cast<long double>(v[i]) * v[i];
+    }
+    return static_cast<double>(std::sqrt(sum));
+}
+
+template <size_t N>
+void checkFloatInvNorm() {
+    for (const auto& v : wideRangeVectors<float, N>(1000, N)) {
+        const double expected = 1 / exactNorm(v);
+        // the float squared norm adds its own rounding to the 5e-7 of the estimate
+        EXPECT_NEAR(v.invNorm() / expected, 1.0, 1e-6);
+        EXPECT_NEAR(exactNorm(v.fastNormalized()), 1.0, 1e-6);
+    }
+}
+
+} // namespace
+
+TEST(NormalizeTests, invNormFloat) {
+    checkFloatInvNorm<3>();
+    checkFloatInvNorm<4>();
+    checkFloatInvNorm<16>();
+}
+
+TEST(NormalizeTests, invNormDoubleIsExact) {
+    const Vector<double, 3> v({3, 4, 12});
+    EXPECT_DOUBLE_EQ(v.invNorm(), 1.0 / 13);
+    EXPECT_EQ(v.fastNormalized(), v.normalized());
+}
+
+TEST(NormalizeTests, nullVector) {
+    Vector<float, 4> zero;
+    EXPECT_TRUE(std::isinf(zero.invNorm()));
+    EXPECT_EQ(zero.fastNormalize(), (Vector<float, 4>()));
+
+    std::vector<Vector<float, 3>> vectors(3);
+    vectors[1] = Vector<float, 3>({1, 2, 2});
+    fastNormalize(vectors);
+    EXPECT_EQ(vectors[0], (Vector<float, 3>()));
+    EXPECT_EQ(vectors[2], (Vector<float, 3>()));
+    EXPECT_NEAR(vectors[1][0], 1.0f / 3, 1e-6);
+
+    const auto inverse = invNorm(std::vector<Vector<float, 3>>(1));
+    EXPECT_TRUE(std::isinf(inverse[0]));
+}
+
+TEST(NormalizeTests, tinyAndHugeSquaredNorms) {
+    // squared norms outside the normal floats (subnormal, inf) take the exact path
+    const Vector<float, 3> tiny({1e-20f, 0, 0});
+    const Vector<float, 3> huge({1e25f, 0, 0});
+    EXPECT_NEAR(tiny.invNorm() * 1e-20f, 1.0f, 1e-4);
+    std::vector<Vector<float, 3>> vectors{tiny, huge};
+    const auto inverse = invNorm(vectors);
+    EXPECT_NEAR(inverse[0] * 1e-20f, 1.0f, 1e-4);
+    EXPECT_EQ(inverse[1], 0.0f);
+}
+
+TEST(NormalizeTests, batchMatchesSingle) {
+    // counts that are not multiples of the block
+    for (size_t count : {1, 15, 17, 100}) {
+        auto vectors = wideRangeVectors<float, 7>(count, static_cast<unsigned>(count));
+        const auto inverse = invNorm(vectors);
+        auto normalized = vectors;
+        fastNormalize(normalized);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_NEAR(inverse[i] / vectors[i].invNorm(), 1.0f, 1e-6);
+            EXPECT_NEAR(exactNorm(normalized[i]), 1.0, 1e-6);
+        }
+    }
+}
+
+TEST(NormalizeTests, batchDouble) {
+    auto vectors = wideRangeVectors<double, 5>(37, 5);
+    const auto inverse = invNorm(vectors);
+    fastNormalize(vectors);
+    for (size_t i = 0; i < vectors.size(); i++) {
+        EXPECT_NEAR(exactNorm(vectors[i]), 1.0, 1e-14);
+        EXPECT_GT(inverse[i], 0);
+    }
+}
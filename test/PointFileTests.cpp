@@ -0,0 +1,143 @@
+#include "PointFile.hpp"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace VectorND;
+
+static_assert(hasArrayLayout<float, 3>);
+static_assert(hasArrayLayout<double, 16>);
+static_assert(hasArrayLayout<int, 2>);
+
+namespace {
+
+std::vector<Vector<float, 3>> makePoints(size_t count) {
+    std::vector<Vector<float, 3>> points(count);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = Vector<float, 3>({0.5f * i, 1.0f - i, 2.0f + 0.25f * i});
+    }
+    return points;
+}
+
+std::string tempPath(const std::string& name) {
+    return testing::TempDir() + "vectornd_" + name + ".pts";
+}
+
+}
+
+TEST(PointFileTests, aosZeroCopy) {
+    const auto points = makePoints(1000);
+    const std::string path = tempPath("aos");
+    writePointFile(path, points);
+
+    MappedPointFile<float, 3> file(path);
+    EXPECT_EQ(file.size(), points.size());
+    EXPECT_EQ(file.layout(), PointLayout::AoS);
+    EXPECT_EQ(file.header().dimension, 3u);
+    const VectorSpan<float, 3> span = file.vectors();
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(span.data()) % pointFileAlignment, 0u);
+    ASSERT_EQ(span.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++) {
+        EXPECT_EQ(span[i], points[i]);
+    }
+    EXPECT_EQ(file[7], points[7]);
+    EXPECT_EQ(file.toVectors(), points);
+    EXPECT_THROW(file.lane(0), std::logic_error);
+
+    // a moved file keeps the mapping
+    MappedPointFile<float, 3> moved(std::move(file));
+    EXPECT_EQ(moved.vectors().data(), span.data());
+    EXPECT_EQ(file.size(), 0u);
+    std::remove(path.c_str());
+}
+
+TEST(PointFileTests, soaLanes) {
+    const auto points = makePoints(37);
+    const std::string path = tempPath("soa");
+    writePointFile(path, points, PointLayout::SoA);
+
+    MappedPointFile<float, 3> file(path);
+    EXPECT_EQ(file.layout(), PointLayout::SoA);
+    for (size_t d = 0; d < 3; d++) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(file.lane(d)) % pointFileAlignment, 0u);
+        for (size_t i = 0; i < points.size(); i++) {
+            EXPECT_EQ(file.lane(d)[i], points[i][d]);
+        }
+    }
+    EXPECT_EQ(file.toVectors(), points);
+    EXPECT_EQ(file.toVectorArray().toVectors(), points);
+    EXPECT_THROW(file.vectors(), std::logic_error);
+
+    // a VectorArray is written lane by lane
+    writePointFile(path, VectorArray<float, 3>(points));
+    EXPECT_EQ((MappedPointFile<float, 3>(path).toVectors()), points);
+    std::remove(path.c_str());
+}
+
+TEST(PointFileTests, chunkedReader) {
+    const auto points = makePoints(1001);
+    for (PointLayout layout : {PointLayout::AoS, PointLayout::SoA}) {
+        const std::string path = tempPath("chunks");
+        writePointFile(path, points, layout);
+        PointFileReader<float, 3> reader(path);
+        EXPECT_EQ(reader.size(), points.size());
+        std::vector<Vector<float, 3>> all, chunk;
+        while (reader.next(chunk, 100)) {
+            EXPECT_LE(chunk.size(), 100u);
+            all.insert(all.end(), chunk.begin(), chunk.end());
+        }
+        EXPECT_EQ(all, points);
+        EXPECT_TRUE(chunk.empty());
+
+        reader.seek(995);
+        Vector<float, 3> last[10];
+        EXPECT_EQ(reader.read(last, 10), 6u);
+        EXPECT_EQ(last[5], points[1000]);
+        EXPECT_EQ(reader.tell(), 1001u);
+        std::remove(path.c_str());
+    }
+}
+
+TEST(PointFileTests, empty) {
+    const std::string path = tempPath("empty");
+    writePointFile(path, std::vector<Vector<double, 2>>{}, PointLayout::SoA);
+    MappedPointFile<double, 2> file(path);
+    EXPECT_EQ(file.size(), 0u);
+    EXPECT_TRUE(file.toVectors().empty());
+    std::remove(path.c_str());
+}
+
+TEST(PointFileTests, invalidFiles) {
+    const auto points = makePoints(10);
+    const std::string path = tempPath("invalid");
+    writePointFile(path, points);
+    // another type or dimension
+    EXPECT_THROW((MappedPointFile<double, 3>(path)), std::runtime_error);
+    EXPECT_THROW((MappedPointFile<float, 4>(path)), std::runtime_error);
+    EXPECT_THROW((PointFileReader<int, 3>(path)), std::runtime_error);
+
+    // truncated data
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() - 4));
+    }
+    EXPECT_THROW((MappedPointFile<float, 3>(path)), std::runtime_error);
+
+    // not a point file
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "0.5 1.0 2.0\n";
+    }
+    EXPECT_THROW((MappedPointFile<float, 3>(path)), std::runtime_error);
+    EXPECT_THROW((PointFileReader<float, 3>(path)), std::runtime_error);
+    std::remove(path.c_str());
+
+    // missing file
+    EXPECT_THROW((MappedPointFile<float, 3>(path)), std::runtime_error);
+}
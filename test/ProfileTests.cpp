@@ -0,0 +1,98 @@
+// built in its own executable with VECTORND_PROFILE (the copy constructor of Vector differs)
+#include "Vector.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace VectorND;
+
+static_assert(profile::enabled, "ProfileTests needs VECTORND_PROFILE");
+
+using V = Vector<float, 3>;
+
+TEST(ProfileTests, operators) {
+    const V a{{1, 2, 3}};
+    const V b{{4, 5, 6}};
+    profile::reset();
+    // one expression: 2 operators, a single evaluation, no temporary
+    V c(a + b * 2.0f);
+    c += a;
+    c /= 2.0f;
+    auto e = profile::report().entry<float, 3>();
+    EXPECT_EQ(e.count(profile::Op::Add), 1u);
+    EXPECT_EQ(e.count(profile::Op::Mul), 1u);
+    // the compound assignments do not count their operator again
+    EXPECT_EQ(e.count(profile::Op::AddAssign), 1u);
+    EXPECT_EQ(e.count(profile::Op::DivAssign), 1u);
+    EXPECT_EQ(e.temporaries(), 0u);
+    EXPECT_EQ(e.flops, 4u * 3u);
+    // add, compound add: 3 vectors, scalar product, scalar division: 2 vectors
+    EXPECT_EQ(e.bytes, (3u + 2u + 3u + 2u) * 3u * sizeof(float));
+    EXPECT_EQ(c, (V{{5, 7, 9}}));
+}
+
+TEST(ProfileTests, reductionsAndTemporaries) {
+    const V a{{3, 4, 0}};
+    const V b{{0, 0, 1}};
+    profile::reset();
+    EXPECT_EQ(a.dot(b), 0.0f);
+    EXPECT_EQ(a.norm(), 5.0);
+    EXPECT_EQ(a.squaredNorm(), 25.0);
+    EXPECT_NEAR(a.dist(b), std::sqrt(26.0), 1e-12);
+    const V m = a.mod(2.0f);
+    const V copy = m;
+    V defaulted;
+    const Vector<double, 3> converted = static_cast<Vector<double, 3>>(a);
+
+    const auto report = profile::report();
+    const auto e = report.entry<float, 3>();
+    EXPECT_EQ(e.count(profile::Op::Dot), 1u);
+    EXPECT_EQ(e.count(profile::Op::Norm), 2u);
+    EXPECT_EQ(e.count(profile::Op::Dist), 1u);
+    EXPECT_EQ(e.count(profile::Op::Mod), 1u);
+    EXPECT_EQ(e.count(profile::Op::Cast), 1u);
+    // the result of mod, defaulted, and the copy
+    EXPECT_EQ(e.count(profile::Op::DefaultConstruct), 2u);
+    EXPECT_EQ(e.count(profile::Op::CopyConstruct), 1u);
+    // the result of the cast
+    EXPECT_EQ((report.entry<double, 3>().count(profile::Op::DefaultConstruct)), 1u);
+    EXPECT_EQ(copy, m);
+    EXPECT_EQ(converted[0], 3.0);
+    (void)defaulted;
+}
+
+TEST(ProfileTests, threads) {
+    const Vector<double, 8> a;
+    profile::reset();
+    // the counters of a finished thread are kept
+    std::thread worker([&] {
+        for (int i = 0; i < 100; i++) {
+            EXPECT_EQ(a.dot(a), 0.0);
+        }
+    });
+    worker.join();
+    EXPECT_EQ(a.dot(a), 0.0);
+    EXPECT_EQ((profile::report().entry<double, 8>().count(profile::Op::Dot)), 101u);
+    profile::reset();
+    EXPECT_EQ((profile::report().entry<double, 8>().count(profile::Op::Dot)), 0u);
+}
+
+TEST(ProfileTests, reports) {
+    const Vector<int32_t, 2> a{{1, 2}};
+    profile::reset();
+    const auto sum = Vector<int32_t, 2>(a + a);
+    EXPECT_EQ(sum[1], 4);
+    const auto report = profile::report();
+    const std::string text = report.text();
+    EXPECT_NE(text.find("Vector<int32, 2>: add 1"), std::string::npos) << text;
+    const std::string json = report.json();
+    EXPECT_NE(json.find("{\"type\": \"int32\", \"size\": 2, \"calls\": {\"add\": 1}, \"flops\": 2, \"bytes\": 24}"),
+              std::string::npos) << json;
+}
+
+TEST(ProfileTests, constantExpressions) {
+    // nothing is counted at compile time
+    constexpr Vector<int, 2> v = Vector<int, 2>{{1, 2}} + Vector<int, 2>{{3, 4}};
+    static_assert(v[1] == 6);
+    EXPECT_EQ(v[0], 4);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "QuantizedVector.hpp"
+#include "TestUtils.hpp"
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+template <typename Code>
+std::vector<Code> randomCodes(size_t count, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dist(detail::codeMin<Code>, detail::codeMax<Code>);
+    std::vector<Code> codes(count);
+    for (auto& code : codes) {
+        code = static_cast<Code>(dist(rng));
+    }
+    return codes;
+}
+
+template <typename Q>
+void checkRoundTrip(float low, float high) {
+    constexpr size_t N = Q::size;
+    for (const auto& v : randomVectors<float, N>(50, 7, low, high)) {
+        const Q q(v);
+        const Vector<float, N> back = q.dequantize();
+        for (size_t i = 0; i < N; i++) {
+            const float scale = q.scale(i / Q::blockSize);
+            EXPECT_LE(std::fabs(back[i] - v[i]), scale * 0.5001f) << i;
+            EXPECT_EQ(back[i], q[i]);
+        }
+    }
+}
+
+template <typename Q>
+void checkProducts(unsigned seed) {
+    constexpr size_t N = Q::size;
+    const auto vectors = randomVectors<float, N>(40, seed, -3.0f, 5.0f);
+    std::vector<Q> quantized = quantize<Q>(vectors);
+    for (size_t i = 0; i + 1 < vectors.size(); i++) {
+        const Q& a = quantized[i];
+        const Q& b = quantized[i + 1];
+        // the dequantized vectors, in double
+        double dot = 0, squaredDist = 0, squaredNorm = 0;
+        for (size_t j = 0; j < N; j++) {
+            dot += static_cast<double>(a[j]) * b[j];
+            squaredDist += (static_cast<double>(a[j]) - b[j]) * (static_cast<double>(a[j]) - b[j]);
+            squaredNorm += static_cast<double>(a[j]) * a[j];
+        }
+        EXPECT_NEAR(a.dot(b), dot, 1e-5 * (1 + std::fabs(dot)));
+        EXPECT_NEAR(a.squaredDist(b), squaredDist, 1e-5 * (1 + squaredDist));
+        EXPECT_NEAR(a.squaredNorm(), squaredNorm, 1e-5 * (1 + squaredNorm));
+        EXPECT_EQ(a.squaredDist(a), 0.0);
+        // close to the float vectors: each element is off by at most scale / 2
+        double bound = 0;
+        for (size_t j = 0; j < N; j++) {
+            const double ea = a.scale(j / Q::blockSize) / 2;
+            const double eb = b.scale(j / Q::blockSize) / 2;
+            bound += std::fabs(vectors[i][j]) * eb + std::fabs(vectors[i + 1][j]) * ea + ea * eb;
+        }
+        EXPECT_NEAR(a.dot(b), vectors[i].dot(vectors[i + 1]), bound * 1.001 + 1e-5);
+    }
+}
+
+} // namespace
+
+TEST(QuantizedVectorTests, layout) {
+    static_assert(sizeof(QuantizedVector<128>) == 136);
+    static_assert(sizeof(QuantizedVector<128, uint8_t, 32>) == 128 + 4 * 4 + 4);
+    static_assert(QuantizedVector<100, int8_t, 32>::blockCount == 4);
+    const QuantizedVector<5> zero;
+    EXPECT_EQ(zero.squaredNorm(), 0.0);
+    EXPECT_EQ(zero.dequantize(), (Vector<float, 5>()));
+}
+
+TEST(QuantizedVectorTests, roundTrip) {
+    checkRoundTrip<QuantizedVector<3>>(-1, 1);
+    checkRoundTrip<QuantizedVector<64>>(-10, 3);
+    checkRoundTrip<QuantizedVector<100, int8_t, 16>>(-1, 1);
+    checkRoundTrip<QuantizedVector<3, uint8_t>>(-1, 1);
+    checkRoundTrip<QuantizedVector<64, uint8_t>>(2, 3);
+    checkRoundTrip<QuantizedVector<100, uint8_t, 32>>(-5, 1);
+
+    // 0 is exact, the extremes map on the extreme codes
+    const QuantizedVector<4, uint8_t> q(Vector<float, 4>({0, 1, 2, 3}));
+    EXPECT_EQ(q[0], 0.0f);
+    EXPECT_EQ(q.codes()[3], 255);
+    const QuantizedVector<4> s(Vector<float, 4>({0, -4, 2, 3}));
+    EXPECT_EQ(s.codes()[1], -127);
+    EXPECT_EQ(s.zeroPoint(), 0);
+}
+
+TEST(QuantizedVectorTests, products) {
+    checkProducts<QuantizedVector<3>>(1);
+    checkProducts<QuantizedVector<16>>(2);
+    checkProducts<QuantizedVector<128>>(3);
+    checkProducts<QuantizedVector<200, int8_t, 64>>(4);
+    checkProducts<QuantizedVector<3, uint8_t>>(5);
+    checkProducts<QuantizedVector<33, uint8_t>>(6);
+    checkProducts<QuantizedVector<128, uint8_t>>(7);
+    checkProducts<QuantizedVector<200, uint8_t, 48>>(8);
+}
+
+TEST(QuantizedVectorTests, codeKernels) {
+    std::mt19937 rng(11);
+    for (size_t n = 0; n < 300; n += n < 70 ? 1 : 37) {
+        const auto a8 = randomCodes<int8_t>(n, rng);
+        const auto b8 = randomCodes<int8_t>(n, rng);
+        const auto a = randomCodes<uint8_t>(n, rng);
+        const auto b = randomCodes<uint8_t>(n, rng);
+        int64_t symmetric = 0, signedShifted = 0, affine = 0, signedDiffs = 0, diffs = 0;
+        int64_t signedSquaresA = 0, signedSquaresB = 0;
+        for (size_t i = 0; i < n; i++) {
+            symmetric += a8[i] * b8[i];
+            signedShifted += (a8[i] + 5) * (b8[i] - 127);
+            affine += (a[i] - 200) * (b[i] - 3);
+            signedDiffs += (a8[i] - b8[i]) * (a8[i] - b8[i]);
+            diffs += (a[i] - b[i]) * (a[i] - b[i]);
+            signedSquaresA += a8[i] * a8[i];
+            signedSquaresB += b8[i] * b8[i];
+        }
+        EXPECT_EQ(detail::sumCodeProducts(a8.data(), 0, b8.data(), 0, n), symmetric) << n;
+        EXPECT_EQ(detail::sumCodeProducts(a8.data(), -5, b8.data(), 127, n), signedShifted) << n;
+        EXPECT_EQ(detail::sumCodeProducts(a.data(), 200, b.data(), 3, n), affine) << n;
+        EXPECT_EQ(detail::sumCodeSquaredDiffs(a8.data(), b8.data(), n), signedDiffs) << n;
+        EXPECT_EQ(detail::sumCodeSquaredDiffs(a.data(), b.data(), n), diffs) << n;
+        const detail::CodeMoments moments = detail::sumCodeMoments(a.data(), 200, b.data(), 3, n);
+        EXPECT_EQ(moments.ab, affine) << n;
+        EXPECT_EQ(moments.aa, detail::sumCodeProducts(a.data(), 200, a.data(), 200, n)) << n;
+        EXPECT_EQ(moments.bb, detail::sumCodeProducts(b.data(), 3, b.data(), 3, n)) << n;
+        const detail::CodeMoments symmetricMoments = detail::sumCodeMoments(a8.data(), 0, b8.data(), 0, n);
+        EXPECT_EQ(symmetricMoments.ab, symmetric) << n;
+        EXPECT_EQ(symmetricMoments.aa, signedSquaresA) << n;
+        EXPECT_EQ(symmetricMoments.bb, signedSquaresB) << n;
+    }
+
+    // extreme codes: no saturation of the 16 bits pairs
+    const std::vector<int8_t> high(4096, 127), low(4096, -127);
+    EXPECT_EQ(detail::sumCodeProducts(high.data(), 0, low.data(), 0, 4096), -127 * 127 * 4096);
+    EXPECT_EQ(detail::sumCodeProducts(low.data(), 0, low.data(), 0, 4096), 127 * 127 * 4096);
+    const std::vector<uint8_t> full(4096, 255), empty(4096, 0);
+    EXPECT_EQ(detail::sumCodeSquaredDiffs(full.data(), empty.data(), 4096), 255 * 255 * 4096);
+    EXPECT_EQ(detail::sumCodeProducts(full.data(), 0, empty.data(), 255, 4096), -255 * 255 * 4096);
+}
+
+TEST(QuantizedVectorTests, rawCodes) {
+    const QuantizedVector<4> q({1, -2, 3, 127}, {0.5f}, {0});
+    EXPECT_EQ(q.dequantize(), (Vector<float, 4>({0.5f, -1, 1.5f, 63.5f})));
+    EXPECT_THROW((QuantizedVector<4>({1, -128, 3, 4}, {1.0f}, {0})), std::invalid_argument);
+    const QuantizedVector<3, uint8_t> u({0, 10, 255}, {2.0f}, {10});
+    EXPECT_EQ(u.dequantize(), (Vector<float, 3>({-20, 0, 490})));
+}
@@ -0,0 +1,130 @@
+#include "SpaceFillingCurve.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+template <size_t N>
+uint64_t naiveInterleave(const std::array<uint32_t, N>& cell) {
+    uint64_t code = 0;
+    for (unsigned bit = 0; bit < curveBits<N>; bit++) {
+        for (size_t d = 0; d < N; d++) {
+            code |= uint64_t((cell[d] >> bit) & 1) << (bit * N + d);
+        }
+    }
+    return code;
+}
+
+// every cell of a 2^bits grid once, and consecutive indices on neighbor cells
+template <size_t N>
+void checkHilbert(unsigned bits) {
+    const uint32_t side = 1u << bits;
+    size_t cells = 1;
+    for (size_t d = 0; d < N; d++) {
+        cells *= side;
+    }
+    std::vector<std::array<uint32_t, N>> byIndex(cells);
+    std::vector<bool> seen(cells, false);
+    for (size_t c = 0; c < cells; c++) {
+        std::array<uint32_t, N> cell;
+        size_t rest = c;
+        for (size_t d = 0; d < N; d++) {
+            cell[d] = static_cast<uint32_t>(rest % side);
+            rest /= side;
+        }
+        // the index only uses the lowest N * bits bits
+        const uint64_t index = detail::hilbertIndex<N>(cell, bits);
+        ASSERT_LT(index, cells);
+        ASSERT_FALSE(seen[index]);
+        seen[index] = true;
+        byIndex[index] = cell;
+    }
+    for (size_t i = 1; i < cells; i++) {
+        int distance = 0;
+        for (size_t d = 0; d < N; d++) {
+            distance += std::abs(int(byIndex[i][d]) - int(byIndex[i - 1][d]));
+        }
+        EXPECT_EQ(distance, 1) << i;
+    }
+}
+
+}
+
+TEST(SpaceFillingCurveTests, morton) {
+    std::mt19937 rng(1);
+    for (int i = 0; i < 1000; i++) {
+        const std::array<uint32_t, 2> cell2 = {uint32_t(rng()), uint32_t(rng())};
+        EXPECT_EQ(detail::interleave<2>(cell2), naiveInterleave<2>(cell2));
+        const std::array<uint32_t, 3> cell3 = {uint32_t(rng() >> 11), uint32_t(rng() >> 11), uint32_t(rng() >> 11)};
+        EXPECT_EQ(detail::interleave<3>(cell3), naiveInterleave<3>(cell3));
+        // the table and pdep agree
+        EXPECT_EQ(detail::spreadBitsTable<3>(cell3[0]), detail::spreadBits<3>(cell3[0]));
+        EXPECT_EQ(detail::spreadBitsTable<2>(cell2[0]), detail::spreadBits<2>(cell2[0]));
+    }
+
+    const Bounds<float, 2> box{Vector<float, 2>{{0, 0}}, Vector<float, 2>{{1, 1}}};
+    EXPECT_EQ(mortonCode(Vector<float, 2>{{0, 0}}, box), 0u);
+    // the upper corner and the points outside are clamped to the border cells
+    EXPECT_EQ(mortonCode(Vector<float, 2>{{1, 1}}, box), ~uint64_t{0});
+    EXPECT_EQ(mortonCode(Vector<float, 2>{{2, -1}}, box), mortonCode(Vector<float, 2>{{1, 0}}, box));
+    // x in the upper half: the bit 62 (bit 31 of x), y: the bit 63
+    EXPECT_EQ(mortonCode(Vector<float, 2>{{0.75f, 0.25f}}, box) >> 62, 1u);
+    EXPECT_EQ(mortonCode(Vector<float, 2>{{0.25f, 0.75f}}, box) >> 62, 2u);
+}
+
+TEST(SpaceFillingCurveTests, hilbert) {
+    checkHilbert<2>(1);
+    checkHilbert<2>(4);
+    checkHilbert<3>(1);
+    checkHilbert<3>(3);
+    // full precision: the codes of a flat grid are distinct
+    const Bounds<double, 3> box{Vector<double, 3>{{0, 0, 0}}, Vector<double, 3>{{1, 1, 1}}};
+    std::set<uint64_t> codes;
+    for (int x = 0; x < 10; x++) {
+        for (int y = 0; y < 10; y++) {
+            codes.insert(hilbertCode(Vector<double, 3>{{x / 10.0, y / 10.0, 0.5}}, box));
+        }
+    }
+    EXPECT_EQ(codes.size(), 100u);
+}
+
+TEST(SpaceFillingCurveTests, sortByCurve) {
+    for (size_t count : {0, 1, 1000, 50000}) {
+        for (Curve curve : {Curve::Morton, Curve::Hilbert}) {
+            const auto input = randomVectors<double, 3>(count, 2, -10.0, 10.0);
+            auto points = input;
+            const auto permutation = sortByCurve(points, curve);
+            ASSERT_EQ(permutation.size(), count);
+            const auto bounds = boundsOf(input.data(), input.size());
+            std::vector<bool> seen(count, false);
+            for (size_t i = 0; i < count; i++) {
+                ASSERT_FALSE(seen[permutation[i]]);
+                seen[permutation[i]] = true;
+                EXPECT_EQ(points[i], input[permutation[i]]);
+                if (i > 0) {
+                    const auto code = curve == Curve::Morton ? &mortonCode<double, 3> : &hilbertCode<double, 3>;
+                    ASSERT_LE(code(points[i - 1], bounds), code(points[i], bounds));
+                }
+            }
+            // payload
+            std::vector<size_t> payload(count);
+            std::iota(payload.begin(), payload.end(), size_t{0});
+            reorder(payload, permutation);
+            EXPECT_EQ(payload, permutation);
+        }
+    }
+    // equal points keep their input order
+    std::vector<Vector<float, 2>> same(100, Vector<float, 2>{{1, 2}});
+    const auto permutation = sortByCurve(same, Curve::Morton);
+    for (size_t i = 0; i < permutation.size(); i++) {
+        EXPECT_EQ(permutation[i], i);
+    }
+}
@@ -0,0 +1,130 @@
+#include "SpatialHashGrid.hpp"
+#include "TestUtils.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+using namespace VectorND;
+using test::randomVectors;
+
+namespace {
+
+template <typename T, size_t N>
+std::vector<std::pair<size_t, size_t>> bruteForcePairs(const SpatialHashGrid<T, N>& grid,
+                                                       const std::vector<Vector<T, N>>& points, T radius) {
+    std::vector<std::pair<size_t, size_t>> result;
+    for (size_t i = 0; i < points.size(); i++) {
+        for (size_t j = i + 1; j < points.size(); j++) {
+            if (grid.squaredDist(points[i].mod(T{10}), points[j].mod(T{10})) <= radius * radius) {
+                result.push_back({i, j});
+            }
+        }
+    }
+    return result;
+}
+
+}
+
+TEST(SpatialHashGridTests, neighbors) {
+    auto points = randomVectors<double, 3>(2000, 1, -5.0, 5.0);
+    auto queries = randomVectors<double, 3>(50, 2, -6.0, 6.0);
+    SpatialHashGrid<double, 3> grid(0.5);
+    grid.rebuild(points);
+    EXPECT_EQ(grid.count(), points.size());
+    for (double radius : {0.3, 0.5, 1.2}) {
+        for (const auto& query : queries) {
+            std::vector<size_t> expected;
+            for (size_t i = 0; i < points.size(); i++) {
+                if (query.squaredDist(points[i]) <= radius * radius) {
+                    expected.push_back(i);
+                }
+            }
+            std::vector<size_t> found;
+            for (const auto& n : grid.neighbors(query, radius)) {
+                found.push_back(n.index);
+                EXPECT_NEAR(n.distance, query.squaredDist(points[n.index]), 1e-12);
+            }
+            std::sort(found.begin(), found.end());
+            EXPECT_EQ(found, expected);
+        }
+    }
+}
+
+TEST(SpatialHashGridTests, pairs) {
+    auto points = randomVectors<float, 2>(1500, 3, -3.0f, 3.0f);
+    SpatialHashGrid<float, 2> grid(0.2f);
+    grid.rebuild(points);
+    for (float radius : {0.1f, 0.2f, 0.5f}) {
+        std::vector<std::pair<size_t, size_t>> expected;
+        for (size_t i = 0; i < points.size(); i++) {
+            for (size_t j = i + 1; j < points.size(); j++) {
+                if (grid.squaredDist(points[i], points[j]) <= radius * radius) {
+                    expected.push_back({i, j});
+                }
+            }
+        }
+        EXPECT_EQ(grid.pairs(radius), expected);
+
+        std::vector<std::pair<size_t, size_t>> sequential;
+        grid.forEachPair(radius, [&](size_t i, size_t j, float) {
+            sequential.push_back({std::min(i, j), std::max(i, j)});
+        });
+        std::sort(sequential.begin(), sequential.end());
+        EXPECT_EQ(sequential, expected);
+    }
+}
+
+TEST(SpatialHashGridTests, periodic) {
+    const Vector<double, 2> box({10, 10});
+    // points outside the box are wrapped
+    auto points = randomVectors<double, 2>(1000, 4, -10.0, 20.0);
+    SpatialHashGrid<double, 2> grid(0.7, box);
+    EXPECT_TRUE(grid.periodic());
+    grid.rebuild(points);
+    for (double radius : {0.5, 0.7, 2.0}) {
+        EXPECT_EQ(grid.pairs(radius), bruteForcePairs(grid, points, radius));
+    }
+    // minimum image across the border
+    const Vector<double, 2> a({0.1, 5}), b({9.9, 5});
+    EXPECT_NEAR(grid.squaredDist(a, b), 0.04, 1e-12);
+    std::vector<Vector<double, 2>> two{a, b};
+    grid.rebuild(two);
+    ASSERT_EQ(grid.pairs(0.3).size(), 1u);
+    EXPECT_EQ(grid.neighbors(Vector<double, 2>({10.05, 5}), 0.2).size(), 2u);
+}
+
+TEST(SpatialHashGridTests, coarsePeriodicGrid) {
+    // fewer cells than the reach of the radius: the neighbor cells wrap onto each other
+    const Vector<float, 3> box({2, 2, 2});
+    auto points = randomVectors<float, 3>(300, 5, 0.0f, 2.0f);
+    SpatialHashGrid<float, 3> grid(0.9f, box);
+    grid.rebuild(points);
+    std::vector<std::pair<size_t, size_t>> expected;
+    for (size_t i = 0; i < points.size(); i++) {
+        for (size_t j = i + 1; j < points.size(); j++) {
+            if (grid.squaredDist(points[i], points[j]) <= 1.0f) {
+                expected.push_back({i, j});
+            }
+        }
+    }
+    EXPECT_EQ(grid.pairs(1.0f), expected);
+}
+
+TEST(SpatialHashGridTests, rebuild) {
+    SpatialHashGrid<double, 3> grid(1.0);
+    EXPECT_TRUE(grid.pairs(1.0).empty());
+    grid.rebuild(randomVectors<double, 3>(5000, 6, 0.0, 10.0));
+    auto points = randomVectors<double, 3>(100, 7, 0.0, 10.0);
+    grid.rebuild(points);
+    EXPECT_EQ(grid.count(), 100u);
+    for (const auto& [i, j] : grid.pairs(1.0)) {
+        EXPECT_LE(points[i].squaredDist(points[j]), 1.0);
+    }
+    grid.rebuild(std::vector<Vector<double, 3>>{});
+    EXPECT_TRUE(grid.neighbors(points[0], 1.0).empty());
+}
@@ -0,0 +1,111 @@
+#include "Vector.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+using namespace VectorND;
+
+namespace {
+
+template <typename T, size_t N>
+Vector<T, N> randomVector(unsigned seed, double low, double high) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(low, high);
+    Vector<T, N> v;
+    for (auto& x : v) {
+        x = static_cast<T>(dist(rng));
+    }
+    return v;
+}
+
+template <typename T, size_t N>
+long double exactDot(const Vector<T, N>& a, const Vector<T, N>& b) {
+    long double sum = 0;
+    for (size_t i = 0; i < N; i++) {
+        sum += static_cast<long double>(a[i]) * static_cast<long double>(b[i]);
+    }
+    return sum;
+}
+
+}
+
+TEST(SummationTests, integerAccumulator) {
+    Vector<int8_t, 64> a;
+    Vector<int8_t, 64> b;
+    for (size_t i = 0; i < 64; i++) {
+        a[i] = 100;
+        b[i] = static_cast<int8_t>(i % 2 == 0 ? 100 : -50);
+    }
+    EXPECT_EQ(a.dot<int32_t>(a), 640000);
+    EXPECT_EQ(a.dot<int32_t>(b), 32 * 10000 - 32 * 5000);
+    EXPECT_EQ(a.squaredNorm<int32_t>(), 640000);
+    EXPECT_DOUBLE_EQ(a.norm<int32_t>(), 800);
+    EXPECT_EQ(dot<int64_t>(a, b), 160000);
+    // every mode is exact in an integer accumulator
+    EXPECT_EQ((a.dot<int32_t, summation::Kahan>(b)), 160000);
+    EXPECT_EQ((a.dot<int32_t, summation::Pairwise>(b)), 160000);
+    Vector<int16_t, 5> c({30000, 30000, 30000, 30000, 30000});
+    EXPECT_EQ(c.squaredNorm<int64_t>(), 5 * 900000000ll);
+    // the norms and the distances of integer vectors are accumulated in int64_t
+    EXPECT_EQ(a.squaredNorm(), 640000.0);
+    EXPECT_DOUBLE_EQ(a.norm(), 800);
+    EXPECT_EQ(squaredDist(a, b), 32 * 150 * 150);
+    EXPECT_EQ(c.squaredNorm(), 5 * 900000000.0);
+}
+
+TEST(SummationTests, wideAccumulator) {
+    const auto a = randomVector<float, 1000>(1, -1, 1);
+    const auto b = randomVector<float, 1000>(2, -1, 1);
+    double expected = 0;
+    for (size_t i = 0; i < 1000; i++) {
+        expected += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+    }
+    EXPECT_NEAR(a.dot<double>(b), expected, 1e-12);
+    EXPECT_NEAR(dot<double>(a + b, a), static_cast<double>(exactDot((a + b).eval(), a)), 1e-10);
+    EXPECT_NEAR(a.squaredNorm<double>(), static_cast<double>(exactDot(a, a)), 1e-10);
+    EXPECT_NEAR(norm<double>(a * 2.0f), 2 * std::sqrt(static_cast<double>(exactDot(a, a))), 1e-10);
+}
+
+TEST(SummationTests, modes) {
+    constexpr size_t N = 8192;
+    const auto a = randomVector<float, N>(3, 0, 1000);
+    const auto b = randomVector<float, N>(4, 0, 1);
+    const long double exact = exactDot(a, b);
+    const double naive = std::fabs(static_cast<double>(a.dot<float>(b) - exact));
+    const double pairwise = std::fabs(static_cast<double>((a.dot<float, summation::Pairwise>(b)) - exact));
+    const double kahan = std::fabs(static_cast<double>((a.dot<float, summation::Kahan>(b)) - exact));
+    // the compensated sum is within the rounding of the products and of the result
+    EXPECT_LT(kahan, 1e-6 * static_cast<double>(exact));
+    EXPECT_LE(kahan, naive);
+    EXPECT_LE(pairwise, 1e-5 * static_cast<double>(exact));
+    // the default dot is the naive sum
+    EXPECT_EQ(a.dot(b), a.dot<float>(b));
+    // the same modes for expressions and double
+    const auto c = randomVector<double, 1000>(5, -1, 1);
+    EXPECT_NEAR((dot<double, summation::Kahan>(c * 2.0, c)), 2 * static_cast<double>(exactDot(c, c)), 1e-12);
+    EXPECT_NEAR((squaredNorm<double, summation::Pairwise>(c)), static_cast<double>(exactDot(c, c)), 1e-12);
+}
+
+TEST(SummationTests, cancellation) {
+    // 1e8 + 1 - 1e8 + 1 ...: the naive float sum loses every 1
+    Vector<float, 64> a;
+    Vector<float, 64> ones;
+    for (size_t i = 0; i < 64; i++) {
+        a[i] = i % 4 == 0 ? 1e8f : i % 4 == 2 ? -1e8f : 1.0f;
+        ones[i] = 1;
+    }
+    EXPECT_EQ((a.dot<float, summation::Kahan>(ones)), 32.0f);
+    EXPECT_EQ(a.dot<double>(ones), 32.0);
+}
+
+TEST(SummationTests, constantExpression) {
+    constexpr Vector<int8_t, 3> a({100, 100, -100});
+    static_assert(a.dot<int32_t>(a) == 30000);
+    static_assert(dot<int32_t>(a, a) == 30000);
+    static_assert(a.squaredNorm<int>() == 30000);
+    constexpr Vector<float, 4> f({1e8f, 1, -1e8f, 1});
+    static_assert((f.dot<float, summation::Kahan>(Vector<float, 4>({1, 1, 1, 1}))) == 2);
+    static_assert((f.dot<double, summation::Pairwise>(Vector<float, 4>({1, 1, 1, 1}))) == 2);
+    SUCCEED();
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "Vector.hpp"
+
+namespace VectorND {
+namespace test {
+
+/**
+ * @brief count vectors with elements drawn uniformly in [low, high), the same for a given seed
+ */
+template <typename T, size_t N>
+std::vector<Vector<T, N>> randomVectors(size_t count, unsigned seed, T low = -1, T high = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<T> dist(low, high);
+    std::vector<Vector<T, N>> result(count);
+    for (auto& v : result) {
+        for (auto& x : v) {
+            x = dist(rng);
+        }
+    }
+    return result;
+}
+
+} // namespace test
+} // namespace VectorND
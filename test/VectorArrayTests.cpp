@@ -0,0 +1,141 @@
+#include "VectorArray.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+std::vector<Vector<double, 3>> makePoints(size_t count) {
+    std::vector<Vector<double, 3>> points(count);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = Vector<double, 3>({0.5 * i, 1.0 - i, 2.0 + 0.25 * i});
+    }
+    return points;
+}
+
+}
+
+TEST(VectorArrayTests, container) {
+    VectorArray<double, 3> array;
+    EXPECT_TRUE(array.empty());
+    for (int i = 0; i < 100; i++) {
+        array.push_back(Vector<double, 3>({1.0 * i, 2.0 * i, 3.0 * i}));
+    }
+    EXPECT_EQ(array.size(), 100u);
+    EXPECT_EQ(array[42], (Vector<double, 3>({42.0, 84.0, 126.0})));
+    // lanes are aligned and contiguous
+    for (size_t d = 0; d < 3; d++) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.lane(d)) % 64, 0u);
+        EXPECT_DOUBLE_EQ(array.lane(d)[10], 10.0 * (d + 1));
+    }
+    // write through the proxy
+    array[3] = Vector<double, 3>({-1.0, -2.0, -3.0});
+    array[4][1] = 7.0;
+    EXPECT_EQ(array[3], (Vector<double, 3>({-1.0, -2.0, -3.0})));
+    EXPECT_EQ(array[4], (Vector<double, 3>({4.0, 7.0, 12.0})));
+    Vector<double, 3> v = array[5];
+    EXPECT_EQ(v, (Vector<double, 3>({5.0, 10.0, 15.0})));
+    // resize keeps the values and appends null vectors
+    array.resize(120);
+    EXPECT_EQ(array[99], (Vector<double, 3>({99.0, 198.0, 297.0})));
+    EXPECT_EQ(array[119], (Vector<double, 3>()));
+}
+
+TEST(VectorArrayTests, conversion) {
+    auto points = makePoints(37);
+    VectorArray<double, 3> array(points);
+    EXPECT_EQ(array.size(), points.size());
+    auto back = array.toVectors();
+    EXPECT_EQ(back, points);
+    std::vector<Vector<double, 3>> copy(points.size());
+    array.copyTo(copy.data());
+    EXPECT_EQ(copy, points);
+}
+
+TEST(VectorArrayTests, arithmetic) {
+    auto pa = makePoints(37);
+    auto pb = makePoints(37);
+    for (auto& p : pb) {
+        p = p * 2.0 + Vector<double, 3>({1.0, 1.0, 1.0});
+    }
+    VectorArray<double, 3> a(pa), b(pb);
+    auto sum = a + b;
+    auto diff = a - b;
+    auto prod = a * b;
+    auto quot = a / b;
+    auto scaled = a * 3.0;
+    auto divided = a / 4.0;
+    for (size_t i = 0; i < pa.size(); i++) {
+        EXPECT_EQ(sum[i], (Vector<double, 3>(pa[i] + pb[i])));
+        EXPECT_EQ(diff[i], (Vector<double, 3>(pa[i] - pb[i])));
+        EXPECT_EQ(prod[i], (Vector<double, 3>(pa[i] * pb[i])));
+        EXPECT_EQ(quot[i], (Vector<double, 3>(pa[i] / pb[i])));
+        EXPECT_EQ(scaled[i], (Vector<double, 3>(pa[i] * 3.0)));
+        EXPECT_EQ(divided[i], (Vector<double, 3>(pa[i] / 4.0)));
+    }
+    a += Vector<double, 3>({1.0, 2.0, 3.0});
+    EXPECT_EQ(a[5], (Vector<double, 3>(pa[5] + Vector<double, 3>({1.0, 2.0, 3.0}))));
+}
+
+TEST(VectorArrayTests, reductions) {
+    auto pa = makePoints(37);
+    VectorArray<double, 3> a(pa);
+    VectorArray<double, 3> b = a * 0.5;
+    Vector<double, 3> query({1.0, -3.0, 2.5});
+    std::vector<double> dots(pa.size()), squaredNorms(pa.size()), norms(pa.size());
+    std::vector<double> squaredDists(pa.size()), dists(pa.size()), queryDots(pa.size());
+    a.dot(b, dots.data());
+    a.dot(query, queryDots.data());
+    a.squaredNorm(squaredNorms.data());
+    a.norm(norms.data());
+    a.squaredDist(query, squaredDists.data());
+    a.dist(query, dists.data());
+    for (size_t i = 0; i < pa.size(); i++) {
+        EXPECT_DOUBLE_EQ(dots[i], pa[i].dot(pa[i] * 0.5));
+        EXPECT_DOUBLE_EQ(queryDots[i], pa[i].dot(query));
+        EXPECT_DOUBLE_EQ(squaredNorms[i], pa[i].squaredNorm());
+        EXPECT_DOUBLE_EQ(norms[i], pa[i].norm());
+        EXPECT_DOUBLE_EQ(squaredDists[i], pa[i].squaredDist(query));
+        EXPECT_DOUBLE_EQ(dists[i], pa[i].dist(query));
+    }
+}
+
+TEST(VectorArrayTests, integerReductions) {
+    // 2 * 100000^2 overflows int: norm and dist accumulate in int64_t, like Vector
+    const std::vector<Vector<int, 2>> pa{Vector<int, 2>({100000, 100000}), Vector<int, 2>({-3, 4})};
+    VectorArray<int, 2> a(pa);
+    const Vector<int, 2> query({-100000, 0});
+    double norms[2];
+    double dists[2];
+    a.norm(norms);
+    a.dist(query, dists);
+    EXPECT_DOUBLE_EQ(norms[0], pa[0].norm());
+    EXPECT_DOUBLE_EQ(norms[0], 100000 * std::sqrt(2.0));
+    EXPECT_DOUBLE_EQ(norms[1], 5.0);
+    EXPECT_DOUBLE_EQ(dists[0], pa[0].dist(query));
+    EXPECT_DOUBLE_EQ(dists[0], 100000 * std::sqrt(5.0));
+    EXPECT_DOUBLE_EQ(dists[1], pa[1].dist(query));
+}
+
+TEST(VectorArrayTests, modulo) {
+    auto pa = makePoints(37);
+    VectorArray<double, 3> a(pa);
+    Vector<double, 3> box({3.0, 5.0, 7.0});
+    auto wrapped = a.mod(box);
+    auto wrapped2 = a.mod(2.0);
+    for (size_t i = 0; i < pa.size(); i++) {
+        auto expected = pa[i].mod(box);
+        auto expected2 = pa[i].mod(2.0);
+        for (size_t d = 0; d < 3; d++) {
+            EXPECT_NEAR(wrapped[i][d], expected[d], 1e-12);
+            EXPECT_NEAR(wrapped2[i][d], expected2[d], 1e-12);
+        }
+    }
+    // integers use the scalar path
+    VectorArray<int, 2> vi;
+    vi.push_back(Vector<int, 2>({-17, 3}));
+    EXPECT_EQ(vi.mod(5)[0], (Vector<int, 2>({3, 3})));
+}
@@ -0,0 +1,121 @@
+#include "Vector.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace VectorND;
+
+// every check is a static_assert: the file compiles only if the operations are constant expressions
+
+namespace {
+
+constexpr Vector<double, 3> a({1, 2, 3});
+constexpr Vector<double, 3> b({4, -5, 6});
+constexpr Vector<int, 2> p({3, 4});
+constexpr Vector<float, 8> wide({1, 2, 3, 4, 5, 6, 7, 8});
+
+// table built at compile time, stored in .rodata
+constexpr std::array<Vector<int, 2>, 4> stencil = {
+    Vector<int, 2>({1, 0}), Vector<int, 2>({0, 1}), Vector<int, 2>({-1, 0}), Vector<int, 2>({0, -1})};
+
+constexpr Vector<int, 2> stencilSum() {
+    Vector<int, 2> sum;
+    for (const auto& offset : stencil) {
+        sum += offset;
+    }
+    return sum;
+}
+
+constexpr Vector<double, 3> compound() {
+    Vector<double, 3> v = a;
+    v += b;
+    v -= a;
+    v *= 2.0;
+    v /= 2.0;
+    v *= a;
+    v /= a;
+    v += a * 2.0;
+    v -= a;
+    v *= a / a;
+    v /= a / a;
+    v = v - a;
+    return v;
+}
+
+}
+
+TEST(VectorConstexprTests, construction) {
+    static_assert(Vector<int, 3>() == Vector<int, 3>({0, 0, 0}));
+    static_assert(a[0] == 1 && a[2] == 3);
+    static_assert(a.at(1) == 2);
+    static_assert(Vector<double, 3>(a) == a);
+    static_assert(std::array<double, 3>(a)[1] == 2);
+    static_assert(static_cast<Vector<int, 3>>(b) == Vector<int, 3>({4, -5, 6}));
+    static_assert(*(a.cbegin() + 1) == 2 && a.cend() - a.cbegin() == 3);
+    static_assert(a != b);
+    static_assert(stencilSum() == Vector<int, 2>());
+    SUCCEED();
+}
+
+TEST(VectorConstexprTests, arithmetic) {
+    static_assert(a + b == Vector<double, 3>({5, -3, 9}));
+    static_assert(a - b == Vector<double, 3>({-3, 7, -3}));
+    static_assert(a * b == Vector<double, 3>({4, -10, 18}));
+    static_assert(b / a == Vector<double, 3>({4, -2.5, 2}));
+    static_assert(a * 2.0 == Vector<double, 3>({2, 4, 6}));
+    static_assert(2.0 * a == Vector<double, 3>({2, 4, 6}));
+    static_assert(a / 2.0 == Vector<double, 3>({0.5, 1, 1.5}));
+    static_assert(6.0 / a == Vector<double, 3>({6, 3, 2}));
+    static_assert(-a == Vector<double, 3>({-1, -2, -3}));
+    static_assert((a + b * 2.0 - a).eval() == b * 2.0);
+    static_assert(wide + wide == wide * 2.0f);
+    static_assert(compound() == b);
+    static_assert(a.reverse() == Vector<double, 3>({3, 2, 1}));
+    static_assert((a + b).reverse() == Vector<double, 3>({9, -3, 5}));
+    static_assert(fma(a, b, a) == Vector<double, 3>({5, -8, 21}));
+    static_assert(axpy(2.0, a, b) == Vector<double, 3>({6, -1, 12}));
+    static_assert(lerp(a, b, 0.5) == Vector<double, 3>({2.5, -1.5, 4.5}));
+    static_assert(Vector<double, 3>(a).axpy(-1.0, a) == Vector<double, 3>());
+    static_assert(Vector<double, 3>(a).lerp(b, 1.0) == b);
+    static_assert(Vector<double, 2>({0, 2}).normalized() == Vector<double, 2>({0, 1}));
+    SUCCEED();
+}
+
+TEST(VectorConstexprTests, reductions) {
+    static_assert(a.dot(b) == 12);
+    static_assert(dot(a, b) == 12);
+    static_assert((a + b).dot(a) == 26);
+    static_assert(wide.dot(wide) == 204);
+    static_assert(a.squaredNorm() == 14 && Vector<double, 3>::squaredNorm(a) == 14);
+    static_assert(p.norm() == 5 && Vector<int, 2>::norm(p) == 5);
+    static_assert(a.squaredDist(b) == 9 + 49 + 9);
+    static_assert(Vector<double, 3>::squaredDist(a, b) == 67);
+    static_assert(Vector<int, 2>({0, 0}).dist(p) == 5);
+    static_assert(Vector<int, 2>::dist(p, Vector<int, 2>()) == 5);
+    static_assert(norm(a - a) == 0);
+    static_assert(dist(a * 2.0, a) == a.norm());
+    static_assert(p.distanceTo(Vector<int, 2>()) == 5);
+    // the compile time sqrt is within 1 ulp of std::sqrt
+    constexpr double root = a.norm();
+    EXPECT_NEAR(root, std::sqrt(14.0), 1e-15);
+    EXPECT_DOUBLE_EQ(root, std::sqrt(14.0));
+    constexpr double large = Vector<double, 2>({3e150, 4e150}).norm();
+    EXPECT_DOUBLE_EQ(large, 5e150);
+    constexpr double small = Vector<double, 2>({3e-150, 4e-150}).norm();
+    EXPECT_DOUBLE_EQ(small, 5e-150);
+}
+
+TEST(VectorConstexprTests, modulo) {
+    static_assert(Vector<int, 3>({-1, 5, 7}).mod(3) == Vector<int, 3>({2, 2, 1}));
+    static_assert(Vector<int, 2>({-7, 7}).mod(Vector<int, 2>({4, 5})) == Vector<int, 2>({1, 2}));
+    static_assert(Vector<double, 3>({-1.5, 5.5, 7}).mod(2.0) == Vector<double, 3>({0.5, 1.5, 1}));
+    static_assert((a - b).mod(4.0) == Vector<double, 3>({1, 3, 1}));
+    static_assert(Vector<double, 2>({5, -1}).mod(-3.0) == Vector<double, 2>({-1, -1}));
+    // same result as the runtime modulo
+    constexpr auto m = Vector<float, 4>({-0.25f, 10.75f, -3.5f, 1}).mod(Vector<float, 4>({1, 2, 1.5f, 4}));
+    Vector<float, 4> runtime({-0.25f, 10.75f, -3.5f, 1});
+    EXPECT_EQ(m, runtime.mod(Vector<float, 4>({1, 2, 1.5f, 4})));
+    // negative divisors, the result has the sign of the divisor
+    constexpr auto n = Vector<double, 4>({5, -1, 7.5, -6}).mod(-3.0);
+    Vector<double, 4> runtimeNegative({5, -1, 7.5, -6});
+    EXPECT_EQ(n, runtimeNegative.mod(-3.0));
+}
@@ -0,0 +1,161 @@
+#include "Vector.hpp"
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+
+using namespace VectorND;
+
+TEST(VectorExprTests, evaluation) {
+    Vector<double, 3> a({1.0, 2.0, 3.0});
+    Vector<double, 3> b({4.0, 5.0, 6.0});
+    Vector<double, 3> c({1.0, 1.0, 1.0});
+    // a + b * s - c evaluated in one loop
+    Vector<double, 3> r1 = a + b * 2.0 - c;
+    EXPECT_EQ(r1, (Vector<double, 3>({8.0, 11.0, 14.0})));
+    // same with a scalar on the left and a division
+    Vector<double, 3> r2 = 2.0 * (a + b) / c - a / 2.0;
+    EXPECT_EQ(r2, (Vector<double, 3>({9.5, 13.0, 16.5})));
+    // explicit eval
+    auto r3 = (-a + b).eval();
+    EXPECT_EQ(r3, (Vector<double, 3>({3.0, 3.0, 3.0})));
+    // element access without evaluating the whole expression
+    EXPECT_DOUBLE_EQ((a * b)[2], 18.0);
+    // integers
+    Vector<int, 3> vi1({1, 2, 3});
+    Vector<int, 3> vi2 = 12 / vi1 - vi1 * 3 + vi1;
+    EXPECT_EQ(vi2, (Vector<int, 3>({10, 2, -2})));
+}
+
+TEST(VectorExprTests, temporaries) {
+    // rvalue operands are stored inside the expression, so auto is safe here
+    auto e = Vector<int, 3>({1, 2, 3}) + Vector<int, 3>({4, 5, 6});
+    EXPECT_EQ(e, (Vector<int, 3>({5, 7, 9})));
+    auto e2 = 12 / Vector<int, 3>({1, 2, 3});
+    EXPECT_EQ(e2, (Vector<int, 3>({12, 6, 4})));
+}
+
+TEST(VectorExprTests, arrayOperands) {
+    // a std::array operand is converted to a Vector, as in the operators before expressions
+    Vector<double, 3> v({1.0, 2.0, 3.0});
+    std::array<double, 3> arr{4.0, 6.0, 9.0};
+    EXPECT_EQ(v + arr, (Vector<double, 3>({5.0, 8.0, 12.0})));
+    EXPECT_EQ(arr - v, (Vector<double, 3>({3.0, 4.0, 6.0})));
+    EXPECT_EQ(v * arr, (Vector<double, 3>({4.0, 12.0, 27.0})));
+    EXPECT_EQ(arr / v, (Vector<double, 3>({4.0, 3.0, 3.0})));
+    // inside an expression
+    Vector<double, 3> r = 2.0 * v - arr + v;
+    EXPECT_EQ(r, (Vector<double, 3>({-1.0, 0.0, 0.0})));
+}
+
+TEST(VectorExprTests, mixedElementTypes) {
+    // the right operand is converted to the element type of the left one
+    Vector<double, 3> a({1.5, 2.5, 9.0});
+    Vector<int, 3> b({1, 2, 3});
+    EXPECT_EQ(a + b, (Vector<double, 3>({2.5, 4.5, 12.0})));
+    EXPECT_EQ(a - b, (Vector<double, 3>({0.5, 0.5, 6.0})));
+    EXPECT_EQ(a * b, (Vector<double, 3>({1.5, 5.0, 27.0})));
+    EXPECT_EQ(a / b, (Vector<double, 3>({1.5, 1.25, 3.0})));
+    EXPECT_EQ(b + a, (Vector<int, 3>({2, 4, 12})));
+    // inside an expression
+    Vector<double, 3> r = 2.0 * a - b;
+    EXPECT_EQ(r, (Vector<double, 3>({2.0, 3.0, 15.0})));
+}
+
+TEST(VectorExprTests, assignment) {
+    Vector<double, 3> a({1.0, 2.0, 3.0});
+    Vector<double, 3> b({4.0, 5.0, 6.0});
+    // aliasing: the expression reads the vector it is assigned to
+    a = a * 2.0 + b;
+    EXPECT_EQ(a, (Vector<double, 3>({6.0, 9.0, 12.0})));
+    // compound assignments with expressions
+    a += b - 1.0 * b;
+    EXPECT_EQ(a, (Vector<double, 3>({6.0, 9.0, 12.0})));
+    a -= b * 2.0;
+    EXPECT_EQ(a, (Vector<double, 3>({-2.0, -1.0, 0.0})));
+    a *= b + b;
+    EXPECT_EQ(a, (Vector<double, 3>({-16.0, -10.0, 0.0})));
+    a /= -b;
+    EXPECT_EQ(a, (Vector<double, 3>({4.0, 2.0, 0.0})));
+}
+
+TEST(VectorExprTests, reductions) {
+    Vector<double, 3> a({1.0, 2.0, 3.0});
+    Vector<double, 3> b({4.0, 6.0, 3.0});
+    EXPECT_DOUBLE_EQ(dot(a, b), 25.0);
+    EXPECT_DOUBLE_EQ(dot(a + b, a), 39.0);
+    EXPECT_DOUBLE_EQ(squaredNorm(b - a), 25.0);
+    EXPECT_DOUBLE_EQ(norm(b - a), 5.0);
+    EXPECT_DOUBLE_EQ(squaredDist(a, b), 25.0);
+    EXPECT_DOUBLE_EQ(dist(a * 2.0, b * 2.0), 10.0);
+    // member versions on expressions
+    EXPECT_DOUBLE_EQ((b - a).norm(), 5.0);
+    EXPECT_DOUBLE_EQ((a + a).dot(b), 50.0);
+    EXPECT_DOUBLE_EQ((a * 1.0).squaredDist(b), 25.0);
+    EXPECT_EQ((a - b).reverse(), (Vector<double, 3>({0.0, -4.0, -3.0})));
+    EXPECT_EQ((a + b).mod(4.0), (Vector<double, 3>({1.0, 0.0, 2.0})));
+}
+
+TEST(VectorExprTests, fused) {
+    Vector<double, 3> a({1.0, 2.0, 3.0});
+    Vector<double, 3> b({4.0, 6.0, 8.0});
+    Vector<double, 3> c({0.5, 0.5, 0.5});
+    // free functions are lazy
+    Vector<double, 3> r1 = fma(a, b, c);
+    EXPECT_EQ(r1, (Vector<double, 3>({4.5, 12.5, 24.5})));
+    EXPECT_EQ(fma(a, 2.0, c), (Vector<double, 3>({2.5, 4.5, 6.5})));
+    EXPECT_EQ(axpy(2.0, a, b), (Vector<double, 3>({6.0, 10.0, 14.0})));
+    EXPECT_EQ(lerp(a, b, 0.5), (Vector<double, 3>({2.5, 4.0, 5.5})));
+    EXPECT_EQ(lerp(a + c, b, 0.0), a + c);
+    // an rvalue start point is stored safely
+    auto e = lerp(Vector<double, 3>({0.0, 0.0, 0.0}), b, 0.25);
+    EXPECT_EQ(e, (Vector<double, 3>({1.0, 1.5, 2.0})));
+    // in place
+    Vector<double, 3> v = a;
+    v.axpy(2.0, b);
+    EXPECT_EQ(v, (Vector<double, 3>({9.0, 14.0, 19.0})));
+    v = a;
+    v.fma(b, c);
+    EXPECT_EQ(v, r1);
+    v = a;
+    v.fma(3.0, a - c);
+    EXPECT_EQ(v, (Vector<double, 3>({3.5, 7.5, 11.5})));
+    v = a;
+    v.lerp(b, 1.0);
+    EXPECT_EQ(v, b);
+    v = a;
+    v.lerp(b * 2.0, 0.5);
+    EXPECT_EQ(v, (Vector<double, 3>({4.5, 7.0, 9.5})));
+    // the elements of the expression are rounded as the evaluated vector
+    const double x = 1.0 + std::ldexp(1.0, -27);
+    Vector<double, 4> xs({x, x, x, x});
+    Vector<double, 4> ys({-x * x, -x * x, 1.0, 1.0});
+    const auto f = fma(xs, xs, ys);
+    Vector<double, 4> evaluated = f;
+    for (size_t i = 0; i < 4; i++) {
+        EXPECT_EQ(f[i], evaluated[i]);
+    }
+    // integers
+    Vector<int, 2> vi({1, 2});
+    vi.axpy(3, Vector<int, 2>({1, -1}));
+    EXPECT_EQ(vi, (Vector<int, 2>({4, -1})));
+}
+
+TEST(VectorExprTests, normalize) {
+    Vector<double, 3> a({3.0, 0.0, 4.0});
+    auto n = a.normalized();
+    EXPECT_DOUBLE_EQ(n[0], 0.6);
+    EXPECT_DOUBLE_EQ(n[2], 0.8);
+    EXPECT_NEAR(n.norm(), 1.0, 1e-15);
+    a.normalize();
+    EXPECT_EQ(a, n);
+    // a null vector stays null
+    Vector<float, 5> zero;
+    EXPECT_EQ(zero.normalized(), zero);
+    Vector<float, 9> f({1, 2, 3, 4, 5, 6, 7, 8, 9});
+    EXPECT_NEAR((f * 2.0f).normalized().norm(), 1.0, 1e-6);
+    // distances without temporary
+    Vector<double, 3> b({1.0, 2.0, 2.0});
+    EXPECT_DOUBLE_EQ(b.distanceTo(Vector<double, 3>()), 3.0);
+    EXPECT_DOUBLE_EQ((b * 2.0).distanceTo(b), 3.0);
+    EXPECT_DOUBLE_EQ(b.distanceTo(b * 3.0), 6.0);
+}
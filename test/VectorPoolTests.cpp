@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+
+#include "AlignedVector.hpp"
+#include "VectorPool.hpp"
+
+using namespace VectorND;
+
+TEST(VectorPoolTests, allocate) {
+    VectorPool<float, 3> pool(16);
+    EXPECT_EQ(pool.capacity(), 0u);
+
+    Vector<float, 3>* a = pool.allocate(5);
+    Vector<float, 3>* b = pool.allocate(3, Vector<float, 3>({1, 2, 3}));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % 64, 0u);
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_TRUE((a[i] == Vector<float, 3>()));
+    }
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_TRUE((b[i] == Vector<float, 3>({1, 2, 3})));
+    }
+    // distinct buffers
+    EXPECT_TRUE(b >= a + 5 || b + 3 <= a);
+    EXPECT_EQ(pool.used(), 128u);
+
+    // larger than a block
+    Vector<float, 3>* c = pool.allocate(100);
+    c[99][2] = 1;
+    EXPECT_GE(pool.capacity(), 100 * sizeof(Vector<float, 3>));
+}
+
+TEST(VectorPoolTests, resetReusesTheMemory) {
+    VectorPool<double, 4> pool(64);
+    std::vector<Vector<double, 4>*> first;
+    for (size_t i = 0; i < 10; i++) {
+        first.push_back(pool.allocate(20));
+    }
+    const size_t capacity = pool.capacity();
+
+    pool.reset();
+    EXPECT_EQ(pool.used(), 0u);
+    for (size_t i = 0; i < 10; i++) {
+        EXPECT_EQ(pool.allocate(20), first[i]);
+    }
+    EXPECT_EQ(pool.capacity(), capacity);
+
+    pool.release();
+    EXPECT_EQ(pool.capacity(), 0u);
+    EXPECT_EQ(pool.used(), 0u);
+}
+
+TEST(VectorPoolTests, alignedVectors) {
+    using V = AlignedVector<float, 3, 16>;
+    VectorPool<float, 3, 64, V> pool;
+    V* vectors = pool.allocate(9, V(Vector<float, 3>({1, 1, 1})));
+    for (size_t i = 0; i < 9; i++) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vectors + i) % 16, 0u);
+        EXPECT_EQ(vectors[i].dot(vectors[i]), 3.0f);
+    }
+}
+
+TEST(VectorPoolTests, allocator) {
+    VectorPool<float, 8> pool;
+    std::vector<Vector<float, 8>, VectorPool<float, 8>::Allocator<Vector<float, 8>>> vectors(pool.allocator());
+    for (size_t i = 0; i < 1000; i++) {
+        Vector<float, 8> v;
+        v[7] = static_cast<float>(i);
+        vectors.push_back(v);
+    }
+    for (size_t i = 0; i < 1000; i++) {
+        EXPECT_EQ(vectors[i][7], static_cast<float>(i));
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vectors.data()) % 64, 0u);
+    }
+    EXPECT_GT(pool.used(), 1000 * sizeof(Vector<float, 8>));
+
+    // the allocator can be rebound (node containers)
+    VectorPool<float, 8>::Allocator<int> ints(vectors.get_allocator());
+    EXPECT_TRUE(ints == vectors.get_allocator());
+}
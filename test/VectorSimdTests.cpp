@@ -0,0 +1,143 @@
+#include "Vector.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+using namespace VectorND;
+
+// the SIMD kernels must match a plain scalar loop (within a tolerance for the reductions)
+
+template <typename V>
+struct SimdTypeParam;
+
+template <typename T, size_t N>
+struct SimdTypeParam<Vector<T, N>> {
+    using value_type = T;
+    static constexpr size_t size = N;
+};
+
+template <typename V>
+class VectorSimdTests : public ::testing::Test {
+protected:
+    using T = typename SimdTypeParam<V>::value_type;
+    static constexpr size_t N = SimdTypeParam<V>::size;
+
+    V random(T low, T high) {
+        std::uniform_real_distribution<T> dist(low, high);
+        V v;
+        for (size_t i = 0; i < N; i++) {
+            v[i] = dist(rng);
+        }
+        return v;
+    }
+
+    std::mt19937 rng{42};
+};
+
+using SimdTypes = ::testing::Types<
+    Vector<float, 2>, Vector<float, 3>, Vector<float, 4>, Vector<float, 8>, Vector<float, 16>,
+    Vector<double, 2>, Vector<double, 3>, Vector<double, 4>, Vector<double, 8>, Vector<double, 16>,
+    Vector<float, 5>, Vector<double, 7>>;
+TYPED_TEST_SUITE(VectorSimdTests, SimdTypes);
+
+TYPED_TEST(VectorSimdTests, arithmetic) {
+    using T = typename TestFixture::T;
+    constexpr size_t N = TestFixture::N;
+    // the compiler may contract the scalar reference into fma
+    const double tolerance = std::is_same_v<T, float> ? 1e-5 : 1e-13;
+    auto a = this->random(1, 10);
+    auto b = this->random(1, 10);
+    TypeParam r = a * T(2) + b / a - (-b) * b;
+    for (size_t i = 0; i < N; i++) {
+        const T expected = T(2) * a[i] + b[i] / a[i] - (-b[i]) * b[i];
+        EXPECT_NEAR(r[i], expected, tolerance * std::abs(expected));
+    }
+    // compound assignments
+    TypeParam c = a;
+    c += b;
+    c *= T(3);
+    c -= a;
+    c /= b;
+    for (size_t i = 0; i < N; i++) {
+        const T expected = (T(3) * (a[i] + b[i]) - a[i]) / b[i];
+        EXPECT_NEAR(c[i], expected, tolerance * std::abs(expected));
+    }
+}
+
+TYPED_TEST(VectorSimdTests, reductions) {
+    using T = typename TestFixture::T;
+    constexpr size_t N = TestFixture::N;
+    const double tolerance = std::is_same_v<T, float> ? 1e-4 : 1e-12;
+    auto a = this->random(-10, 10);
+    auto b = this->random(-10, 10);
+    double expectedDot{0}, expectedNorm{0}, expectedDist{0};
+    for (size_t i = 0; i < N; i++) {
+        expectedDot += a[i] * b[i];
+        expectedNorm += a[i] * a[i];
+        expectedDist += (a[i] - b[i]) * (a[i] - b[i]);
+    }
+    EXPECT_NEAR(a.dot(b), expectedDot, tolerance * (1 + std::abs(expectedDot)));
+    EXPECT_NEAR(a.squaredNorm(), expectedNorm, tolerance * expectedNorm);
+    EXPECT_NEAR(a.squaredDist(b), expectedDist, tolerance * expectedDist);
+    EXPECT_NEAR(a.dist(b), std::sqrt(expectedDist), tolerance * std::sqrt(expectedDist));
+    // the padding lanes of s / v must not leak into the sum
+    double inverseSum{0};
+    for (size_t i = 0; i < N; i++) {
+        inverseSum += T(1) / b[i];
+    }
+    EXPECT_NEAR(dot(T(1) / b, b / b), inverseSum, tolerance * (1 + std::abs(inverseSum)));
+}
+
+TYPED_TEST(VectorSimdTests, modulo) {
+    using T = typename TestFixture::T;
+    constexpr size_t N = TestFixture::N;
+    const double tolerance = std::is_same_v<T, float> ? 1e-4 : 1e-12;
+    auto a = this->random(-100, 100);
+    auto b = this->random(1, 10);
+    auto r1 = a.mod(b);
+    auto r2 = a.mod(T(3.5));
+    for (size_t i = 0; i < N; i++) {
+        EXPECT_NEAR(r1[i], std::fmod(std::fmod(a[i], b[i]) + b[i], b[i]), tolerance * b[i]);
+        EXPECT_NEAR(r2[i], std::fmod(std::fmod(a[i], T(3.5)) + T(3.5), T(3.5)), tolerance * 3.5);
+        EXPECT_GE(r1[i], T(0));
+        EXPECT_LT(r1[i], b[i]);
+    }
+}
+
+TYPED_TEST(VectorSimdTests, moduloLargeQuotients) {
+    using T = typename TestFixture::T;
+    constexpr size_t N = TestFixture::N;
+    // quotients up to and beyond the mantissa, where a - b * floor(a / b) loses the result
+    const T values[] = {T(16777215), T(1e7), T(-1e7), T(123456.7), T(3e9), T(-4.5e15), T(-0.3), T(1e-30)};
+    const T moduli[] = {T(0.7), T(0.7), T(0.7), T(0.7), T(0.1), T(-2.5), T(1), T(3)};
+    TypeParam a;
+    TypeParam b;
+    for (size_t i = 0; i < N; i++) {
+        a[i] = values[i % 8];
+        b[i] = moduli[(i + i / 8) % 8];
+    }
+    // fmod is exact, adding b rounds only for the remainders of the other sign
+    const auto expected = [](T x, T m) {
+        const T r = std::fmod(x, m);
+        return r != 0 && (r < 0) != (m < 0) ? r + m : r;
+    };
+    const auto r1 = a.mod(b);
+    const auto r2 = a.mod(T(0.7));
+    for (size_t i = 0; i < N; i++) {
+        EXPECT_EQ(r1[i], expected(a[i], b[i])) << a[i] << " mod " << b[i];
+        EXPECT_EQ(r2[i], expected(a[i], T(0.7))) << a[i] << " mod 0.7";
+    }
+}
+
+TYPED_TEST(VectorSimdTests, equality) {
+    constexpr size_t N = TestFixture::N;
+    auto a = this->random(-10, 10);
+    TypeParam b = a;
+    EXPECT_EQ(a, b);
+    for (size_t i = 0; i < N; i++) {
+        TypeParam c = a;
+        c[i] += 1;
+        EXPECT_NE(a, c);
+        EXPECT_NE(a * 1, c);
+    }
+}
@@ -0,0 +1,100 @@
+#include "VectorText.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace VectorND;
+
+TEST(VectorTextTests, format) {
+    const Vector<double, 3> v({1.0, -2.5, 0.1});
+    EXPECT_EQ(toString(v), "[1, -2.5, 0.1]");
+    EXPECT_EQ(toString(v, TextFormat::csv()), "1,-2.5,0.1");
+    EXPECT_EQ(toString(v, {"(", "; ", ")", 3}), "(1; -2.5; 0.1)");
+    EXPECT_EQ(toString(Vector<double, 2>({1.0 / 3, 2e-300}), {"", " ", "", 4}), "0.3333 2e-300");
+    EXPECT_EQ(toString(Vector<int, 4>({1, -20, 300, 0})), "[1, -20, 300, 0]");
+
+    // a buffer too small
+    char buffer[8];
+    const auto result = formatTo(buffer, buffer + sizeof(buffer), v);
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+
+    // the bound holds for the longest values
+    const Vector<double, 3> longest({-std::numeric_limits<double>::denorm_min(), -1.2345678901234567e-300,
+                                     -std::numeric_limits<double>::max()});
+    EXPECT_LE(toString(longest).size(), (maxFormattedSize<double, 3>()));
+    EXPECT_LE(toString(longest, {"[", ", ", "]", 30}).size(), (maxFormattedSize<double, 3>({"[", ", ", "]", 30})));
+}
+
+TEST(VectorTextTests, roundTrip) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-1e6f, 1e6f);
+    for (int i = 0; i < 1000; i++) {
+        const Vector<float, 4> v({dist(rng), dist(rng) * 1e-30f, dist(rng) * 1e30f, dist(rng)});
+        EXPECT_EQ((parse<float, 4>(toString(v))), v);
+        EXPECT_EQ((parse<float, 4>(toString(v, TextFormat::csv()), TextFormat::csv())), v);
+    }
+}
+
+TEST(VectorTextTests, parse) {
+    using V = Vector<double, 3>;
+    EXPECT_EQ((parse<double, 3>("[1, 2, 3]")), V({1, 2, 3}));
+    EXPECT_EQ((parse<double, 3>("  [ 1 ,2,  +3e2 ]  ")), V({1, 2, 300}));
+    EXPECT_EQ((parse<double, 3>("1 2\t3", TextFormat::whitespace())), V({1, 2, 3}));
+    EXPECT_EQ((parse<double, 3>("-1.5,0,1e-3", TextFormat::csv())), V({-1.5, 0, 1e-3}));
+    EXPECT_EQ((parse<int, 2>("[-4, 7]")), (Vector<int, 2>({-4, 7})));
+
+    EXPECT_THROW((parse<double, 3>("[1, 2]")), std::invalid_argument);
+    EXPECT_THROW((parse<double, 3>("[1, 2, 3, 4]")), std::invalid_argument);
+    EXPECT_THROW((parse<double, 3>("[1, x, 3]")), std::invalid_argument);
+    EXPECT_THROW((parse<double, 3>("123", TextFormat::whitespace())), std::invalid_argument);
+    EXPECT_THROW((parse<double, 2>("1,2", TextFormat::whitespace())), std::invalid_argument);
+
+    // the low level parser stops after the vector
+    const std::string text = "[1, 2, 3] tail";
+    V v;
+    const auto result = parse(text.data(), text.data() + text.size(), v);
+    EXPECT_EQ(result.ec, std::errc{});
+    EXPECT_EQ(std::string(result.ptr), " tail");
+}
+
+TEST(VectorTextTests, bulk) {
+    std::vector<Vector<float, 3>> vectors(100000);
+    for (size_t i = 0; i < vectors.size(); i++) {
+        vectors[i] = Vector<float, 3>({0.5f * i, -1.0f * i, 1.0f / (i + 1)});
+    }
+    const std::string text = formatVectors(vectors.data(), vectors.size());
+    EXPECT_EQ(text.substr(0, 6), "0,-0,1");
+    EXPECT_EQ((parseVectors<float, 3>(text)), vectors);
+
+    // header, comments, blank lines and CRLF
+    const std::string csv = "x,y\r\n1,2\r\n\r\n# comment\r\n3,4\r\n  5 , 6";
+    const auto parsed = parseVectors<int, 2>(csv, TextFormat::csv(), 1);
+    ASSERT_EQ(parsed.size(), 3u);
+    EXPECT_EQ(parsed[2], (Vector<int, 2>({5, 6})));
+
+    // the error names the line
+    try {
+        parseVectors<int, 2>("1,2\n3,4\n5\n", TextFormat::csv());
+        FAIL();
+    } catch (const std::invalid_argument& error) {
+        EXPECT_NE(std::string(error.what()).find("line 3"), std::string::npos);
+    }
+    // the header lines are counted once
+    try {
+        parseVectors<float, 2>("x,y\n1,2\nbad\n", TextFormat::csv(), 1);
+        FAIL();
+    } catch (const std::invalid_argument& error) {
+        EXPECT_NE(std::string(error.what()).find("line 3"), std::string::npos);
+    }
+
+    const std::string path = testing::TempDir() + "vectornd_text.csv";
+    writeVectors(path, vectors, TextFormat::whitespace());
+    EXPECT_EQ((readVectors<float, 3>(path, TextFormat::whitespace())), vectors);
+    std::remove(path.c_str());
+    EXPECT_THROW((readVectors<float, 3>(path)), std::runtime_error);
+}
@@ -0,0 +1,120 @@
+#include "VectorView.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace VectorND;
+
+namespace {
+
+// 4 rows of 5 floats, row r = {5r, 5r + 1, ...}
+std::vector<float> makeBuffer() {
+    std::vector<float> buffer(20);
+    std::iota(buffer.begin(), buffer.end(), 0.0f);
+    return buffer;
+}
+
+}
+
+TEST(VectorViewTests, readInPlace) {
+    const auto buffer = makeBuffer();
+    const VectorView<float, 5> row(buffer.data() + 5);
+    const Vector<float, 5> copy({5, 6, 7, 8, 9});
+    EXPECT_EQ(row.data(), buffer.data() + 5);
+    EXPECT_EQ(row, copy);
+    EXPECT_FLOAT_EQ(row[2], 7.0f);
+    EXPECT_THROW(row.at(5), std::out_of_range);
+
+    // the full read API, the same results as on the copy
+    const VectorView<float, 5> other(buffer.data() + 10);
+    EXPECT_FLOAT_EQ(row.dot(other), copy.dot(other.eval()));
+    EXPECT_FLOAT_EQ(copy.dot(other), row.dot(other));
+    EXPECT_DOUBLE_EQ(row.norm(), copy.norm());
+    EXPECT_DOUBLE_EQ(row.squaredDist(other), 125.0);
+    EXPECT_DOUBLE_EQ(copy.dist(other), std::sqrt(125.0));
+    EXPECT_EQ(row.mod(3.0f), copy.mod(3.0f));
+    EXPECT_EQ(copy.mod(other), copy.mod(other.eval()));
+    EXPECT_EQ(row.reverse(), (Vector<float, 5>({9, 8, 7, 6, 5})));
+    std::ostringstream os;
+    os << row;
+    EXPECT_EQ(os.str(), "[5, 6, 7, 8, 9]");
+
+    // operands of the expressions next to owning vectors
+    const Vector<float, 5> sum = row + other * 2.0f - copy;
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(sum[i], 2.0f * buffer[10 + i]);
+    }
+
+    // a view of a Vector
+    const VectorView<float, 5> view(copy);
+    EXPECT_EQ(view.data(), copy.cbegin());
+}
+
+TEST(VectorViewTests, writeThrough) {
+    auto buffer = makeBuffer();
+    VectorRef<float, 5> row(buffer.data());
+    const Vector<float, 5> ones({1, 1, 1, 1, 1});
+    row += ones;
+    EXPECT_FLOAT_EQ(buffer[4], 5.0f);
+    row = row * 2.0f + VectorView<float, 5>(buffer.data() + 5);
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(buffer[i], 2.0f * (i + 1) + 5 + i);
+    }
+    // ref = ref copies the elements, a copy of a ref aliases the same memory
+    VectorRef<float, 5> last(buffer.data() + 15);
+    last = row;
+    EXPECT_FLOAT_EQ(buffer[15], buffer[0]);
+    VectorRef<float, 5> alias = last;
+    alias[0] = -1.0f;
+    EXPECT_FLOAT_EQ(buffer[15], -1.0f);
+    // an owning vector is updated from a ref
+    Vector<float, 5> v;
+    v = last;
+    v += row;
+    EXPECT_FLOAT_EQ(v[0], -1.0f + buffer[0]);
+    // write into a Vector through a ref
+    VectorRef<float, 5> ref(v);
+    ref.axpy(2.0f, ones);
+    ref.normalize();
+    EXPECT_NEAR(v.norm(), 1.0, 1e-6);
+}
+
+TEST(VectorViewTests, strided) {
+    auto buffer = makeBuffer();
+    // column 1 of the 4 x 5 buffer
+    const StridedVectorView<float, 4> column(buffer.data() + 1, 5);
+    EXPECT_EQ(column, (Vector<float, 4>({1, 6, 11, 16})));
+    EXPECT_FLOAT_EQ(column.dot(column), 1 + 36 + 121 + 256);
+    EXPECT_THROW(column.at(4), std::out_of_range);
+    // negative stride: the column read bottom up
+    const StridedVectorView<float, 4> reversed(buffer.data() + 16, -5);
+    EXPECT_EQ(reversed, column.reverse());
+
+    StridedVectorRef<float, 4> target(buffer.data() + 3, 5);
+    target = column * 10.0f;
+    EXPECT_FLOAT_EQ(buffer[8], 60.0f);
+    EXPECT_FLOAT_EQ(buffer[18], 160.0f);
+    EXPECT_FLOAT_EQ(buffer[4], 4.0f);
+    target -= column;
+    EXPECT_EQ(target, (Vector<float, 4>({9, 54, 99, 144})));
+    std::ostringstream os;
+    os << target;
+    EXPECT_EQ(os.str(), "[9, 54, 99, 144]");
+
+    // longer than a packet, integers (no packets)
+    std::vector<double> wide(3 * 37);
+    std::iota(wide.begin(), wide.end(), 0.0);
+    StridedVectorRef<double, 37> odd(wide.data() + 1, 3);
+    odd += StridedVectorView<double, 37>(wide.data(), 3);
+    for (size_t i = 0; i < 37; i++) {
+        EXPECT_DOUBLE_EQ(wide[3 * i + 1], 6.0 * i + 1);
+    }
+    std::vector<int> ints{1, -7, 2, 9, 3, -2};
+    StridedVectorRef<int, 3> evens(ints.data(), 2);
+    evens *= 3;
+    EXPECT_EQ(evens.mod(4), (Vector<int, 3>({3, 2, 1})));
+    EXPECT_DOUBLE_EQ(evens.squaredDist(StridedVectorView<int, 3>(ints.data() + 1, 2)), 100 + 9 + 121);
+}